@@ -121,6 +121,58 @@ ResourceUID::ID ResourceLoader::get_resource_uid(const String &p_path) {
 	return ::ResourceLoader::get_resource_uid(p_path);
 }
 
+void ResourceLoader::set_load_tracing_enabled(bool p_enabled) {
+	::ResourceLoader::set_load_tracing_enabled(p_enabled);
+}
+
+bool ResourceLoader::is_load_tracing_enabled() const {
+	return ::ResourceLoader::is_load_tracing_enabled();
+}
+
+TypedArray<Dictionary> ResourceLoader::get_load_trace() const {
+	List<::ResourceLoader::LoadTrace> trace;
+	::ResourceLoader::get_load_trace(&trace);
+
+	TypedArray<Dictionary> ret;
+	for (const ::ResourceLoader::LoadTrace &E : trace) {
+		Dictionary d;
+		d["path"] = E.path;
+		d["type"] = E.type;
+		d["source_path"] = E.source_path;
+		d["thread_id"] = E.thread_id;
+		d["request_usec"] = E.request_usec;
+		d["start_usec"] = E.start_usec;
+		d["end_usec"] = E.end_usec;
+		d["error"] = E.error;
+		ret.push_back(d);
+	}
+
+	return ret;
+}
+
+void ResourceLoader::clear_load_trace() {
+	::ResourceLoader::clear_load_trace();
+}
+
+void ResourceLoader::set_sub_resource_deduplication_enabled(bool p_enabled) {
+	::ResourceLoader::set_sub_resource_deduplication_enabled(p_enabled);
+}
+
+bool ResourceLoader::is_sub_resource_deduplication_enabled() const {
+	return ::ResourceLoader::is_sub_resource_deduplication_enabled();
+}
+
+Dictionary ResourceLoader::get_sub_resource_deduplication_stats() const {
+	uint64_t checked = 0;
+	uint64_t deduplicated = 0;
+	ResourceCache::get_deduplication_stats(&checked, &deduplicated);
+
+	Dictionary d;
+	d["checked"] = checked;
+	d["deduplicated"] = deduplicated;
+	return d;
+}
+
 void ResourceLoader::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("load_threaded_request", "path", "type_hint", "use_sub_threads", "cache_mode"), &ResourceLoader::load_threaded_request, DEFVAL(""), DEFVAL(false), DEFVAL(CACHE_MODE_REUSE));
 	ClassDB::bind_method(D_METHOD("load_threaded_get_status", "path", "progress"), &ResourceLoader::load_threaded_get_status, DEFVAL(Array()));
@@ -135,6 +187,13 @@ void ResourceLoader::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("has_cached", "path"), &ResourceLoader::has_cached);
 	ClassDB::bind_method(D_METHOD("exists", "path", "type_hint"), &ResourceLoader::exists, DEFVAL(""));
 	ClassDB::bind_method(D_METHOD("get_resource_uid", "path"), &ResourceLoader::get_resource_uid);
+	ClassDB::bind_method(D_METHOD("set_load_tracing_enabled", "enabled"), &ResourceLoader::set_load_tracing_enabled);
+	ClassDB::bind_method(D_METHOD("is_load_tracing_enabled"), &ResourceLoader::is_load_tracing_enabled);
+	ClassDB::bind_method(D_METHOD("get_load_trace"), &ResourceLoader::get_load_trace);
+	ClassDB::bind_method(D_METHOD("clear_load_trace"), &ResourceLoader::clear_load_trace);
+	ClassDB::bind_method(D_METHOD("set_sub_resource_deduplication_enabled", "enabled"), &ResourceLoader::set_sub_resource_deduplication_enabled);
+	ClassDB::bind_method(D_METHOD("is_sub_resource_deduplication_enabled"), &ResourceLoader::is_sub_resource_deduplication_enabled);
+	ClassDB::bind_method(D_METHOD("get_sub_resource_deduplication_stats"), &ResourceLoader::get_sub_resource_deduplication_stats);
 
 	BIND_ENUM_CONSTANT(THREAD_LOAD_INVALID_RESOURCE);
 	BIND_ENUM_CONSTANT(THREAD_LOAD_IN_PROGRESS);
@@ -84,6 +84,15 @@ public:
 	bool exists(const String &p_path, const String &p_type_hint = "");
 	ResourceUID::ID get_resource_uid(const String &p_path);
 
+	void set_load_tracing_enabled(bool p_enabled);
+	bool is_load_tracing_enabled() const;
+	TypedArray<Dictionary> get_load_trace() const;
+	void clear_load_trace();
+
+	void set_sub_resource_deduplication_enabled(bool p_enabled);
+	bool is_sub_resource_deduplication_enabled() const;
+	Dictionary get_sub_resource_deduplication_stats() const;
+
 	ResourceLoader() { singleton = this; }
 };
 
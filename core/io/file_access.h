@@ -127,6 +127,7 @@ public:
 	Variant get_var(bool p_allow_objects = false) const;
 
 	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const; ///< get an array of bytes
+	virtual const uint8_t *get_mapped_buffer(uint64_t p_length) const { return nullptr; } ///< get a pointer to the next bytes and advance, if the file is already in memory
 	Vector<uint8_t> get_buffer(int64_t p_length) const;
 	virtual String get_line() const;
 	virtual String get_token() const;
@@ -164,7 +165,7 @@ public:
 	virtual void store_buffer(const uint8_t *p_src, uint64_t p_length); ///< store an array of bytes
 	void store_buffer(const Vector<uint8_t> &p_buffer);
 
-	void store_var(const Variant &p_var, bool p_full_objects = false);
+	void store_var(const Variant &p_var, bool p_full_objects = false, bool p_bulk_containers = false);
 
 	virtual bool file_exists(const String &p_name) = 0; ///< return true if a file exists
 
@@ -30,8 +30,12 @@
 
 #include "file_access_pack.h"
 
+#include "core/config/project_settings.h"
+#include "core/io/compression.h"
 #include "core/io/file_access_encrypted.h"
+#include "core/io/marshalls.h"
 #include "core/object/script_language.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
 #include "core/version.h"
 
@@ -47,7 +51,7 @@ Error PackedData::add_pack(const String &p_path, bool p_replace_files, uint64_t
 	return ERR_FILE_UNRECOGNIZED;
 }
 
-void PackedData::add_path(const String &p_pkg_path, const String &p_path, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted) {
+void PackedData::add_path(const String &p_pkg_path, const String &p_path, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted, const uint8_t *p_data, bool p_compressed) {
 	PathMD5 pmd5(p_path.md5_buffer());
 
 	bool exists = files.has(pmd5);
@@ -61,6 +65,8 @@ void PackedData::add_path(const String &p_pkg_path, const String &p_path, uint64
 		pf.md5[i] = p_md5[i];
 	}
 	pf.src = p_src;
+	pf.data = p_data;
+	pf.compressed = p_compressed;
 
 	if (!exists || p_replace_files) {
 		files[pmd5] = pf;
@@ -104,6 +110,7 @@ void PackedData::add_pack_source(PackSource *p_source) {
 PackedData *PackedData::singleton = nullptr;
 
 PackedData::PackedData() {
+	previous_singleton = singleton;
 	singleton = this;
 	root = memnew(PackedDir);
 
@@ -122,6 +129,10 @@ PackedData::~PackedData() {
 		memdelete(sources[i]);
 	}
 	_free_packed_dirs(root);
+
+	if (singleton == this) {
+		singleton = previous_singleton;
+	}
 }
 
 //////////////////////////////////////////////////////////////////
@@ -200,7 +211,7 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files,
 	uint32_t ver_minor = f->get_32();
 	f->get_32(); // patch number, not used for validation.
 
-	ERR_FAIL_COND_V_MSG(version != PACK_FORMAT_VERSION, false, "Pack version unsupported: " + itos(version) + ".");
+	ERR_FAIL_COND_V_MSG(version < PACK_FORMAT_VERSION_UNCOMPRESSED || version > PACK_FORMAT_VERSION, false, "Pack version unsupported: " + itos(version) + ".");
 	ERR_FAIL_COND_V_MSG(ver_major > VERSION_MAJOR || (ver_major == VERSION_MAJOR && ver_minor > VERSION_MINOR), false, "Pack created with a newer version of the engine: " + itos(ver_major) + "." + itos(ver_minor) + ".");
 
 	uint32_t pack_flags = f->get_32();
@@ -215,6 +226,28 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files,
 
 	int file_count = f->get_32();
 
+	// Map the whole pack when possible, so unencrypted files can be read without going through the file API.
+	// Packs in user:// can be replaced by the game while loaded (downloaded patches), so they're always read.
+	MappedPack mapped;
+	if (!p_path.begins_with("user://")) {
+		const String global_path = ProjectSettings::get_singleton()->globalize_path(p_path);
+		const MappedPack *existing = mapped_packs.getptr(global_path);
+		if (existing) {
+			// Only reuse the mapping if the file still has the size it had when it was mapped.
+			if (existing->size == f->get_length()) {
+				mapped = *existing;
+			}
+		} else if (OS::get_singleton()->map_file(global_path, mapped.data, mapped.size) == OK) {
+			if (mapped.size == f->get_length()) {
+				mapped_packs.insert(global_path, mapped);
+			} else {
+				// Changed while it was being opened.
+				OS::get_singleton()->unmap_file(mapped.data, mapped.size);
+				mapped = MappedPack();
+			}
+		}
+	}
+
 	if (enc_directory) {
 		Ref<FileAccessEncrypted> fae;
 		fae.instantiate();
@@ -247,7 +280,12 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files,
 		f->get_buffer(md5, 16);
 		uint32_t flags = f->get_32();
 
-		PackedData::get_singleton()->add_path(p_path, path, ofs + p_offset, size, md5, this, p_replace_files, (flags & PACK_FILE_ENCRYPTED));
+		const uint8_t *data = nullptr;
+		if (mapped.data && !(flags & PACK_FILE_ENCRYPTED) && ofs + p_offset <= mapped.size && size <= mapped.size - (ofs + p_offset)) {
+			data = mapped.data + ofs + p_offset;
+		}
+
+		PackedData::get_singleton()->add_path(p_path, path, ofs + p_offset, size, md5, this, p_replace_files, (flags & PACK_FILE_ENCRYPTED), data, (flags & PACK_FILE_COMPRESSED));
 	}
 
 	return true;
@@ -257,6 +295,12 @@ Ref<FileAccess> PackedSourcePCK::get_file(const String &p_path, PackedData::Pack
 	return memnew(FileAccessPack(p_path, *p_file));
 }
 
+PackedSourcePCK::~PackedSourcePCK() {
+	for (const KeyValue<String, MappedPack> &E : mapped_packs) {
+		OS::get_singleton()->unmap_file(E.value.data, E.value.size);
+	}
+}
+
 //////////////////////////////////////////////////////////////////
 
 Error FileAccessPack::open_internal(const String &p_path, int p_mode_flags) {
@@ -265,7 +309,9 @@ Error FileAccessPack::open_internal(const String &p_path, int p_mode_flags) {
 }
 
 bool FileAccessPack::is_open() const {
-	if (f.is_valid()) {
+	if (data) {
+		return true;
+	} else if (f.is_valid()) {
 		return f->is_open();
 	} else {
 		return false;
@@ -273,20 +319,22 @@ bool FileAccessPack::is_open() const {
 }
 
 void FileAccessPack::seek(uint64_t p_position) {
-	ERR_FAIL_COND_MSG(f.is_null(), "File must be opened before use.");
+	ERR_FAIL_COND_MSG(f.is_null() && !data, "File must be opened before use.");
 
-	if (p_position > pf.size) {
+	if (p_position > length) {
 		eof = true;
 	} else {
 		eof = false;
 	}
 
-	f->seek(off + p_position);
+	if (f.is_valid() && !block_size) {
+		f->seek(off + p_position);
+	}
 	pos = p_position;
 }
 
 void FileAccessPack::seek_end(int64_t p_position) {
-	seek(pf.size + p_position);
+	seek(length + p_position);
 }
 
 uint64_t FileAccessPack::get_position() const {
@@ -294,7 +342,7 @@ uint64_t FileAccessPack::get_position() const {
 }
 
 uint64_t FileAccessPack::get_length() const {
-	return pf.size;
+	return length;
 }
 
 bool FileAccessPack::eof_reached() const {
@@ -302,18 +350,32 @@ bool FileAccessPack::eof_reached() const {
 }
 
 uint8_t FileAccessPack::get_8() const {
-	ERR_FAIL_COND_V_MSG(f.is_null(), 0, "File must be opened before use.");
-	if (pos >= pf.size) {
+	ERR_FAIL_COND_V_MSG(f.is_null() && !data, 0, "File must be opened before use.");
+	if (pos >= length) {
 		eof = true;
 		return 0;
 	}
 
+	if (block_size) {
+		uint64_t block = pos / block_size;
+		if ((int64_t)block == cached_block) {
+			return block_cache[pos++ - block * block_size];
+		}
+		uint8_t byte = 0;
+		get_buffer(&byte, 1);
+		return byte;
+	}
+
+	if (data) {
+		return data[pos++];
+	}
+
 	pos++;
 	return f->get_8();
 }
 
 uint64_t FileAccessPack::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
-	ERR_FAIL_COND_V_MSG(f.is_null(), -1, "File must be opened before use.");
+	ERR_FAIL_COND_V_MSG(f.is_null() && !data, -1, "File must be opened before use.");
 	ERR_FAIL_COND_V(!p_dst && p_length > 0, -1);
 
 	if (eof) {
@@ -321,26 +383,89 @@ uint64_t FileAccessPack::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
 	}
 
 	int64_t to_read = p_length;
-	if (to_read + pos > pf.size) {
+	if (to_read + pos > length) {
 		eof = true;
-		to_read = (int64_t)pf.size - (int64_t)pos;
+		to_read = (int64_t)length - (int64_t)pos;
 	}
 
+	uint64_t read_pos = pos;
 	pos += p_length;
 
 	if (to_read <= 0) {
 		return 0;
 	}
-	f->get_buffer(p_dst, to_read);
+
+	if (block_size) {
+		const uint32_t block_count = block_offsets.size() - 1;
+		const uint64_t end = read_pos + to_read;
+		uint8_t *dst = p_dst;
+		uint64_t cur = read_pos;
+
+		while (cur < end) {
+			uint32_t block = cur / block_size;
+			uint64_t block_start = (uint64_t)block * block_size;
+
+			if (cur == block_start && (int64_t)block != cached_block) {
+				// Blocks that are read whole are decompressed straight into the destination.
+				uint32_t whole = (end - cur) / block_size;
+				if (end == length) {
+					whole = block_count - block; // The last block may be shorter.
+				}
+				if (whole > 0) {
+					if (!_decompress_blocks(block, whole, dst)) {
+						return cur - read_pos;
+					}
+					uint64_t n = MIN((uint64_t)whole * block_size, length - block_start);
+					dst += n;
+					cur += n;
+					continue;
+				}
+			}
+
+			if ((int64_t)block != cached_block) {
+				cached_block = -1;
+				block_cache.resize(_get_block_length(block));
+				if (!_decompress_blocks(block, 1, block_cache.ptr())) {
+					return cur - read_pos;
+				}
+				cached_block = block;
+			}
+
+			uint64_t n = MIN(end, block_start + block_cache.size()) - cur;
+			memcpy(dst, block_cache.ptr() + (cur - block_start), n);
+			dst += n;
+			cur += n;
+		}
+
+		return to_read;
+	}
+
+	if (data) {
+		memcpy(p_dst, data + read_pos, to_read);
+	} else {
+		f->get_buffer(p_dst, to_read);
+	}
 
 	return to_read;
 }
 
+const uint8_t *FileAccessPack::get_mapped_buffer(uint64_t p_length) const {
+	if (!data || block_size || eof || pos > length || p_length > length - pos) {
+		return nullptr;
+	}
+
+	const uint8_t *ptr = data + pos;
+	pos += p_length;
+	return ptr;
+}
+
 void FileAccessPack::set_big_endian(bool p_big_endian) {
-	ERR_FAIL_COND_MSG(f.is_null(), "File must be opened before use.");
+	ERR_FAIL_COND_MSG(f.is_null() && !data, "File must be opened before use.");
 
 	FileAccess::set_big_endian(p_big_endian);
-	f->set_big_endian(p_big_endian);
+	if (f.is_valid()) {
+		f->set_big_endian(p_big_endian);
+	}
 }
 
 Error FileAccessPack::get_error() const {
@@ -366,9 +491,153 @@ bool FileAccessPack::file_exists(const String &p_name) {
 	return false;
 }
 
+const uint8_t *FileAccessPack::_read_stored(uint64_t p_offset, uint64_t p_size) const {
+	ERR_FAIL_COND_V(p_offset > pf.size || p_size > pf.size - p_offset, nullptr);
+
+	if (data) {
+		return data + p_offset;
+	}
+
+	read_buffer.resize(p_size);
+	const_cast<FileAccess *>(f.ptr())->seek(off + p_offset);
+	if (f->get_buffer(read_buffer.ptr(), p_size) != p_size) {
+		return nullptr;
+	}
+	return read_buffer.ptr();
+}
+
+uint32_t FileAccessPack::_get_block_length(uint32_t p_block) const {
+	return MIN((uint64_t)block_size, length - (uint64_t)p_block * block_size);
+}
+
+bool FileAccessPack::_decompress_blocks(uint32_t p_first, uint32_t p_count, uint8_t *p_dst) const {
+	const uint64_t base = block_offsets[p_first];
+	const uint8_t *src = _read_stored(base, block_offsets[p_first + p_count] - base);
+	ERR_FAIL_NULL_V_MSG(src, false, "Can't read compressed pack-referenced file '" + String(pf.pack) + "'.");
+
+	SafeFlag failed;
+	auto decompress_range = [&](uint32_t p_from, uint32_t p_to) {
+		for (uint32_t i = p_from; i < p_to; i++) {
+			uint32_t block = p_first + i;
+			int block_length = _get_block_length(block);
+			int ret = Compression::decompress(p_dst + (uint64_t)i * block_size, block_length, src + (block_offsets[block] - base), block_offsets[block + 1] - block_offsets[block], Compression::MODE_ZSTD);
+			if (ret != block_length) {
+				failed.set();
+			}
+		}
+	};
+
+	// Several blocks at once are spread over the worker threads. When several resources load
+	// on the pool, each load decompresses on its own thread instead.
+	if (p_count > 1 && WorkerThreadPool::get_singleton()) {
+		WorkerThreadPool::get_singleton()->parallel_for(p_count, decompress_range, 1);
+	} else {
+		decompress_range(0, p_count);
+	}
+
+	ERR_FAIL_COND_V_MSG(failed.is_set(), false, "Corrupt compressed data in pack-referenced file '" + String(pf.pack) + "'.");
+	return true;
+}
+
+bool FileAccessPack::_parse_compressed_header() {
+	// Layout: uncompressed size (64 bits), block size, block count, the compressed size of each block, then the blocks.
+	const uint8_t *header = _read_stored(0, 16);
+	ERR_FAIL_NULL_V(header, false);
+
+	uint64_t uncompressed_size = decode_uint64(header);
+	uint32_t stored_block_size = decode_uint32(header + 8);
+	uint32_t block_count = decode_uint32(header + 12);
+	ERR_FAIL_COND_V(stored_block_size == 0 || block_count != (uncompressed_size + stored_block_size - 1) / stored_block_size, false);
+
+	const uint8_t *sizes = _read_stored(16, (uint64_t)block_count * 4);
+	ERR_FAIL_NULL_V(sizes, false);
+
+	block_offsets.resize(block_count + 1);
+	uint64_t offset = 16 + (uint64_t)block_count * 4;
+	for (uint32_t i = 0; i < block_count; i++) {
+		block_offsets[i] = offset;
+		offset += decode_uint32(sizes + i * 4);
+	}
+	block_offsets[block_count] = offset;
+	ERR_FAIL_COND_V(offset > pf.size, false);
+
+	length = uncompressed_size;
+	block_size = stored_block_size;
+	return true;
+}
+
+Vector<uint8_t> FileAccessPack::compress_data(const uint8_t *p_data, uint64_t p_size) {
+	const uint32_t block_count = (p_size + PACK_COMPRESSED_BLOCK_SIZE - 1) / PACK_COMPRESSED_BLOCK_SIZE;
+	if (block_count == 0) {
+		return Vector<uint8_t>();
+	}
+
+	const int max_block_size = Compression::get_max_compressed_buffer_size(PACK_COMPRESSED_BLOCK_SIZE, Compression::MODE_ZSTD);
+	LocalVector<uint8_t> blocks;
+	blocks.resize((uint64_t)block_count * max_block_size);
+	LocalVector<int> block_sizes;
+	block_sizes.resize(block_count);
+
+	auto compress_range = [&](uint32_t p_from, uint32_t p_to) {
+		for (uint32_t i = p_from; i < p_to; i++) {
+			uint64_t block_start = (uint64_t)i * PACK_COMPRESSED_BLOCK_SIZE;
+			int block_length = MIN((uint64_t)PACK_COMPRESSED_BLOCK_SIZE, p_size - block_start);
+			block_sizes[i] = Compression::compress(blocks.ptr() + (uint64_t)i * max_block_size, p_data + block_start, block_length, Compression::MODE_ZSTD);
+		}
+	};
+
+	if (WorkerThreadPool::get_singleton()) {
+		WorkerThreadPool::get_singleton()->parallel_for(block_count, compress_range, 1);
+	} else {
+		compress_range(0, block_count);
+	}
+
+	uint64_t stored_size = 16 + (uint64_t)block_count * 4;
+	for (uint32_t i = 0; i < block_count; i++) {
+		ERR_FAIL_COND_V(block_sizes[i] < 0, Vector<uint8_t>());
+		stored_size += block_sizes[i];
+	}
+	if (stored_size >= p_size) {
+		return Vector<uint8_t>(); // Not worth it, e.g. for files that are compressed already.
+	}
+
+	Vector<uint8_t> stored;
+	stored.resize(stored_size);
+	uint8_t *w = stored.ptrw();
+	encode_uint64(p_size, w);
+	encode_uint32(PACK_COMPRESSED_BLOCK_SIZE, w + 8);
+	encode_uint32(block_count, w + 12);
+	w += 16;
+	for (uint32_t i = 0; i < block_count; i++) {
+		encode_uint32(block_sizes[i], w);
+		w += 4;
+	}
+	for (uint32_t i = 0; i < block_count; i++) {
+		memcpy(w, blocks.ptr() + (uint64_t)i * max_block_size, block_sizes[i]);
+		w += block_sizes[i];
+	}
+
+	return stored;
+}
+
 FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file) :
-		pf(p_file),
-		f(FileAccess::open(pf.pack, FileAccess::READ)) {
+		pf(p_file) {
+	pos = 0;
+	eof = false;
+
+	length = pf.size;
+
+	if (pf.data) {
+		data = pf.data;
+		off = pf.offset;
+		if (pf.compressed && !_parse_compressed_header()) {
+			ERR_PRINT("Can't open compressed pack-referenced file '" + String(pf.pack) + "'.");
+			data = nullptr;
+		}
+		return;
+	}
+
+	f = FileAccess::open(pf.pack, FileAccess::READ);
 	ERR_FAIL_COND_MSG(f.is_null(), "Can't open pack-referenced file '" + String(pf.pack) + "'.");
 
 	f->seek(pf.offset);
@@ -390,8 +659,11 @@ FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFil
 		f = fae;
 		off = 0;
 	}
-	pos = 0;
-	eof = false;
+
+	if (pf.compressed && !_parse_compressed_header()) {
+		ERR_PRINT("Can't open compressed pack-referenced file '" + String(pf.pack) + "'.");
+		f.unref();
+	}
 }
 
 //////////////////////////////////////////////////////////////////////////////////
@@ -36,19 +36,25 @@
 #include "core/string/print_string.h"
 #include "core/templates/hash_set.h"
 #include "core/templates/list.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/rb_map.h"
 
 // Godot's packed file magic header ("GDPC" in ASCII).
 #define PACK_HEADER_MAGIC 0x43504447
 // The current packed file format version number.
-#define PACK_FORMAT_VERSION 2
+#define PACK_FORMAT_VERSION 3
+// Packs without compressed files are written with the previous version, so older versions of the engine can still load them.
+#define PACK_FORMAT_VERSION_UNCOMPRESSED 2
+// Size of the independently compressed blocks of compressed packed files.
+#define PACK_COMPRESSED_BLOCK_SIZE (64 * 1024)
 
 enum PackFlags {
 	PACK_DIR_ENCRYPTED = 1 << 0
 };
 
 enum PackFileFlags {
-	PACK_FILE_ENCRYPTED = 1 << 0
+	PACK_FILE_ENCRYPTED = 1 << 0,
+	PACK_FILE_COMPRESSED = 1 << 1,
 };
 
 class PackSource;
@@ -65,7 +71,9 @@ public:
 		uint64_t size;
 		uint8_t md5[16];
 		PackSource *src = nullptr;
+		const uint8_t *data = nullptr; // Points into the mapped pack, if any.
 		bool encrypted;
+		bool compressed = false;
 	};
 
 private:
@@ -103,13 +111,14 @@ private:
 	PackedDir *root = nullptr;
 
 	static PackedData *singleton;
+	PackedData *previous_singleton = nullptr; // Restored when this one is freed, so a temporary instance can be used.
 	bool disabled = false;
 
 	void _free_packed_dirs(PackedDir *p_dir);
 
 public:
 	void add_pack_source(PackSource *p_source);
-	void add_path(const String &p_pkg_path, const String &p_path, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted = false); // for PackSource
+	void add_path(const String &p_pkg_path, const String &p_path, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted = false, const uint8_t *p_data = nullptr, bool p_compressed = false); // for PackSource
 
 	void set_disabled(bool p_disabled) { disabled = p_disabled; }
 	_FORCE_INLINE_ bool is_disabled() const { return disabled; }
@@ -135,9 +144,18 @@ public:
 };
 
 class PackedSourcePCK : public PackSource {
+	struct MappedPack {
+		const uint8_t *data = nullptr;
+		uint64_t size = 0;
+	};
+
+	HashMap<String, MappedPack> mapped_packs; // Keyed by global path, so adding a pack again reuses its mapping.
+
 public:
 	virtual bool try_open_pack(const String &p_path, bool p_replace_files, uint64_t p_offset) override;
 	virtual Ref<FileAccess> get_file(const String &p_path, PackedData::PackedFile *p_file) override;
+
+	virtual ~PackedSourcePCK();
 };
 
 class FileAccessPack : public FileAccess {
@@ -146,8 +164,25 @@ class FileAccessPack : public FileAccess {
 	mutable uint64_t pos;
 	mutable bool eof;
 	uint64_t off;
+	uint64_t length = 0;
+
+	// Set when the pack is mapped in memory, reads don't go through `f` then.
+	const uint8_t *data = nullptr;
+
+	// Compressed files are stored as blocks of PACK_COMPRESSED_BLOCK_SIZE bytes, compressed
+	// independently, so they can be read from any position.
+	uint32_t block_size = 0;
+	LocalVector<uint64_t> block_offsets; // Offsets of the compressed blocks in the stored data, plus the end.
+	mutable LocalVector<uint8_t> block_cache;
+	mutable int64_t cached_block = -1;
+	mutable LocalVector<uint8_t> read_buffer;
 
 	Ref<FileAccess> f;
+
+	const uint8_t *_read_stored(uint64_t p_offset, uint64_t p_size) const;
+	uint32_t _get_block_length(uint32_t p_block) const;
+	bool _decompress_blocks(uint32_t p_first, uint32_t p_count, uint8_t *p_dst) const;
+	bool _parse_compressed_header();
 	virtual Error open_internal(const String &p_path, int p_mode_flags) override;
 	virtual uint64_t _get_modified_time(const String &p_file) override { return 0; }
 	virtual uint32_t _get_unix_permissions(const String &p_file) override { return 0; }
@@ -166,6 +201,7 @@ public:
 	virtual uint8_t get_8() const override;
 
 	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const override;
+	virtual const uint8_t *get_mapped_buffer(uint64_t p_length) const override;
 
 	virtual void set_big_endian(bool p_big_endian) override;
 
@@ -178,6 +214,9 @@ public:
 
 	virtual bool file_exists(const String &p_name) override;
 
+	// Returns the stored form of a file's contents, empty if compressing wouldn't make it smaller.
+	static Vector<uint8_t> compress_data(const uint8_t *p_data, uint64_t p_size);
+
 	FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file);
 };
 
@@ -58,6 +58,13 @@ ObjectID EncodedObjectAsID::get_object_id() const {
 #define ENCODE_MASK 0xFF
 #define ENCODE_FLAG_64 1 << 16
 #define ENCODE_FLAG_OBJECT_AS_ID 1 << 16
+#define ENCODE_FLAG_BULK 1 << 16
+
+// When encode_variant() is called with p_bulk_containers, arrays and dictionaries whose elements all
+// share one of the types below are encoded in bulk: a descriptor with the element type is written once,
+// followed by the element payloads without per-element headers. Bools take a single byte and the whole
+// block is padded to 4 bytes. Engines without bulk support can't decode such data, so it's opt-in.
+#define BULK_FLAG_TYPED 1 << 17
 
 static Error _decode_string(const uint8_t *&buf, int &len, int *r_len, String &r_string) {
 	ERR_FAIL_COND_V(len < 4, ERR_INVALID_DATA);
@@ -94,6 +101,425 @@ static Error _decode_string(const uint8_t *&buf, int &len, int *r_len, String &r
 	return OK;
 }
 
+static bool _is_bulk_type(uint32_t p_type) {
+	switch (p_type) {
+		case Variant::BOOL:
+		case Variant::INT:
+		case Variant::FLOAT:
+		case Variant::STRING:
+		case Variant::VECTOR2:
+		case Variant::VECTOR2I:
+		case Variant::RECT2:
+		case Variant::RECT2I:
+		case Variant::VECTOR3:
+		case Variant::VECTOR3I:
+		case Variant::VECTOR4:
+		case Variant::VECTOR4I:
+		case Variant::PLANE:
+		case Variant::QUATERNION:
+		case Variant::COLOR:
+		case Variant::STRING_NAME:
+			return true;
+		default:
+			return false;
+	}
+}
+
+// Returns the size of an element in a bulk block, or 0 for strings, which have a variable size.
+static int _get_bulk_element_size(uint32_t p_descriptor) {
+	const int real_size = (p_descriptor & ENCODE_FLAG_64) ? sizeof(double) : sizeof(float);
+	switch (p_descriptor & ENCODE_MASK) {
+		case Variant::BOOL:
+			return 1;
+		case Variant::INT:
+		case Variant::FLOAT:
+			return real_size;
+		case Variant::VECTOR2:
+			return real_size * 2;
+		case Variant::VECTOR2I:
+			return 4 * 2;
+		case Variant::VECTOR3:
+			return real_size * 3;
+		case Variant::VECTOR3I:
+			return 4 * 3;
+		case Variant::RECT2:
+		case Variant::VECTOR4:
+		case Variant::PLANE:
+		case Variant::QUATERNION:
+			return real_size * 4;
+		case Variant::RECT2I:
+		case Variant::VECTOR4I:
+		case Variant::COLOR: // Colors should always be in single-precision.
+			return 4 * 4;
+		default:
+			return 0;
+	}
+}
+
+// Returns the flags p_value needs in a bulk block, to be merged into the block descriptor.
+static uint32_t _get_bulk_element_flags(const Variant &p_value) {
+	switch (p_value.get_type()) {
+		case Variant::INT: {
+			int64_t val = p_value;
+			return (val > (int64_t)INT_MAX || val < (int64_t)INT_MIN) ? ENCODE_FLAG_64 : 0;
+		}
+		case Variant::FLOAT: {
+			double d = p_value;
+			float f = d;
+			return double(f) != d ? ENCODE_FLAG_64 : 0;
+		}
+#ifdef REAL_T_IS_DOUBLE
+		case Variant::VECTOR2:
+		case Variant::RECT2:
+		case Variant::VECTOR3:
+		case Variant::VECTOR4:
+		case Variant::PLANE:
+		case Variant::QUATERNION:
+			return ENCODE_FLAG_64;
+#endif // REAL_T_IS_DOUBLE
+		default:
+			return 0;
+	}
+}
+
+// Returns the descriptor to encode the values of p_array in bulk, or 0 if they can't be.
+static uint32_t _get_bulk_array_descriptor(const Array &p_array) {
+	uint32_t type = Variant::NIL;
+	uint32_t descriptor = 0;
+	if (p_array.is_typed()) {
+		type = p_array.get_typed_builtin();
+		descriptor = BULK_FLAG_TYPED;
+	} else if (!p_array.is_empty()) {
+		type = p_array[0].get_type();
+	}
+	if (!_is_bulk_type(type)) {
+		return 0;
+	}
+	descriptor |= type;
+
+	for (int i = 0; i < p_array.size(); i++) {
+		const Variant &value = p_array[i];
+		if (value.get_type() != type) {
+			return 0;
+		}
+		descriptor |= _get_bulk_element_flags(value);
+	}
+	return descriptor;
+}
+
+// Returns false if the keys or values of p_dictionary can't be encoded in bulk.
+static bool _get_bulk_dictionary_descriptors(const Dictionary &p_dictionary, uint32_t &r_key_descriptor, uint32_t &r_value_descriptor) {
+	const Variant *key = p_dictionary.next(nullptr);
+	if (!key) {
+		return false;
+	}
+	const uint32_t key_type = key->get_type();
+	const uint32_t value_type = p_dictionary[*key].get_type();
+	if (!_is_bulk_type(key_type) || !_is_bulk_type(value_type)) {
+		return false;
+	}
+	r_key_descriptor = key_type;
+	r_value_descriptor = value_type;
+
+	for (; key; key = p_dictionary.next(key)) {
+		const Variant &value = p_dictionary[*key];
+		if (key->get_type() != key_type || value.get_type() != value_type) {
+			return false;
+		}
+		r_key_descriptor |= _get_bulk_element_flags(*key);
+		r_value_descriptor |= _get_bulk_element_flags(value);
+	}
+	return true;
+}
+
+static inline void _encode_bulk_uint32(uint32_t p_value, uint8_t *&buf) {
+	encode_uint32(p_value, buf);
+	buf += 4;
+}
+
+static inline void _encode_bulk_real(real_t p_value, bool p_64, uint8_t *&buf) {
+	if (p_64) {
+		encode_double(p_value, buf);
+		buf += sizeof(double);
+	} else {
+		encode_float(p_value, buf);
+		buf += sizeof(float);
+	}
+}
+
+static void _encode_bulk_element(const Variant &p_value, uint32_t p_descriptor, uint8_t *&buf, int &r_len) {
+	const bool is_64 = p_descriptor & ENCODE_FLAG_64;
+	const uint32_t type = p_descriptor & ENCODE_MASK;
+
+	if (type == Variant::STRING || type == Variant::STRING_NAME) {
+		// Padded by string length rather than position, as in _decode_string().
+		CharString utf8 = p_value.operator String().utf8();
+		int pad = utf8.length() % 4 ? 4 - utf8.length() % 4 : 0;
+		if (buf) {
+			_encode_bulk_uint32(utf8.length(), buf);
+			memcpy(buf, utf8.get_data(), utf8.length());
+			buf += utf8.length();
+			memset(buf, 0, pad);
+			buf += pad;
+		}
+		r_len += 4 + utf8.length() + pad;
+		return;
+	}
+
+	r_len += _get_bulk_element_size(p_descriptor);
+	if (!buf) {
+		return;
+	}
+
+	switch (type) {
+		case Variant::BOOL: {
+			*(buf++) = p_value.operator bool();
+		} break;
+		case Variant::INT: {
+			if (is_64) {
+				encode_uint64(p_value.operator int64_t(), buf);
+				buf += 8;
+			} else {
+				_encode_bulk_uint32(p_value.operator int32_t(), buf);
+			}
+		} break;
+		case Variant::FLOAT: {
+			if (is_64) {
+				encode_double(p_value.operator double(), buf);
+				buf += 8;
+			} else {
+				encode_float(p_value.operator float(), buf);
+				buf += 4;
+			}
+		} break;
+		case Variant::VECTOR2: {
+			Vector2 v2 = p_value;
+			_encode_bulk_real(v2.x, is_64, buf);
+			_encode_bulk_real(v2.y, is_64, buf);
+		} break;
+		case Variant::VECTOR2I: {
+			Vector2i v2 = p_value;
+			_encode_bulk_uint32(v2.x, buf);
+			_encode_bulk_uint32(v2.y, buf);
+		} break;
+		case Variant::RECT2: {
+			Rect2 r2 = p_value;
+			_encode_bulk_real(r2.position.x, is_64, buf);
+			_encode_bulk_real(r2.position.y, is_64, buf);
+			_encode_bulk_real(r2.size.x, is_64, buf);
+			_encode_bulk_real(r2.size.y, is_64, buf);
+		} break;
+		case Variant::RECT2I: {
+			Rect2i r2 = p_value;
+			_encode_bulk_uint32(r2.position.x, buf);
+			_encode_bulk_uint32(r2.position.y, buf);
+			_encode_bulk_uint32(r2.size.x, buf);
+			_encode_bulk_uint32(r2.size.y, buf);
+		} break;
+		case Variant::VECTOR3: {
+			Vector3 v3 = p_value;
+			_encode_bulk_real(v3.x, is_64, buf);
+			_encode_bulk_real(v3.y, is_64, buf);
+			_encode_bulk_real(v3.z, is_64, buf);
+		} break;
+		case Variant::VECTOR3I: {
+			Vector3i v3 = p_value;
+			_encode_bulk_uint32(v3.x, buf);
+			_encode_bulk_uint32(v3.y, buf);
+			_encode_bulk_uint32(v3.z, buf);
+		} break;
+		case Variant::VECTOR4: {
+			Vector4 v4 = p_value;
+			_encode_bulk_real(v4.x, is_64, buf);
+			_encode_bulk_real(v4.y, is_64, buf);
+			_encode_bulk_real(v4.z, is_64, buf);
+			_encode_bulk_real(v4.w, is_64, buf);
+		} break;
+		case Variant::VECTOR4I: {
+			Vector4i v4 = p_value;
+			_encode_bulk_uint32(v4.x, buf);
+			_encode_bulk_uint32(v4.y, buf);
+			_encode_bulk_uint32(v4.z, buf);
+			_encode_bulk_uint32(v4.w, buf);
+		} break;
+		case Variant::PLANE: {
+			Plane p = p_value;
+			_encode_bulk_real(p.normal.x, is_64, buf);
+			_encode_bulk_real(p.normal.y, is_64, buf);
+			_encode_bulk_real(p.normal.z, is_64, buf);
+			_encode_bulk_real(p.d, is_64, buf);
+		} break;
+		case Variant::QUATERNION: {
+			Quaternion q = p_value;
+			_encode_bulk_real(q.x, is_64, buf);
+			_encode_bulk_real(q.y, is_64, buf);
+			_encode_bulk_real(q.z, is_64, buf);
+			_encode_bulk_real(q.w, is_64, buf);
+		} break;
+		case Variant::COLOR: {
+			Color c = p_value;
+			encode_float(c.r, &buf[0]);
+			encode_float(c.g, &buf[4]);
+			encode_float(c.b, &buf[8]);
+			encode_float(c.a, &buf[12]);
+			buf += 4 * 4;
+		} break;
+		default: {
+		}
+	}
+}
+
+static inline uint32_t _decode_bulk_uint32(const uint8_t *&buf) {
+	uint32_t value = decode_uint32(buf);
+	buf += 4;
+	return value;
+}
+
+static inline real_t _decode_bulk_real(bool p_64, const uint8_t *&buf) {
+	real_t value;
+	if (p_64) {
+		value = decode_double(buf);
+		buf += sizeof(double);
+	} else {
+		value = decode_float(buf);
+		buf += sizeof(float);
+	}
+	return value;
+}
+
+// Decodes into r_variant, which can be an element of a preallocated container.
+static Error _decode_bulk_element(Variant &r_variant, uint32_t p_descriptor, int p_size, const uint8_t *&buf, int &len) {
+	const bool is_64 = p_descriptor & ENCODE_FLAG_64;
+	const uint32_t type = p_descriptor & ENCODE_MASK;
+
+	if (type == Variant::STRING || type == Variant::STRING_NAME) {
+		String str;
+		Error err = _decode_string(buf, len, nullptr, str);
+		if (err) {
+			return err;
+		}
+		if (type == Variant::STRING_NAME) {
+			r_variant = StringName(str);
+		} else {
+			r_variant = str;
+		}
+		return OK;
+	}
+
+	ERR_FAIL_COND_V(len < p_size, ERR_INVALID_DATA);
+	len -= p_size;
+
+	switch (type) {
+		case Variant::BOOL: {
+			r_variant = bool(*(buf++));
+		} break;
+		case Variant::INT: {
+			if (is_64) {
+				r_variant = int64_t(decode_uint64(buf));
+				buf += 8;
+			} else {
+				r_variant = int32_t(_decode_bulk_uint32(buf));
+			}
+		} break;
+		case Variant::FLOAT: {
+			if (is_64) {
+				r_variant = decode_double(buf);
+				buf += 8;
+			} else {
+				r_variant = decode_float(buf);
+				buf += 4;
+			}
+		} break;
+		case Variant::VECTOR2: {
+			Vector2 val;
+			val.x = _decode_bulk_real(is_64, buf);
+			val.y = _decode_bulk_real(is_64, buf);
+			r_variant = val;
+		} break;
+		case Variant::VECTOR2I: {
+			Vector2i val;
+			val.x = _decode_bulk_uint32(buf);
+			val.y = _decode_bulk_uint32(buf);
+			r_variant = val;
+		} break;
+		case Variant::RECT2: {
+			Rect2 val;
+			val.position.x = _decode_bulk_real(is_64, buf);
+			val.position.y = _decode_bulk_real(is_64, buf);
+			val.size.x = _decode_bulk_real(is_64, buf);
+			val.size.y = _decode_bulk_real(is_64, buf);
+			r_variant = val;
+		} break;
+		case Variant::RECT2I: {
+			Rect2i val;
+			val.position.x = _decode_bulk_uint32(buf);
+			val.position.y = _decode_bulk_uint32(buf);
+			val.size.x = _decode_bulk_uint32(buf);
+			val.size.y = _decode_bulk_uint32(buf);
+			r_variant = val;
+		} break;
+		case Variant::VECTOR3: {
+			Vector3 val;
+			val.x = _decode_bulk_real(is_64, buf);
+			val.y = _decode_bulk_real(is_64, buf);
+			val.z = _decode_bulk_real(is_64, buf);
+			r_variant = val;
+		} break;
+		case Variant::VECTOR3I: {
+			Vector3i val;
+			val.x = _decode_bulk_uint32(buf);
+			val.y = _decode_bulk_uint32(buf);
+			val.z = _decode_bulk_uint32(buf);
+			r_variant = val;
+		} break;
+		case Variant::VECTOR4: {
+			Vector4 val;
+			val.x = _decode_bulk_real(is_64, buf);
+			val.y = _decode_bulk_real(is_64, buf);
+			val.z = _decode_bulk_real(is_64, buf);
+			val.w = _decode_bulk_real(is_64, buf);
+			r_variant = val;
+		} break;
+		case Variant::VECTOR4I: {
+			Vector4i val;
+			val.x = _decode_bulk_uint32(buf);
+			val.y = _decode_bulk_uint32(buf);
+			val.z = _decode_bulk_uint32(buf);
+			val.w = _decode_bulk_uint32(buf);
+			r_variant = val;
+		} break;
+		case Variant::PLANE: {
+			Plane val;
+			val.normal.x = _decode_bulk_real(is_64, buf);
+			val.normal.y = _decode_bulk_real(is_64, buf);
+			val.normal.z = _decode_bulk_real(is_64, buf);
+			val.d = _decode_bulk_real(is_64, buf);
+			r_variant = val;
+		} break;
+		case Variant::QUATERNION: {
+			Quaternion val;
+			val.x = _decode_bulk_real(is_64, buf);
+			val.y = _decode_bulk_real(is_64, buf);
+			val.z = _decode_bulk_real(is_64, buf);
+			val.w = _decode_bulk_real(is_64, buf);
+			r_variant = val;
+		} break;
+		case Variant::COLOR: {
+			Color val;
+			val.r = decode_float(&buf[0]);
+			val.g = decode_float(&buf[4]);
+			val.b = decode_float(&buf[8]);
+			val.a = decode_float(&buf[12]);
+			buf += 4 * 4;
+			r_variant = val;
+		} break;
+		default: {
+			ERR_FAIL_V(ERR_BUG);
+		}
+	}
+	return OK;
+}
+
 Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len, bool p_allow_objects, int p_depth) {
 	ERR_FAIL_COND_V_MSG(p_depth > Variant::MAX_RECURSION_DEPTH, ERR_OUT_OF_MEMORY, "Variant is too deep. Bailing.");
 	const uint8_t *buf = p_buffer;
@@ -716,6 +1142,38 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 
 			Dictionary d;
 
+			if (type & ENCODE_FLAG_BULK) {
+				ERR_FAIL_COND_V(len < 8, ERR_INVALID_DATA);
+				uint32_t key_descriptor = decode_uint32(buf);
+				uint32_t value_descriptor = decode_uint32(buf + 4);
+				buf += 8;
+				len -= 8;
+				ERR_FAIL_COND_V(!_is_bulk_type(key_descriptor & ENCODE_MASK) || !_is_bulk_type(value_descriptor & ENCODE_MASK), ERR_INVALID_DATA);
+
+				const int key_size = _get_bulk_element_size(key_descriptor);
+				const int value_size = _get_bulk_element_size(value_descriptor);
+				const int block_from = len;
+				for (int i = 0; i < count; i++) {
+					Variant key;
+					Error err = _decode_bulk_element(key, key_descriptor, key_size, buf, len);
+					ERR_FAIL_COND_V_MSG(err != OK, err, "Error when trying to decode Variant.");
+					err = _decode_bulk_element(d[key], value_descriptor, value_size, buf, len);
+					ERR_FAIL_COND_V_MSG(err != OK, err, "Error when trying to decode Variant.");
+				}
+
+				int block_len = block_from - len;
+				if (block_len % 4) {
+					block_len += 4 - block_len % 4;
+				}
+				ERR_FAIL_COND_V(block_len > block_from, ERR_INVALID_DATA);
+				if (r_len) {
+					(*r_len) += 8 + block_len;
+				}
+
+				r_variant = d;
+				break;
+			}
+
 			for (int i = 0; i < count; i++) {
 				Variant key, value;
 
@@ -759,6 +1217,44 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 
 			Array varr;
 
+			if (type & ENCODE_FLAG_BULK) {
+				ERR_FAIL_COND_V(len < 4, ERR_INVALID_DATA);
+				uint32_t descriptor = decode_uint32(buf);
+				buf += 4;
+				len -= 4;
+				ERR_FAIL_COND_V(!_is_bulk_type(descriptor & ENCODE_MASK), ERR_INVALID_DATA);
+
+				// Strings take at least 4 bytes, check the count before allocating.
+				const int size = _get_bulk_element_size(descriptor);
+				if (count) {
+					ERR_FAIL_MUL_OF(count, size ? size : 4, ERR_INVALID_DATA);
+					ERR_FAIL_COND_V(count * (size ? size : 4) > len, ERR_INVALID_DATA);
+				}
+
+				if (descriptor & BULK_FLAG_TYPED) {
+					varr.set_typed(descriptor & ENCODE_MASK, StringName(), Variant());
+				}
+				varr.resize(count);
+
+				const int block_from = len;
+				for (int i = 0; i < count; i++) {
+					Error err = _decode_bulk_element(varr[i], descriptor, size, buf, len);
+					ERR_FAIL_COND_V_MSG(err != OK, err, "Error when trying to decode Variant.");
+				}
+
+				int block_len = block_from - len;
+				if (block_len % 4) {
+					block_len += 4 - block_len % 4;
+				}
+				ERR_FAIL_COND_V(block_len > block_from, ERR_INVALID_DATA);
+				if (r_len) {
+					(*r_len) += 4 + block_len;
+				}
+
+				r_variant = varr;
+				break;
+			}
+
 			for (int i = 0; i < count; i++) {
 				int used = 0;
 				Variant v;
@@ -1114,13 +1610,14 @@ static void _encode_string(const String &p_string, uint8_t *&buf, int &r_len) {
 	}
 }
 
-Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_full_objects, int p_depth) {
+Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_full_objects, bool p_bulk_containers, int p_depth) {
 	ERR_FAIL_COND_V_MSG(p_depth > Variant::MAX_RECURSION_DEPTH, ERR_OUT_OF_MEMORY, "Potential infinite recursion detected. Bailing.");
 	uint8_t *buf = r_buffer;
 
 	r_len = 0;
 
 	uint32_t flags = 0;
+	uint32_t bulk_descriptors[2] = {};
 
 	switch (p_variant.get_type()) {
 		case Variant::INT: {
@@ -1136,6 +1633,17 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				flags |= ENCODE_FLAG_64;
 			}
 		} break;
+		case Variant::DICTIONARY: {
+			if (p_bulk_containers && _get_bulk_dictionary_descriptors(p_variant, bulk_descriptors[0], bulk_descriptors[1])) {
+				flags |= ENCODE_FLAG_BULK;
+			}
+		} break;
+		case Variant::ARRAY: {
+			bulk_descriptors[0] = p_bulk_containers ? _get_bulk_array_descriptor(p_variant) : 0;
+			if (bulk_descriptors[0]) {
+				flags |= ENCODE_FLAG_BULK;
+			}
+		} break;
 		case Variant::OBJECT: {
 			// Test for potential wrong values sent by the debugger when it breaks.
 			Object *obj = p_variant.get_validated_object();
@@ -1518,7 +2026,7 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 						_encode_string(E.name, buf, r_len);
 
 						int len;
-						Error err = encode_variant(obj->get(E.name), buf, len, p_full_objects, p_depth + 1);
+						Error err = encode_variant(obj->get(E.name), buf, len, p_full_objects, p_bulk_containers, p_depth + 1);
 						ERR_FAIL_COND_V(err, err);
 						ERR_FAIL_COND_V(len % 4, ERR_BUG);
 						r_len += len;
@@ -1563,12 +2071,33 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			}
 			r_len += 4;
 
+			if (flags & ENCODE_FLAG_BULK) {
+				if (buf) {
+					encode_uint32(bulk_descriptors[0], buf);
+					encode_uint32(bulk_descriptors[1], buf + 4);
+					buf += 8;
+				}
+				r_len += 8;
+
+				for (const Variant *key = d.next(nullptr); key; key = d.next(key)) {
+					_encode_bulk_element(*key, bulk_descriptors[0], buf, r_len);
+					_encode_bulk_element(*d.getptr(*key), bulk_descriptors[1], buf, r_len);
+				}
+				while (r_len % 4) {
+					r_len++; // Pad.
+					if (buf) {
+						*(buf++) = 0;
+					}
+				}
+				break;
+			}
+
 			List<Variant> keys;
 			d.get_key_list(&keys);
 
 			for (const Variant &E : keys) {
 				int len;
-				Error err = encode_variant(E, buf, len, p_full_objects, p_depth + 1);
+				Error err = encode_variant(E, buf, len, p_full_objects, p_bulk_containers, p_depth + 1);
 				ERR_FAIL_COND_V(err, err);
 				ERR_FAIL_COND_V(len % 4, ERR_BUG);
 				r_len += len;
@@ -1577,7 +2106,7 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				}
 				Variant *v = d.getptr(E);
 				ERR_FAIL_COND_V(!v, ERR_BUG);
-				err = encode_variant(*v, buf, len, p_full_objects, p_depth + 1);
+				err = encode_variant(*v, buf, len, p_full_objects, p_bulk_containers, p_depth + 1);
 				ERR_FAIL_COND_V(err, err);
 				ERR_FAIL_COND_V(len % 4, ERR_BUG);
 				r_len += len;
@@ -1597,9 +2126,34 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 
 			r_len += 4;
 
+			if (flags & ENCODE_FLAG_BULK) {
+				if (buf) {
+					encode_uint32(bulk_descriptors[0], buf);
+					buf += 4;
+				}
+				r_len += 4;
+
+				const int size = _get_bulk_element_size(bulk_descriptors[0]);
+				if (!buf && size) {
+					// Only measuring, fixed size elements.
+					r_len += v.size() * size;
+				} else {
+					for (int i = 0; i < v.size(); i++) {
+						_encode_bulk_element(v.get(i), bulk_descriptors[0], buf, r_len);
+					}
+				}
+				while (r_len % 4) {
+					r_len++; // Pad.
+					if (buf) {
+						*(buf++) = 0;
+					}
+				}
+				break;
+			}
+
 			for (int i = 0; i < v.size(); i++) {
 				int len;
-				Error err = encode_variant(v.get(i), buf, len, p_full_objects, p_depth + 1);
+				Error err = encode_variant(v.get(i), buf, len, p_full_objects, p_bulk_containers, p_depth + 1);
 				ERR_FAIL_COND_V(err, err);
 				ERR_FAIL_COND_V(len % 4, ERR_BUG);
 				r_len += len;
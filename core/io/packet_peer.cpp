@@ -88,9 +88,9 @@ Error PacketPeer::get_var(Variant &r_variant, bool p_allow_objects) {
 	return decode_variant(r_variant, buffer, buffer_size, nullptr, p_allow_objects);
 }
 
-Error PacketPeer::put_var(const Variant &p_packet, bool p_full_objects) {
+Error PacketPeer::put_var(const Variant &p_packet, bool p_full_objects, bool p_bulk_containers) {
 	int len;
-	Error err = encode_variant(p_packet, nullptr, len, p_full_objects); // compute len first
+	Error err = encode_variant(p_packet, nullptr, len, p_full_objects, p_bulk_containers); // compute len first
 	if (err) {
 		return err;
 	}
@@ -107,7 +107,7 @@ Error PacketPeer::put_var(const Variant &p_packet, bool p_full_objects) {
 	}
 
 	uint8_t *w = encode_buffer.ptrw();
-	err = encode_variant(p_packet, w, len, p_full_objects);
+	err = encode_variant(p_packet, w, len, p_full_objects, p_bulk_containers);
 	ERR_FAIL_COND_V_MSG(err != OK, err, "Error when trying to encode Variant.");
 
 	return put_packet(w, len);
@@ -137,7 +137,7 @@ Error PacketPeer::_get_packet_error() const {
 
 void PacketPeer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_var", "allow_objects"), &PacketPeer::_bnd_get_var, DEFVAL(false));
-	ClassDB::bind_method(D_METHOD("put_var", "var", "full_objects"), &PacketPeer::put_var, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("put_var", "var", "full_objects", "bulk_containers"), &PacketPeer::put_var, DEFVAL(false), DEFVAL(false));
 
 	ClassDB::bind_method(D_METHOD("get_packet"), &PacketPeer::_get_packet);
 	ClassDB::bind_method(D_METHOD("put_packet", "buffer"), &PacketPeer::_put_packet);
@@ -69,7 +69,7 @@ public:
 	virtual Error put_packet_buffer(const Vector<uint8_t> &p_buffer);
 
 	virtual Error get_var(Variant &r_variant, bool p_allow_objects = false);
-	virtual Error put_var(const Variant &p_packet, bool p_full_objects = false);
+	virtual Error put_var(const Variant &p_packet, bool p_full_objects = false, bool p_bulk_containers = false);
 
 	void set_encode_buffer_max_size(int p_max_size);
 	int get_encode_buffer_max_size() const;
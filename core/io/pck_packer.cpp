@@ -31,6 +31,7 @@
 #include "pck_packer.h"
 
 #include "core/crypto/crypto_core.h"
+#include "core/io/dir_access.h"
 #include "core/io/file_access.h"
 #include "core/io/file_access_encrypted.h"
 #include "core/io/file_access_pack.h" // PACK_HEADER_MAGIC, PACK_FORMAT_VERSION
@@ -48,10 +49,17 @@ static int _get_pad(int p_alignment, int p_n) {
 
 void PCKPacker::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("pck_start", "pck_name", "alignment", "key", "encrypt_directory"), &PCKPacker::pck_start, DEFVAL(32), DEFVAL("0000000000000000000000000000000000000000000000000000000000000000"), DEFVAL(false));
-	ClassDB::bind_method(D_METHOD("add_file", "pck_path", "source_path", "encrypt"), &PCKPacker::add_file, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("add_file", "pck_path", "source_path", "encrypt", "compress"), &PCKPacker::add_file, DEFVAL(false), DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("flush", "verbose"), &PCKPacker::flush, DEFVAL(false));
 }
 
+void PCKPacker::_close_spool() {
+	if (spool.is_valid()) {
+		spool.unref();
+		DirAccess::remove_absolute(spool_path);
+	}
+}
+
 Error PCKPacker::pck_start(const String &p_file, int p_alignment, const String &p_key, bool p_encrypt_directory) {
 	ERR_FAIL_COND_V_MSG((p_key.is_empty() || !p_key.is_valid_hex_number(false) || p_key.length() != 64), ERR_CANT_CREATE, "Invalid Encryption Key (must be 64 characters long).");
 	ERR_FAIL_COND_V_MSG(p_alignment <= 0, ERR_CANT_CREATE, "Invalid alignment, must be greater then 0.");
@@ -83,13 +91,16 @@ Error PCKPacker::pck_start(const String &p_file, int p_alignment, const String &
 	}
 	enc_dir = p_encrypt_directory;
 
+	_close_spool();
+
 	file = FileAccess::open(p_file, FileAccess::WRITE);
 	ERR_FAIL_COND_V_MSG(file.is_null(), ERR_CANT_CREATE, "Can't open file to write: " + String(p_file) + ".");
+	spool_path = p_file + ".tmp";
 
 	alignment = p_alignment;
 
 	file->store_32(PACK_HEADER_MAGIC);
-	file->store_32(PACK_FORMAT_VERSION);
+	file->store_32(PACK_FORMAT_VERSION_UNCOMPRESSED); // Updated on flush if files are compressed.
 	file->store_32(VERSION_MAJOR);
 	file->store_32(VERSION_MINOR);
 	file->store_32(VERSION_PATCH);
@@ -106,7 +117,7 @@ Error PCKPacker::pck_start(const String &p_file, int p_alignment, const String &
 	return OK;
 }
 
-Error PCKPacker::add_file(const String &p_file, const String &p_src, bool p_encrypt) {
+Error PCKPacker::add_file(const String &p_file, const String &p_src, bool p_encrypt, bool p_compress) {
 	ERR_FAIL_COND_V_MSG(file.is_null(), ERR_INVALID_PARAMETER, "File must be opened before use.");
 
 	Ref<FileAccess> f = FileAccess::open(p_src, FileAccess::READ);
@@ -131,6 +142,20 @@ Error PCKPacker::add_file(const String &p_file, const String &p_src, bool p_encr
 	}
 	pf.encrypted = p_encrypt;
 
+	if (p_compress) {
+		Vector<uint8_t> compressed_data = FileAccessPack::compress_data(data.ptr(), data.size());
+		if (!compressed_data.is_empty()) {
+			if (spool.is_null()) {
+				spool = FileAccess::open(spool_path, FileAccess::WRITE_READ);
+				ERR_FAIL_COND_V_MSG(spool.is_null(), ERR_CANT_CREATE, "Can't open file to write: " + spool_path + ".");
+			}
+			pf.compressed = true;
+			pf.spool_ofs = spool->get_position();
+			pf.size = compressed_data.size();
+			spool->store_buffer(compressed_data.ptr(), compressed_data.size());
+		}
+	}
+
 	uint64_t _size = pf.size;
 	if (p_encrypt) { // Add encryption overhead.
 		if (_size % 16) { // Pad to encryption block size.
@@ -152,6 +177,17 @@ Error PCKPacker::add_file(const String &p_file, const String &p_src, bool p_encr
 Error PCKPacker::flush(bool p_verbose) {
 	ERR_FAIL_COND_V_MSG(file.is_null(), ERR_INVALID_PARAMETER, "File must be opened before use.");
 
+	for (int i = 0; i < files.size(); i++) {
+		if (files[i].compressed) {
+			// Packs with compressed files can't be read by older versions of the engine.
+			int64_t header_end = file->get_position();
+			file->seek(4);
+			file->store_32(PACK_FORMAT_VERSION);
+			file->seek(header_end);
+			break;
+		}
+	}
+
 	int64_t file_base_ofs = file->get_position();
 	file->store_64(0); // files base
 
@@ -193,6 +229,9 @@ Error PCKPacker::flush(bool p_verbose) {
 		if (files[i].encrypted) {
 			flags |= PACK_FILE_ENCRYPTED;
 		}
+		if (files[i].compressed) {
+			flags |= PACK_FILE_COMPRESSED;
+		}
 		fhead->store_32(flags);
 	}
 
@@ -216,7 +255,13 @@ Error PCKPacker::flush(bool p_verbose) {
 
 	int count = 0;
 	for (int i = 0; i < files.size(); i++) {
-		Ref<FileAccess> src = FileAccess::open(files[i].src_path, FileAccess::READ);
+		Ref<FileAccess> src;
+		if (files[i].compressed) {
+			src = spool;
+			src->seek(files[i].spool_ofs);
+		} else {
+			src = FileAccess::open(files[i].src_path, FileAccess::READ);
+		}
 		uint64_t to_write = files[i].size;
 
 		Ref<FileAccess> ftmp = file;
@@ -257,7 +302,12 @@ Error PCKPacker::flush(bool p_verbose) {
 	}
 
 	file.unref();
+	_close_spool();
 	memdelete_arr(buf);
 
 	return OK;
 }
+
+PCKPacker::~PCKPacker() {
+	_close_spool();
+}
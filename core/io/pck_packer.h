@@ -45,7 +45,12 @@ class PCKPacker : public RefCounted {
 	Vector<uint8_t> key;
 	bool enc_dir = false;
 
+	// Compressed files are written here as they are added, so they aren't kept in memory until flush.
+	Ref<FileAccess> spool;
+	String spool_path;
+
 	static void _bind_methods();
+	void _close_spool();
 
 	struct File {
 		String path;
@@ -54,15 +59,18 @@ class PCKPacker : public RefCounted {
 		uint64_t size = 0;
 		bool encrypted = false;
 		Vector<uint8_t> md5;
+		bool compressed = false;
+		uint64_t spool_ofs = 0; // Where the compressed data is in the spool file.
 	};
 	Vector<File> files;
 
 public:
 	Error pck_start(const String &p_file, int p_alignment = 32, const String &p_key = "0000000000000000000000000000000000000000000000000000000000000000", bool p_encrypt_directory = false);
-	Error add_file(const String &p_file, const String &p_src, bool p_encrypt = false);
+	Error add_file(const String &p_file, const String &p_src, bool p_encrypt = false, bool p_compress = false);
 	Error flush(bool p_verbose = false);
 
 	PCKPacker() {}
+	~PCKPacker();
 };
 
 #endif // PCK_PACKER_H
@@ -56,33 +56,37 @@ void Resource::set_path(const String &p_path, bool p_take_over) {
 		p_take_over = false; // Can't take over an empty path
 	}
 
-	ResourceCache::lock.lock();
-
 	if (!path_cache.is_empty()) {
-		ResourceCache::resources.erase(path_cache);
+		ResourceCache::Shard &old_shard = ResourceCache::_get_shard(path_cache);
+		old_shard.lock.lock();
+		old_shard.resources.erase(path_cache);
+		old_shard.lock.unlock();
 	}
 
 	path_cache = "";
 
-	Ref<Resource> existing = ResourceCache::get_ref(p_path);
+	if (!p_path.is_empty()) {
+		ResourceCache::Shard &shard = ResourceCache::_get_shard(p_path);
+		shard.lock.lock();
 
-	if (existing.is_valid()) {
-		if (p_take_over) {
-			existing->path_cache = String();
-			ResourceCache::resources.erase(p_path);
-		} else {
-			ResourceCache::lock.unlock();
-			ERR_FAIL_MSG("Another resource is loaded from path '" + p_path + "' (possible cyclic resource inclusion).");
+		Ref<Resource> existing = ResourceCache::_get_ref_locked(shard, p_path);
+
+		if (existing.is_valid()) {
+			if (p_take_over) {
+				existing->path_cache = String();
+				shard.resources.erase(p_path);
+			} else {
+				shard.lock.unlock();
+				ERR_FAIL_MSG("Another resource is loaded from path '" + p_path + "' (possible cyclic resource inclusion).");
+			}
 		}
+
+		shard.resources[p_path] = this;
+		shard.lock.unlock();
 	}
 
 	path_cache = p_path;
 
-	if (!path_cache.is_empty()) {
-		ResourceCache::resources[path_cache] = this;
-	}
-	ResourceCache::lock.unlock();
-
 	_resource_path_changed();
 }
 
@@ -464,17 +468,21 @@ Resource::Resource() :
 		remapped_list(this) {}
 
 Resource::~Resource() {
+	if (content_cached) {
+		ResourceCache::_remove_content(this);
+	}
 	if (!path_cache.is_empty()) {
-		ResourceCache::lock.lock();
-		ResourceCache::resources.erase(path_cache);
-		ResourceCache::lock.unlock();
+		ResourceCache::Shard &shard = ResourceCache::_get_shard(path_cache);
+		shard.lock.lock();
+		shard.resources.erase(path_cache);
+		shard.lock.unlock();
 	}
 	if (owners.size()) {
 		WARN_PRINT("Resource is still owned.");
 	}
 }
 
-HashMap<String, Resource *> ResourceCache::resources;
+ResourceCache::Shard ResourceCache::shards[ResourceCache::SHARD_COUNT];
 #ifdef TOOLS_ENABLED
 HashMap<String, HashMap<String, String>> ResourceCache::resource_path_cache;
 #endif
@@ -484,32 +492,66 @@ Mutex ResourceCache::lock;
 RWLock ResourceCache::path_cache_lock;
 #endif
 
+BinaryMutex ResourceCache::content_lock;
+HashMap<uint32_t, LocalVector<ResourceCache::ContentEntry>> ResourceCache::content_cache;
+uint64_t ResourceCache::content_checked_count = 0;
+uint64_t ResourceCache::content_deduplicated_count = 0;
+
 void ResourceCache::clear() {
-	if (resources.size()) {
+	int count = 0;
+	for (Shard &shard : shards) {
+		count += shard.resources.size();
+	}
+
+	if (count) {
 		ERR_PRINT("Resources still in use at exit (run with --verbose for details).");
 		if (OS::get_singleton()->is_stdout_verbose()) {
-			for (const KeyValue<String, Resource *> &E : resources) {
-				print_line(vformat("Resource still in use: %s (%s)", E.key, E.value->get_class()));
+			for (const Shard &shard : shards) {
+				for (const KeyValue<String, Resource *> &E : shard.resources) {
+					print_line(vformat("Resource still in use: %s (%s)", E.key, E.value->get_class()));
+				}
 			}
 		}
 	}
 
-	resources.clear();
+	for (Shard &shard : shards) {
+		shard.resources.clear();
+	}
+
+	clear_deduplication();
+}
+
+Ref<Resource> ResourceCache::_get_ref_locked(Shard &p_shard, const String &p_path) {
+	Ref<Resource> ref;
+	Resource **res = p_shard.resources.getptr(p_path);
+
+	if (res) {
+		ref = Ref<Resource>(*res);
+
+		if (!ref.is_valid()) {
+			// This resource is in the process of being deleted, ignore its existence.
+			(*res)->path_cache = String();
+			p_shard.resources.erase(p_path);
+		}
+	}
+
+	return ref;
 }
 
 bool ResourceCache::has(const String &p_path) {
-	lock.lock();
+	Shard &shard = _get_shard(p_path);
+	shard.lock.lock();
 
-	Resource **res = resources.getptr(p_path);
+	Resource **res = shard.resources.getptr(p_path);
 
 	if (res && (*res)->get_reference_count() == 0) {
 		// This resource is in the process of being deleted, ignore its existence.
 		(*res)->path_cache = String();
-		resources.erase(p_path);
+		shard.resources.erase(p_path);
 		res = nullptr;
 	}
 
-	lock.unlock();
+	shard.lock.unlock();
 
 	if (!res) {
 		return false;
@@ -519,39 +561,159 @@ bool ResourceCache::has(const String &p_path) {
 }
 
 Ref<Resource> ResourceCache::get_ref(const String &p_path) {
-	Ref<Resource> ref;
-	lock.lock();
+	Shard &shard = _get_shard(p_path);
+	shard.lock.lock();
+	Ref<Resource> ref = _get_ref_locked(shard, p_path);
+	shard.lock.unlock();
 
-	Resource **res = resources.getptr(p_path);
+	return ref;
+}
 
-	if (res) {
-		ref = Ref<Resource>(*res);
+void ResourceCache::get_cached_resources(List<Ref<Resource>> *p_resources) {
+	for (Shard &shard : shards) {
+		shard.lock.lock();
+		for (KeyValue<String, Resource *> &E : shard.resources) {
+			p_resources->push_back(Ref<Resource>(E.value));
+		}
+		shard.lock.unlock();
 	}
+}
 
-	if (res && !ref.is_valid()) {
-		// This resource is in the process of being deleted, ignore its existence
-		(*res)->path_cache = String();
-		resources.erase(p_path);
-		res = nullptr;
+int ResourceCache::get_cached_resource_count() {
+	int rc = 0;
+	for (Shard &shard : shards) {
+		shard.lock.lock();
+		rc += shard.resources.size();
+		shard.lock.unlock();
 	}
 
-	lock.unlock();
+	return rc;
+}
 
-	return ref;
+// Objects are replaced by their IDs, so cache entries don't keep the resources they reference alive.
+static Variant _get_weak_content(const Variant &p_value) {
+	switch (p_value.get_type()) {
+		case Variant::OBJECT: {
+			Object *obj = p_value.get_validated_object();
+			return obj ? Variant(obj->get_instance_id()) : Variant();
+		}
+		case Variant::ARRAY: {
+			const Array array = p_value;
+			Array weak;
+			weak.resize(array.size());
+			for (int i = 0; i < array.size(); i++) {
+				weak[i] = _get_weak_content(array[i]);
+			}
+			return weak;
+		}
+		case Variant::DICTIONARY: {
+			const Dictionary dictionary = p_value;
+			Dictionary weak;
+			for (const Variant *key = dictionary.next(nullptr); key; key = dictionary.next(key)) {
+				weak[_get_weak_content(*key)] = _get_weak_content(dictionary[*key]);
+			}
+			return weak;
+		}
+		default: {
+			return p_value;
+		}
+	}
 }
 
-void ResourceCache::get_cached_resources(List<Ref<Resource>> *p_resources) {
-	lock.lock();
-	for (KeyValue<String, Resource *> &E : resources) {
-		p_resources->push_back(Ref<Resource>(E.value));
+Ref<Resource> ResourceCache::deduplicate(const Ref<Resource> &p_resource, const LocalVector<Pair<StringName, Variant>> &p_content) {
+	ERR_FAIL_COND_V(p_resource.is_null(), p_resource);
+
+	// The state of these may not be entirely in their stored properties, so they are never shared.
+	if (p_resource->is_local_to_scene() || !p_resource->get_script().is_null() || p_resource->is_class("MissingResource")) {
+		return p_resource;
+	}
+
+	// Sub-resources are deduplicated before the resources using them, so those compare by identity.
+	const StringName class_name = p_resource->get_class_name();
+	LocalVector<Pair<StringName, Variant>> content;
+	content.reserve(p_content.size());
+	uint32_t hash = class_name.hash();
+	for (const Pair<StringName, Variant> &E : p_content) {
+		PropertyInfo info;
+		if (ClassDB::get_property_info(class_name, E.first, &info) && (info.usage & PROPERTY_USAGE_RESOURCE_NOT_PERSISTENT)) {
+			continue;
+		}
+		Variant value = _get_weak_content(E.second);
+		hash = hash_murmur3_one_32(E.first.hash(), hash);
+		hash = hash_murmur3_one_32(value.recursive_hash(0), hash);
+		content.push_back(Pair<StringName, Variant>(E.first, value));
 	}
-	lock.unlock();
+	hash = hash_fmix32(hash);
+
+	MutexLock mutex_lock(content_lock);
+	content_checked_count++;
+
+	LocalVector<ContentEntry> &entries = content_cache[hash];
+	for (const ContentEntry &E : entries) {
+		if (E.class_name != class_name || E.content.size() != content.size()) {
+			continue;
+		}
+		bool equal = true;
+		for (uint32_t i = 0; i < content.size() && equal; i++) {
+			equal = E.content[i].first == content[i].first && E.content[i].second.hash_compare(content[i].second);
+		}
+		if (!equal) {
+			continue;
+		}
+
+		// Fails if it is being freed, its destructor then removes the entry once the lock is released.
+		Ref<Resource> candidate = Ref<Resource>(Object::cast_to<Resource>(ObjectDB::get_instance(E.resource)));
+		if (candidate.is_valid()) {
+			content_deduplicated_count++;
+			return candidate;
+		}
+	}
+
+	ContentEntry entry;
+	entry.resource = p_resource->get_instance_id();
+	entry.class_name = class_name;
+	entry.content = content;
+	entries.push_back(entry);
+	Ref<Resource> resource = p_resource;
+	resource->content_hash = hash;
+	resource->content_cached = true;
+	return resource;
 }
 
-int ResourceCache::get_cached_resource_count() {
-	lock.lock();
-	int rc = resources.size();
-	lock.unlock();
+void ResourceCache::_remove_content(Resource *p_resource) {
+	MutexLock mutex_lock(content_lock);
 
-	return rc;
+	LocalVector<ContentEntry> *entries = content_cache.getptr(p_resource->content_hash);
+	if (!entries) {
+		return;
+	}
+	ObjectID id = p_resource->get_instance_id();
+	for (uint32_t i = 0; i < entries->size(); i++) {
+		if ((*entries)[i].resource == id) {
+			entries->remove_at_unordered(i);
+			break;
+		}
+	}
+	if (entries->is_empty()) {
+		content_cache.erase(p_resource->content_hash);
+	}
+}
+
+void ResourceCache::get_deduplication_stats(uint64_t *r_checked, uint64_t *r_deduplicated, uint64_t *r_entries) {
+	MutexLock mutex_lock(content_lock);
+	*r_checked = content_checked_count;
+	*r_deduplicated = content_deduplicated_count;
+	if (r_entries) {
+		*r_entries = 0;
+		for (const KeyValue<uint32_t, LocalVector<ContentEntry>> &E : content_cache) {
+			*r_entries += E.value.size();
+		}
+	}
+}
+
+void ResourceCache::clear_deduplication() {
+	MutexLock mutex_lock(content_lock);
+	content_cache.clear();
+	content_checked_count = 0;
+	content_deduplicated_count = 0;
 }
@@ -34,6 +34,8 @@
 #include "core/io/resource_uid.h"
 #include "core/object/class_db.h"
 #include "core/object/ref_counted.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/pair.h"
 #include "core/templates/safe_refcount.h"
 #include "core/templates/self_list.h"
 
@@ -70,6 +72,8 @@ private:
 #endif
 
 	bool local_to_scene = false;
+	bool content_cached = false; // Registered for sub-resource deduplication under content_hash.
+	uint32_t content_hash = 0;
 	friend class SceneState;
 	Node *local_scene = nullptr;
 
@@ -152,12 +156,41 @@ public:
 class ResourceCache {
 	friend class Resource;
 	friend class ResourceLoader; //need the lock
-	static Mutex lock;
-	static HashMap<String, Resource *> resources;
+
+	enum {
+		SHARD_COUNT = 16, // Power of two, so the shard can be picked with a mask.
+	};
+
+	// Paths are spread over several independently locked maps, so threads loading different resources rarely contend.
+	struct Shard {
+		BinaryMutex lock;
+		HashMap<String, Resource *> resources;
+	};
+
+	static Shard shards[SHARD_COUNT];
+	static Mutex lock; // Guards the translation remapped list.
+
+	_FORCE_INLINE_ static Shard &_get_shard(const String &p_path) { return shards[p_path.hash() & (SHARD_COUNT - 1)]; }
+	static Ref<Resource> _get_ref_locked(Shard &p_shard, const String &p_path);
 #ifdef TOOLS_ENABLED
 	static HashMap<String, HashMap<String, String>> resource_path_cache; // Each tscn has a set of resource paths and IDs.
 	static RWLock path_cache_lock;
 #endif // TOOLS_ENABLED
+	// Sub-resources by content hash, so identical ones can be shared. Entries keep the property values
+	// the resource was loaded with, with objects replaced by their IDs, and are removed when it is freed.
+	struct ContentEntry {
+		ObjectID resource;
+		StringName class_name;
+		LocalVector<Pair<StringName, Variant>> content;
+	};
+
+	static BinaryMutex content_lock;
+	static HashMap<uint32_t, LocalVector<ContentEntry>> content_cache;
+	static uint64_t content_checked_count;
+	static uint64_t content_deduplicated_count;
+
+	static void _remove_content(Resource *p_resource);
+
 	friend void unregister_core_types();
 	static void clear();
 	friend void register_core_types();
@@ -167,6 +200,10 @@ public:
 	static Ref<Resource> get_ref(const String &p_path);
 	static void get_cached_resources(List<Ref<Resource>> *p_resources);
 	static int get_cached_resource_count();
+
+	static Ref<Resource> deduplicate(const Ref<Resource> &p_resource, const LocalVector<Pair<StringName, Variant>> &p_content);
+	static void get_deduplication_stats(uint64_t *r_checked, uint64_t *r_deduplicated, uint64_t *r_entries = nullptr);
+	static void clear_deduplication();
 };
 
 #endif // RESOURCE_H
@@ -397,21 +397,28 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 				} break;
 				case OBJECT_INTERNAL_RESOURCE: {
 					uint32_t index = f->get_32();
-					String path;
+					int internal_index = -1;
 
 					if (using_named_scene_ids) { // New format.
 						ERR_FAIL_INDEX_V((int)index, internal_resources.size(), ERR_PARSE_ERROR);
-						path = internal_resources[index].path;
+						internal_index = index;
 					} else {
-						path += res_path + "::" + itos(index);
+						const int *indexp = internal_index_map.getptr(res_path + "::" + itos(index));
+						if (indexp) {
+							internal_index = *indexp;
+						}
 					}
 
-					//always use internal cache for loading internal resources
-					if (!internal_index_cache.has(path)) {
-						WARN_PRINT(String("Couldn't load resource (no cache): " + path).utf8().get_data());
+					if (internal_index == -1) {
+						WARN_PRINT(String("Couldn't load resource (no cache): " + res_path + "::" + itos(index)).utf8().get_data());
 						r_v = Variant();
 					} else {
-						r_v = internal_index_cache[path];
+						Ref<Resource> res;
+						Error err = _get_internal_resource(internal_index, res);
+						if (err != OK) {
+							return err;
+						}
+						r_v = res;
 					}
 				} break;
 				case OBJECT_EXTERNAL_RESOURCE: {
@@ -711,172 +718,224 @@ Error ResourceLoaderBinary::load() {
 	}
 
 	for (int i = 0; i < internal_resources.size(); i++) {
-		bool main = i == (internal_resources.size() - 1);
+		String path = internal_resources[i].path;
 
-		//maybe it is loaded already
-		String path;
-		String id;
+		if (path.begins_with("local://")) {
+			path = path.replace_first("local://", "");
+			internal_resources.write[i].scene_unique_id = path;
+			path = res_path + "::" + path;
 
-		if (!main) {
-			path = internal_resources[i].path;
+			internal_resources.write[i].path = path; // Update path.
+		}
 
-			if (path.begins_with("local://")) {
-				path = path.replace_first("local://", "");
-				id = path;
-				path = res_path + "::" + path;
+		internal_index_map[path] = i;
+	}
 
-				internal_resources.write[i].path = path; // Update path.
-			}
+	if (internal_resources.is_empty()) {
+		return ERR_FILE_EOF;
+	}
 
-			if (cache_mode == ResourceFormatLoader::CACHE_MODE_REUSE && ResourceCache::has(path)) {
-				Ref<Resource> cached = ResourceCache::get_ref(path);
-				if (cached.is_valid()) {
-					//already loaded, don't do anything
-					error = OK;
-					internal_index_cache[path] = cached;
-					continue;
-				}
-			}
-		} else {
-			if (cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE && !ResourceCache::has(res_path)) {
-				path = res_path;
-			}
+	// Only the main resource is loaded here. Internal resources are loaded when first referenced.
+	Ref<Resource> res;
+	error = _get_internal_resource(internal_resources.size() - 1, res);
+	if (error != OK) {
+		return error;
+	}
+
+	f.unref();
+	resource = res;
+	resource->set_as_translation_remapped(translation_remapped);
+	return OK;
+}
+
+Error ResourceLoaderBinary::_get_internal_resource(int p_index, Ref<Resource> &r_res) {
+	IntResource &ir = internal_resources.write[p_index];
+	if (ir.instance.is_valid()) {
+		r_res = Ref<Resource>(Object::cast_to<Resource>(ObjectDB::get_instance(ir.instance)));
+		if (r_res.is_valid()) {
+			return OK;
 		}
+	}
 
-		uint64_t offset = internal_resources[i].offset;
+	if (ir.loading) {
+		// Referenced from one of the resources it references, which it did not get to set yet.
+		WARN_PRINT(String("Couldn't load resource (cyclic reference): " + ir.path).utf8().get_data());
+		r_res = Ref<Resource>();
+		return OK;
+	}
 
-		f->seek(offset);
+	// Loaded from wherever the file is being read, so go back there afterwards.
+	uint64_t return_offset = f->get_position();
+	ir.loading = true;
+	Error err = _load_internal_resource(p_index, r_res);
+	internal_resources.write[p_index].loading = false;
+	if (err != OK) {
+		return err;
+	}
 
-		String t = get_unicode_string();
+	// Not kept alive by the loader, so a resource that the one referencing it doesn't keep (like the Image of an
+	// ImageTexture, whose data is handed to the RenderingServer) is freed right away instead of at the end of the load.
+	internal_resources.write[p_index].instance = r_res->get_instance_id();
+	loaded_internal_count++;
+	if (progress) {
+		*progress = MIN(1.0, loaded_internal_count / float(internal_resources.size())); // Internal resources may be loaded again.
+	}
+
+	f->seek(return_offset);
+	return OK;
+}
+
+Error ResourceLoaderBinary::_load_internal_resource(int p_index, Ref<Resource> &r_res) {
+	bool main = p_index == (internal_resources.size() - 1);
+
+	//maybe it is loaded already
+	String path;
+	String id;
 
-		Ref<Resource> res;
+	if (!main) {
+		path = internal_resources[p_index].path;
+		id = internal_resources[p_index].scene_unique_id;
 
-		if (cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE && ResourceCache::has(path)) {
-			//use the existing one
+		if (cache_mode == ResourceFormatLoader::CACHE_MODE_REUSE && ResourceCache::has(path)) {
 			Ref<Resource> cached = ResourceCache::get_ref(path);
-			if (cached->get_class() == t) {
-				cached->reset_state();
-				res = cached;
+			if (cached.is_valid()) {
+				//already loaded, don't do anything
+				r_res = cached;
+				return OK;
 			}
 		}
+	} else {
+		if (cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE && !ResourceCache::has(res_path)) {
+			path = res_path;
+		}
+	}
 
-		MissingResource *missing_resource = nullptr;
+	uint64_t offset = internal_resources[p_index].offset;
 
-		if (res.is_null()) {
-			//did not replace
+	f->seek(offset);
 
-			Object *obj = ClassDB::instantiate(t);
-			if (!obj) {
-				if (ResourceLoader::is_creating_missing_resources_if_class_unavailable_enabled()) {
-					//create a missing resource
-					missing_resource = memnew(MissingResource);
-					missing_resource->set_original_class(t);
-					missing_resource->set_recording_properties(true);
-					obj = missing_resource;
-				} else {
-					error = ERR_FILE_CORRUPT;
-					ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, local_path + ":Resource of unrecognized type in file: " + t + ".");
-				}
-			}
+	String t = get_unicode_string();
 
-			Resource *r = Object::cast_to<Resource>(obj);
-			if (!r) {
-				String obj_class = obj->get_class();
+	Ref<Resource> res;
+	if (cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE && ResourceCache::has(path)) {
+		//use the existing one
+		Ref<Resource> cached = ResourceCache::get_ref(path);
+		if (cached->get_class() == t) {
+			cached->reset_state();
+			res = cached;
+		}
+	}
+
+	MissingResource *missing_resource = nullptr;
+
+	if (res.is_null()) {
+		//did not replace
+
+		Object *obj = ClassDB::instantiate(t);
+		if (!obj) {
+			if (ResourceLoader::is_creating_missing_resources_if_class_unavailable_enabled()) {
+				//create a missing resource
+				missing_resource = memnew(MissingResource);
+				missing_resource->set_original_class(t);
+				missing_resource->set_recording_properties(true);
+				obj = missing_resource;
+			} else {
 				error = ERR_FILE_CORRUPT;
-				memdelete(obj); //bye
-				ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, local_path + ":Resource type in resource field not a resource, type is: " + obj_class + ".");
+				ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, local_path + ":Resource of unrecognized type in file: " + t + ".");
 			}
+		}
 
-			res = Ref<Resource>(r);
-			if (!path.is_empty() && cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE) {
-				r->set_path(path, cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE); //if got here because the resource with same path has different type, replace it
-			}
-			r->set_scene_unique_id(id);
+		Resource *r = Object::cast_to<Resource>(obj);
+		if (!r) {
+			String obj_class = obj->get_class();
+			error = ERR_FILE_CORRUPT;
+			memdelete(obj); //bye
+			ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, local_path + ":Resource type in resource field not a resource, type is: " + obj_class + ".");
 		}
 
-		if (!main) {
-			internal_index_cache[path] = res;
+		res = Ref<Resource>(r);
+		if (!path.is_empty() && cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE) {
+			r->set_path(path, cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE); //if got here because the resource with same path has different type, replace it
 		}
+		r->set_scene_unique_id(id);
+	}
 
-		int pc = f->get_32();
+	// Set before the properties are, so references to itself resolve.
+	internal_resources.write[p_index].instance = res->get_instance_id();
 
-		//set properties
+	int pc = f->get_32();
 
-		Dictionary missing_resource_properties;
+	//set properties
 
-		for (int j = 0; j < pc; j++) {
-			StringName name = _get_string();
+	Dictionary missing_resource_properties;
 
-			if (name == StringName()) {
-				error = ERR_FILE_CORRUPT;
-				ERR_FAIL_V(ERR_FILE_CORRUPT);
-			}
+	// The parsed values identify the resource for deduplication, so they don't have to be read back from it.
+	const bool deduplicate = !main && cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE && ResourceLoader::is_sub_resource_deduplication_enabled();
+	LocalVector<Pair<StringName, Variant>> content;
 
-			Variant value;
+	for (int j = 0; j < pc; j++) {
+		StringName name = _get_string();
 
-			error = parse_variant(value);
-			if (error) {
-				return error;
-			}
+		if (name == StringName()) {
+			error = ERR_FILE_CORRUPT;
+			ERR_FAIL_V(ERR_FILE_CORRUPT);
+		}
 
-			bool set_valid = true;
-			if (value.get_type() == Variant::OBJECT && missing_resource != nullptr) {
-				// If the property being set is a missing resource (and the parent is not),
-				// then setting it will most likely not work.
-				// Instead, save it as metadata.
+		Variant value;
 
-				Ref<MissingResource> mr = value;
-				if (mr.is_valid()) {
-					missing_resource_properties[name] = mr;
-					set_valid = false;
-				}
+		error = parse_variant(value);
+		if (error) {
+			return error;
+		}
+
+		bool set_valid = true;
+		if (value.get_type() == Variant::OBJECT && missing_resource != nullptr) {
+			// If the property being set is a missing resource (and the parent is not),
+			// then setting it will most likely not work.
+			// Instead, save it as metadata.
+
+			Ref<MissingResource> mr = value;
+			if (mr.is_valid()) {
+				missing_resource_properties[name] = mr;
+				set_valid = false;
 			}
+		}
 
-			if (value.get_type() == Variant::ARRAY) {
-				Array set_array = value;
-				bool is_get_valid = false;
-				Variant get_value = res->get(name, &is_get_valid);
-				if (is_get_valid && get_value.get_type() == Variant::ARRAY) {
-					Array get_array = get_value;
-					if (!set_array.is_same_typed(get_array)) {
-						value = Array(set_array, get_array.get_typed_builtin(), get_array.get_typed_class_name(), get_array.get_typed_script());
-					}
+		if (value.get_type() == Variant::ARRAY) {
+			Array set_array = value;
+			bool is_get_valid = false;
+			Variant get_value = res->get(name, &is_get_valid);
+			if (is_get_valid && get_value.get_type() == Variant::ARRAY) {
+				Array get_array = get_value;
+				if (!set_array.is_same_typed(get_array)) {
+					value = Array(set_array, get_array.get_typed_builtin(), get_array.get_typed_class_name(), get_array.get_typed_script());
 				}
 			}
+		}
 
-			if (set_valid) {
-				res->set(name, value);
+		if (set_valid) {
+			res->set(name, value);
+			if (deduplicate) {
+				content.push_back(Pair<StringName, Variant>(name, value));
 			}
 		}
+	}
 
-		if (missing_resource) {
-			missing_resource->set_recording_properties(false);
-		}
+	if (missing_resource) {
+		missing_resource->set_recording_properties(false);
+	}
 
-		if (!missing_resource_properties.is_empty()) {
-			res->set_meta(META_MISSING_RESOURCES, missing_resource_properties);
-		}
+	if (!missing_resource_properties.is_empty()) {
+		res->set_meta(META_MISSING_RESOURCES, missing_resource_properties);
+	}
 
 #ifdef TOOLS_ENABLED
-		res->set_edited(false);
+	res->set_edited(false);
 #endif
 
-		if (progress) {
-			*progress = (i + 1) / float(internal_resources.size());
-		}
-
-		resource_cache.push_back(res);
-
-		if (main) {
-			f.unref();
-			resource = res;
-			resource->set_as_translation_remapped(translation_remapped);
-			error = OK;
-			return OK;
-		}
-	}
-
-	return ERR_FILE_EOF;
+	// Fully loaded at this point, so it can be swapped for an identical one loaded before.
+	r_res = deduplicate ? ResourceCache::deduplicate(res, content) : res;
+	return OK;
 }
 
 void ResourceLoaderBinary::set_translation_remapped(bool p_remapped) {
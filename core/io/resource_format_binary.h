@@ -50,7 +50,6 @@ class ResourceLoaderBinary {
 	ResourceUID::ID uid = ResourceUID::INVALID_ID;
 
 	Vector<char> str_buf;
-	List<Ref<Resource>> resource_cache;
 
 	Vector<StringName> string_map;
 
@@ -72,11 +71,18 @@ class ResourceLoaderBinary {
 
 	struct IntResource {
 		String path;
+		String scene_unique_id;
 		uint64_t offset;
+		ObjectID instance; // Not a reference, the loader doesn't keep internal resources alive.
+		bool loading = false;
 	};
 
 	Vector<IntResource> internal_resources;
-	HashMap<String, Ref<Resource>> internal_index_cache;
+	HashMap<String, int> internal_index_map;
+	int loaded_internal_count = 0;
+
+	Error _get_internal_resource(int p_index, Ref<Resource> &r_res);
+	Error _load_internal_resource(int p_index, Ref<Resource> &r_res);
 
 	String get_unicode_string();
 	void _advance_padding(uint32_t p_len);
@@ -140,6 +140,7 @@ public:
 
 	virtual Error import(const String &p_source_file, const String &p_save_path, const HashMap<StringName, Variant> &p_options, List<String> *r_platform_variants, List<String> *r_gen_files = nullptr, Variant *r_metadata = nullptr) = 0;
 	virtual bool can_import_threaded() const { return true; }
+	virtual bool can_cache_import() const { return true; } // False if importing writes files other than the returned ones.
 	virtual void import_threaded_begin() {}
 	virtual void import_threaded_end() {}
 
@@ -202,6 +202,7 @@ void ResourceFormatLoader::_bind_methods() {
 ///////////////////////////////////
 
 Ref<Resource> ResourceLoader::_load(const String &p_path, const String &p_original_path, const String &p_type_hint, ResourceFormatLoader::CacheMode p_cache_mode, Error *r_error, bool p_use_sub_threads, float *r_progress) {
+	MEMORY_CATEGORY_SCOPE(CATEGORY_RESOURCES);
 	bool found = false;
 
 	// Try all loaders and pick the first match for the type hint
@@ -230,64 +231,97 @@ Ref<Resource> ResourceLoader::_load(const String &p_path, const String &p_origin
 }
 
 void ResourceLoader::_thread_load_function(void *p_userdata) {
-	ThreadLoadTask &load_task = *(ThreadLoadTask *)p_userdata;
-	load_task.loader_id = Thread::get_caller_id();
+	String *local_path = (String *)p_userdata;
 
-	if (load_task.semaphore) {
-		//this is an actual thread, so wait for Ok from semaphore
-		thread_load_semaphore->wait(); //wait until its ok to start loading
+	thread_load_mutex.lock();
+	ThreadLoadTask *load_task = thread_load_tasks.getptr(*local_path);
+	if (load_task && (load_task->status != THREAD_LOAD_IN_PROGRESS || load_task->loader_id != 0)) {
+		load_task = nullptr; // Already loaded by a thread that could not wait for the pool to get to it.
 	}
-	load_task.resource = _load(load_task.remapped_path, load_task.remapped_path != load_task.local_path ? load_task.local_path : String(), load_task.type_hint, load_task.cache_mode, &load_task.error, load_task.use_sub_threads, &load_task.progress);
+	if (load_task) {
+		load_task->loader_id = Thread::get_caller_id();
+	}
+	thread_load_mutex.unlock();
 
-	load_task.progress = 1.0; //it was fully loaded at this point, so force progress to 1.0
+	memdelete(local_path);
 
-	thread_load_mutex->lock();
-	if (load_task.error != OK) {
-		load_task.status = THREAD_LOAD_FAILED;
-	} else {
-		load_task.status = THREAD_LOAD_LOADED;
+	if (load_task) {
+		_run_load_task(*load_task);
 	}
-	if (load_task.semaphore) {
-		if (load_task.start_next && thread_waiting_count > 0) {
-			thread_waiting_count--;
-			//thread loading count remains constant, this ends but another one begins
-			thread_load_semaphore->post();
-		} else {
-			thread_loading_count--; //no threads waiting, just reduce loading count
-		}
+}
 
-		print_lt("END: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_waiting_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
+void ResourceLoader::_run_load_task(ThreadLoadTask &p_load_task) {
+	// The task is not erased while in progress, whoever requested it holds it until it ends.
+	ThreadLoadTask *parent_task = current_load_task;
+	current_load_task = &p_load_task;
+	p_load_task.start_usec = OS::get_singleton()->get_ticks_usec();
 
-		for (int i = 0; i < load_task.poll_requests; i++) {
-			load_task.semaphore->post();
-		}
-		memdelete(load_task.semaphore);
-		load_task.semaphore = nullptr;
-	}
+	Error error = OK;
+	Ref<Resource> resource = _load(p_load_task.remapped_path, p_load_task.remapped_path != p_load_task.local_path ? p_load_task.local_path : String(), p_load_task.type_hint, p_load_task.cache_mode, &error, p_load_task.use_sub_threads, &p_load_task.progress);
+
+	current_load_task = parent_task;
+	p_load_task.progress = 1.0; //it was fully loaded at this point, so force progress to 1.0
 
-	if (load_task.resource.is_valid()) {
-		load_task.resource->set_path(load_task.local_path);
+	if (resource.is_valid()) {
+		resource->set_path(p_load_task.local_path);
 
-		if (load_task.xl_remapped) {
-			load_task.resource->set_as_translation_remapped(true);
+		if (p_load_task.xl_remapped) {
+			resource->set_as_translation_remapped(true);
 		}
 
 #ifdef TOOLS_ENABLED
 
-		load_task.resource->set_edited(false);
+		resource->set_edited(false);
 		if (timestamp_on_load) {
-			uint64_t mt = FileAccess::get_modified_time(load_task.remapped_path);
+			uint64_t mt = FileAccess::get_modified_time(p_load_task.remapped_path);
 			//printf("mt %s: %lli\n",remapped_path.utf8().get_data(),mt);
-			load_task.resource->set_last_modified_time(mt);
+			resource->set_last_modified_time(mt);
 		}
 #endif
 
 		if (_loaded_callback) {
-			_loaded_callback(load_task.resource, load_task.local_path);
+			_loaded_callback(resource, p_load_task.local_path);
 		}
 	}
 
-	thread_load_mutex->unlock();
+	thread_load_mutex.lock();
+
+	p_load_task.resource = resource;
+	p_load_task.error = error;
+	p_load_task.status = error != OK ? THREAD_LOAD_FAILED : THREAD_LOAD_LOADED;
+
+	if (load_tracing) {
+		LoadTrace trace;
+		trace.path = p_load_task.local_path;
+		trace.type = resource.is_valid() ? resource->get_class() : p_load_task.type_hint;
+		trace.source_path = p_load_task.source_path;
+		trace.thread_id = p_load_task.loader_id;
+		trace.request_usec = p_load_task.request_usec;
+		trace.start_usec = p_load_task.start_usec;
+		trace.end_usec = OS::get_singleton()->get_ticks_usec();
+		trace.error = error;
+		load_trace.push_back(trace);
+	}
+
+	print_lt("END: " + p_load_task.local_path + " / waiters: " + itos(p_load_task.waiters));
+
+	for (int i = 0; i < p_load_task.waiters; i++) {
+		p_load_task.semaphore->post();
+	}
+
+	thread_load_mutex.unlock();
+}
+
+void ResourceLoader::_reap_pool_tasks() {
+	// Pool tasks have to be waited for to be released, but only the ones already done are, so this never blocks.
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	for (uint32_t i = 0; i < pool_tasks.size(); i++) {
+		if (pool->is_task_completed(pool_tasks[i])) {
+			pool->wait_for_task_completion(pool_tasks[i]);
+			pool_tasks.remove_at_unordered(i);
+			i--;
+		}
+	}
 }
 
 static String _validate_local_path(const String &p_path) {
@@ -303,92 +337,76 @@ static String _validate_local_path(const String &p_path) {
 Error ResourceLoader::load_threaded_request(const String &p_path, const String &p_type_hint, bool p_use_sub_threads, ResourceFormatLoader::CacheMode p_cache_mode, const String &p_source_resource) {
 	String local_path = _validate_local_path(p_path);
 
-	thread_load_mutex->lock();
+	thread_load_mutex.lock();
 
 	if (!p_source_resource.is_empty()) {
 		//must be loading from this resource
-		if (!thread_load_tasks.has(p_source_resource)) {
-			thread_load_mutex->unlock();
+		ThreadLoadTask *source_task = thread_load_tasks.getptr(p_source_resource);
+		if (!source_task) {
+			thread_load_mutex.unlock();
 			ERR_FAIL_V_MSG(ERR_INVALID_PARAMETER, "There is no thread loading source resource '" + p_source_resource + "'.");
 		}
 		//must be loading from this thread
-		if (thread_load_tasks[p_source_resource].loader_id != Thread::get_caller_id()) {
-			thread_load_mutex->unlock();
+		if (source_task->loader_id != Thread::get_caller_id()) {
+			thread_load_mutex.unlock();
 			ERR_FAIL_V_MSG(ERR_INVALID_PARAMETER, "Threading loading resource'" + local_path + " failed: Source specified: '" + p_source_resource + "' but was not called by it.");
 		}
 
 		//must not be already added as s sub tasks
-		if (thread_load_tasks[p_source_resource].sub_tasks.has(local_path)) {
-			thread_load_mutex->unlock();
+		if (source_task->sub_tasks.has(local_path)) {
+			thread_load_mutex.unlock();
 			ERR_FAIL_V_MSG(ERR_INVALID_PARAMETER, "Thread loading source resource '" + p_source_resource + "' already is loading '" + local_path + "'.");
 		}
 	}
 
-	if (thread_load_tasks.has(local_path)) {
-		thread_load_tasks[local_path].requests++;
-		if (!p_source_resource.is_empty()) {
-			thread_load_tasks[p_source_resource].sub_tasks.insert(local_path);
-		}
-		thread_load_mutex->unlock();
-		return OK;
-	}
-
-	{
-		//create load task
-
-		ThreadLoadTask load_task;
+	ThreadLoadTask *load_task = thread_load_tasks.getptr(local_path);
 
-		load_task.requests = 1;
-		load_task.remapped_path = _path_remap(local_path, &load_task.xl_remapped);
-		load_task.local_path = local_path;
-		load_task.type_hint = p_type_hint;
-		load_task.cache_mode = p_cache_mode;
-		load_task.use_sub_threads = p_use_sub_threads;
+	if (!load_task) {
+		thread_load_mutex.unlock();
 
-		{ //must check if resource is already loaded before attempting to load it in a thread
+		// Remapping may hit the disk, so don't hold the lock meanwhile.
+		ThreadLoadTask new_task;
+		new_task.remapped_path = _path_remap(local_path, &new_task.xl_remapped);
+		new_task.local_path = local_path;
+		new_task.type_hint = p_type_hint;
+		new_task.source_path = !p_source_resource.is_empty() ? p_source_resource : (current_load_task ? current_load_task->local_path : String());
+		new_task.cache_mode = p_cache_mode;
+		new_task.use_sub_threads = p_use_sub_threads;
+		new_task.request_usec = OS::get_singleton()->get_ticks_usec();
 
-			if (load_task.loader_id == Thread::get_caller_id()) {
-				thread_load_mutex->unlock();
-				ERR_FAIL_V_MSG(ERR_INVALID_PARAMETER, "Attempted to load a resource already being loaded from this thread, cyclic reference?");
-			}
+		thread_load_mutex.lock();
 
+		load_task = thread_load_tasks.getptr(local_path);
+		if (!load_task) { // Nobody else requested it in the meantime.
+			//must check if resource is already loaded before attempting to load it in a thread
 			Ref<Resource> existing = ResourceCache::get_ref(local_path);
 
 			if (existing.is_valid()) {
 				//referencing is fine
-				load_task.resource = existing;
-				load_task.status = THREAD_LOAD_LOADED;
-				load_task.progress = 1.0;
+				new_task.resource = existing;
+				new_task.status = THREAD_LOAD_LOADED;
+				new_task.progress = 1.0;
 			}
-		}
 
-		if (!p_source_resource.is_empty()) {
-			thread_load_tasks[p_source_resource].sub_tasks.insert(local_path);
-		}
+			load_task = &thread_load_tasks.insert(local_path, new_task)->value;
 
-		thread_load_tasks[local_path] = load_task;
-	}
-
-	ThreadLoadTask &load_task = thread_load_tasks[local_path];
+			if (load_task->resource.is_null()) {
+				// Dependencies of a load in progress go to the pool threads, so they load in parallel with their siblings.
+				// Top-level requests are low priority, so a big load does not take the pool away from the rest of the engine.
+				load_task->task_id = WorkerThreadPool::get_singleton()->add_native_task(&ResourceLoader::_thread_load_function, memnew(String(local_path)), !p_source_resource.is_empty(), "Load " + local_path);
 
-	if (load_task.resource.is_null()) { //needs to be loaded in thread
-
-		load_task.semaphore = memnew(Semaphore);
-		if (thread_loading_count < thread_load_max) {
-			thread_loading_count++;
-			thread_load_semaphore->post(); //we have free threads, so allow one
-		} else {
-			thread_waiting_count++;
+				print_lt("REQUEST: " + local_path + " / source: " + load_task->source_path);
+			}
 		}
+	}
 
-		print_lt("REQUEST: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_waiting_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
+	load_task->requests++;
 
-		load_task.thread = memnew(Thread);
-		load_task.thread->start(_thread_load_function, &thread_load_tasks[local_path]);
-		load_task.loader_id = load_task.thread->get_id();
+	if (!p_source_resource.is_empty()) {
+		thread_load_tasks[p_source_resource].sub_tasks.insert(local_path);
 	}
 
-	thread_load_mutex->unlock();
+	thread_load_mutex.unlock();
 
 	return OK;
 }
@@ -418,9 +436,9 @@ float ResourceLoader::_dependency_get_progress(const String &p_path) {
 ResourceLoader::ThreadLoadStatus ResourceLoader::load_threaded_get_status(const String &p_path, float *r_progress) {
 	String local_path = _validate_local_path(p_path);
 
-	thread_load_mutex->lock();
+	thread_load_mutex.lock();
 	if (!thread_load_tasks.has(local_path)) {
-		thread_load_mutex->unlock();
+		thread_load_mutex.unlock();
 		return THREAD_LOAD_INVALID_RESOURCE;
 	}
 	ThreadLoadTask &load_task = thread_load_tasks[local_path];
@@ -430,7 +448,7 @@ ResourceLoader::ThreadLoadStatus ResourceLoader::load_threaded_get_status(const
 		*r_progress = _dependency_get_progress(local_path);
 	}
 
-	thread_load_mutex->unlock();
+	thread_load_mutex.unlock();
 
 	return status;
 }
@@ -438,76 +456,73 @@ ResourceLoader::ThreadLoadStatus ResourceLoader::load_threaded_get_status(const
 Ref<Resource> ResourceLoader::load_threaded_get(const String &p_path, Error *r_error) {
 	String local_path = _validate_local_path(p_path);
 
-	thread_load_mutex->lock();
-	if (!thread_load_tasks.has(local_path)) {
-		thread_load_mutex->unlock();
+	thread_load_mutex.lock();
+	ThreadLoadTask *load_task = thread_load_tasks.getptr(local_path);
+	if (!load_task) {
+		thread_load_mutex.unlock();
 		if (r_error) {
 			*r_error = ERR_INVALID_PARAMETER;
 		}
 		return Ref<Resource>();
 	}
 
-	ThreadLoadTask &load_task = thread_load_tasks[local_path];
-
-	//semaphore still exists, meaning it's still loading, request poll
-	Semaphore *semaphore = load_task.semaphore;
-	if (semaphore) {
-		load_task.poll_requests++;
-
-		{
-			// As we got a semaphore, this means we are going to have to wait
-			// until the sub-resource is done loading
-			//
-			// As this thread will become 'blocked' we should "exchange" its
-			// active status with a waiting one, to ensure load continues.
-			//
-			// This ensures loading is never blocked and that is also within
-			// the maximum number of active threads.
-
-			if (thread_waiting_count > 0) {
-				thread_waiting_count--;
-				thread_loading_count++;
-				thread_load_semaphore->post();
-
-				load_task.start_next = false; //do not start next since we are doing it here
+	if (load_task->status == THREAD_LOAD_IN_PROGRESS) {
+		if (load_task->loader_id == 0) {
+			// Still queued, so load it from this thread instead of blocking it until the pool gets to it.
+			// This also keeps pool threads waiting for dependencies from starving the pool.
+			load_task->loader_id = Thread::get_caller_id();
+			thread_load_mutex.unlock();
+			_run_load_task(*load_task);
+			thread_load_mutex.lock();
+		} else if (load_task->loader_id == Thread::get_caller_id()) {
+			load_task->requests--;
+			thread_load_mutex.unlock();
+			if (r_error) {
+				*r_error = ERR_CYCLIC_LINK;
 			}
+			ERR_FAIL_V_MSG(Ref<Resource>(), "Attempted to load a resource already being loaded from this thread, cyclic reference? Resource: '" + local_path + "'.");
+		} else {
+			// Being loaded from another thread, wait for it to end.
+			if (!load_task->semaphore) {
+				load_task->semaphore = memnew(Semaphore);
+			}
+			load_task->waiters++;
+			Semaphore *semaphore = load_task->semaphore;
 
-			thread_suspended_count++;
-
-			print_lt("GET: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_waiting_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
-		}
-
-		thread_load_mutex->unlock();
-		semaphore->wait();
-		thread_load_mutex->lock();
-
-		thread_suspended_count--;
+			thread_load_mutex.unlock();
+			semaphore->wait();
+			thread_load_mutex.lock();
 
-		if (!thread_load_tasks.has(local_path)) { //may have been erased during unlock and this was always an invalid call
-			thread_load_mutex->unlock();
-			if (r_error) {
-				*r_error = ERR_INVALID_PARAMETER;
+			load_task = thread_load_tasks.getptr(local_path);
+			if (!load_task) { //may have been erased during unlock and this was always an invalid call
+				thread_load_mutex.unlock();
+				if (r_error) {
+					*r_error = ERR_INVALID_PARAMETER;
+				}
+				return Ref<Resource>();
 			}
-			return Ref<Resource>();
 		}
 	}
 
-	Ref<Resource> resource = load_task.resource;
+	Ref<Resource> resource = load_task->resource;
 	if (r_error) {
-		*r_error = load_task.error;
+		*r_error = load_task->error;
 	}
 
-	load_task.requests--;
+	load_task->requests--;
 
-	if (load_task.requests == 0) {
-		if (load_task.thread) { //thread may not have been used
-			load_task.thread->wait_to_finish();
-			memdelete(load_task.thread);
+	if (load_task->requests == 0) {
+		if (load_task->semaphore) {
+			memdelete(load_task->semaphore);
+		}
+		if (load_task->task_id != WorkerThreadPool::INVALID_TASK_ID) {
+			pool_tasks.push_back(load_task->task_id);
 		}
 		thread_load_tasks.erase(local_path);
+		_reap_pool_tasks();
 	}
 
-	thread_load_mutex->unlock();
+	thread_load_mutex.unlock();
 
 	return resource;
 }
@@ -520,52 +535,55 @@ Ref<Resource> ResourceLoader::load(const String &p_path, const String &p_type_hi
 	String local_path = _validate_local_path(p_path);
 
 	if (p_cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE) {
-		thread_load_mutex->lock();
+		ThreadLoadTask new_task;
 
-		//Is it already being loaded? poll until done
-		if (thread_load_tasks.has(local_path)) {
-			Error err = load_threaded_request(p_path, p_type_hint);
-			if (err != OK) {
-				if (r_error) {
-					*r_error = err;
-				}
-				thread_load_mutex->unlock();
-				return Ref<Resource>();
-			}
-			thread_load_mutex->unlock();
+		// Checked twice, as remapping the path is done without holding the lock.
+		for (int i = 0; i < 2; i++) {
+			thread_load_mutex.lock();
 
-			return load_threaded_get(p_path, r_error);
-		}
+			//Is it already being loaded? poll until done
+			ThreadLoadTask *load_task = thread_load_tasks.getptr(local_path);
+			if (load_task) {
+				load_task->requests++;
+				thread_load_mutex.unlock();
 
-		//Is it cached?
+				return load_threaded_get(p_path, r_error);
+			}
 
-		Ref<Resource> existing = ResourceCache::get_ref(local_path);
+			//Is it cached?
+			Ref<Resource> existing = ResourceCache::get_ref(local_path);
 
-		if (existing.is_valid()) {
-			thread_load_mutex->unlock();
+			if (existing.is_valid()) {
+				thread_load_mutex.unlock();
 
-			if (r_error) {
-				*r_error = OK;
+				if (r_error) {
+					*r_error = OK;
+				}
+
+				return existing; //use cached
 			}
 
-			return existing; //use cached
+			if (i == 0) {
+				thread_load_mutex.unlock();
+
+				new_task.remapped_path = _path_remap(local_path, &new_task.xl_remapped);
+			}
 		}
 
 		//load using task (but this thread)
-		ThreadLoadTask load_task;
-
-		load_task.requests = 1;
-		load_task.local_path = local_path;
-		load_task.remapped_path = _path_remap(local_path, &load_task.xl_remapped);
-		load_task.type_hint = p_type_hint;
-		load_task.cache_mode = p_cache_mode; //ignore
-		load_task.loader_id = Thread::get_caller_id();
+		new_task.requests = 1;
+		new_task.local_path = local_path;
+		new_task.type_hint = p_type_hint;
+		new_task.source_path = current_load_task ? current_load_task->local_path : String();
+		new_task.cache_mode = p_cache_mode; //ignore
+		new_task.loader_id = Thread::get_caller_id();
+		new_task.request_usec = OS::get_singleton()->get_ticks_usec();
 
-		thread_load_tasks[local_path] = load_task;
+		ThreadLoadTask *load_task = &thread_load_tasks.insert(local_path, new_task)->value;
 
-		thread_load_mutex->unlock();
+		thread_load_mutex.unlock();
 
-		_thread_load_function(&thread_load_tasks[local_path]);
+		_run_load_task(*load_task);
 
 		return load_threaded_get(p_path, r_error);
 
@@ -944,32 +962,72 @@ void ResourceLoader::clear_translation_remaps() {
 }
 
 void ResourceLoader::clear_thread_load_tasks() {
-	thread_load_mutex->lock();
+	thread_load_mutex.lock();
+
+	// Let the loads already running end, as they write into their tasks.
+	while (true) {
+		ThreadLoadTask *running_task = nullptr;
+		for (KeyValue<String, ResourceLoader::ThreadLoadTask> &E : thread_load_tasks) {
+			if (E.value.status == THREAD_LOAD_IN_PROGRESS && E.value.loader_id != 0) {
+				running_task = &E.value;
+				break;
+			}
+		}
+		if (!running_task) {
+			break;
+		}
 
-	for (KeyValue<String, ResourceLoader::ThreadLoadTask> &E : thread_load_tasks) {
-		switch (E.value.status) {
-			case ResourceLoader::ThreadLoadStatus::THREAD_LOAD_LOADED: {
-				E.value.resource = Ref<Resource>();
-			} break;
-
-			case ResourceLoader::ThreadLoadStatus::THREAD_LOAD_IN_PROGRESS: {
-				if (E.value.thread != nullptr) {
-					E.value.thread->wait_to_finish();
-					memdelete(E.value.thread);
-					E.value.thread = nullptr;
-				}
-				E.value.resource = Ref<Resource>();
-			} break;
+		if (!running_task->semaphore) {
+			running_task->semaphore = memnew(Semaphore);
+		}
+		running_task->waiters++;
+		Semaphore *semaphore = running_task->semaphore;
 
-			case ResourceLoader::ThreadLoadStatus::THREAD_LOAD_FAILED:
-			default: {
-				// do nothing
-			}
+		thread_load_mutex.unlock();
+		semaphore->wait();
+		thread_load_mutex.lock();
+	}
+
+	// Queued loads find their task gone and return right away.
+	LocalVector<WorkerThreadPool::TaskID> tasks_to_wait = pool_tasks;
+	pool_tasks.clear();
+	for (KeyValue<String, ResourceLoader::ThreadLoadTask> &E : thread_load_tasks) {
+		if (E.value.task_id != WorkerThreadPool::INVALID_TASK_ID) {
+			tasks_to_wait.push_back(E.value.task_id);
+		}
+		if (E.value.semaphore) {
+			memdelete(E.value.semaphore);
 		}
 	}
 	thread_load_tasks.clear();
 
-	thread_load_mutex->unlock();
+	thread_load_mutex.unlock();
+
+	for (const WorkerThreadPool::TaskID &task_id : tasks_to_wait) {
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(task_id);
+	}
+}
+
+void ResourceLoader::set_load_tracing_enabled(bool p_enabled) {
+	MutexLock lock(thread_load_mutex);
+	load_tracing = p_enabled;
+}
+
+bool ResourceLoader::is_load_tracing_enabled() {
+	MutexLock lock(thread_load_mutex);
+	return load_tracing;
+}
+
+void ResourceLoader::get_load_trace(List<LoadTrace> *r_trace) {
+	MutexLock lock(thread_load_mutex);
+	for (const LoadTrace &E : load_trace) {
+		r_trace->push_back(E);
+	}
+}
+
+void ResourceLoader::clear_load_trace() {
+	MutexLock lock(thread_load_mutex);
+	load_trace.clear();
 }
 
 void ResourceLoader::load_path_remaps() {
@@ -1035,6 +1093,14 @@ void ResourceLoader::set_create_missing_resources_if_class_unavailable(bool p_en
 	create_missing_resources_if_class_unavailable = p_enable;
 }
 
+void ResourceLoader::set_sub_resource_deduplication_enabled(bool p_enabled) {
+	ERR_FAIL_COND_MSG(p_enabled && Engine::get_singleton()->is_editor_hint(), "Sub-resources can't be shared in the editor, they would be saved to the wrong files.");
+	deduplicate_sub_resources = p_enabled;
+	if (!p_enabled) {
+		ResourceCache::clear_deduplication();
+	}
+}
+
 void ResourceLoader::add_custom_loaders() {
 	// Custom loaders registration exploits global class names
 
@@ -1066,19 +1132,9 @@ void ResourceLoader::remove_custom_loaders() {
 	}
 }
 
-void ResourceLoader::initialize() {
-	thread_load_mutex = memnew(Mutex);
-	thread_load_max = OS::get_singleton()->get_processor_count();
-	thread_loading_count = 0;
-	thread_waiting_count = 0;
-	thread_suspended_count = 0;
-	thread_load_semaphore = memnew(Semaphore);
-}
+void ResourceLoader::initialize() {}
 
-void ResourceLoader::finalize() {
-	memdelete(thread_load_mutex);
-	memdelete(thread_load_semaphore);
-}
+void ResourceLoader::finalize() {}
 
 ResourceLoadErrorNotify ResourceLoader::err_notify = nullptr;
 void *ResourceLoader::err_notify_ud = nullptr;
@@ -1087,17 +1143,17 @@ DependencyErrorNotify ResourceLoader::dep_err_notify = nullptr;
 void *ResourceLoader::dep_err_notify_ud = nullptr;
 
 bool ResourceLoader::create_missing_resources_if_class_unavailable = false;
+bool ResourceLoader::deduplicate_sub_resources = false;
 bool ResourceLoader::abort_on_missing_resource = true;
 bool ResourceLoader::timestamp_on_load = false;
 
-Mutex *ResourceLoader::thread_load_mutex = nullptr;
+BinaryMutex ResourceLoader::thread_load_mutex;
 HashMap<String, ResourceLoader::ThreadLoadTask> ResourceLoader::thread_load_tasks;
-Semaphore *ResourceLoader::thread_load_semaphore = nullptr;
+LocalVector<WorkerThreadPool::TaskID> ResourceLoader::pool_tasks;
+thread_local ResourceLoader::ThreadLoadTask *ResourceLoader::current_load_task = nullptr;
 
-int ResourceLoader::thread_loading_count = 0;
-int ResourceLoader::thread_waiting_count = 0;
-int ResourceLoader::thread_suspended_count = 0;
-int ResourceLoader::thread_load_max = 0;
+bool ResourceLoader::load_tracing = false;
+LocalVector<ResourceLoader::LoadTrace> ResourceLoader::load_trace;
 
 SelfList<Resource>::List ResourceLoader::remapped_list;
 HashMap<String, Vector<String>> ResourceLoader::translation_remaps;
@@ -34,6 +34,7 @@
 #include "core/io/resource.h"
 #include "core/object/gdvirtual.gen.inc"
 #include "core/object/script_language.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/os/semaphore.h"
 #include "core/os/thread.h"
 
@@ -116,6 +117,7 @@ private:
 	static DependencyErrorNotify dep_err_notify;
 	static bool abort_on_missing_resource;
 	static bool create_missing_resources_if_class_unavailable;
+	static bool deduplicate_sub_resources;
 	static HashMap<String, Vector<String>> translation_remaps;
 	static HashMap<String, String> path_remaps;
 
@@ -134,12 +136,14 @@ private:
 	static Ref<ResourceFormatLoader> _find_custom_resource_format_loader(String path);
 
 	struct ThreadLoadTask {
-		Thread *thread = nullptr;
-		Thread::ID loader_id = 0;
-		Semaphore *semaphore = nullptr;
+		WorkerThreadPool::TaskID task_id = WorkerThreadPool::INVALID_TASK_ID; // Only set for threaded requests.
+		Thread::ID loader_id = 0; // Thread running the load, 0 while it is still queued.
+		Semaphore *semaphore = nullptr; // Created by the first thread that has to wait for the load to end.
+		int waiters = 0;
 		String local_path;
 		String remapped_path;
 		String type_hint;
+		String source_path;
 		float progress = 0.0;
 		ThreadLoadStatus status = THREAD_LOAD_IN_PROGRESS;
 		ResourceFormatLoader::CacheMode cache_mode = ResourceFormatLoader::CACHE_MODE_REUSE;
@@ -147,20 +151,35 @@ private:
 		Ref<Resource> resource;
 		bool xl_remapped = false;
 		bool use_sub_threads = false;
-		bool start_next = true;
 		int requests = 0;
-		int poll_requests = 0;
 		HashSet<String> sub_tasks;
+		uint64_t request_usec = 0;
+		uint64_t start_usec = 0;
 	};
 
+public:
+	struct LoadTrace {
+		String path;
+		String type;
+		String source_path; // Resource that requested this one, empty for top-level loads.
+		Thread::ID thread_id = 0;
+		uint64_t request_usec = 0;
+		uint64_t start_usec = 0;
+		uint64_t end_usec = 0;
+		Error error = OK;
+	};
+
+private:
 	static void _thread_load_function(void *p_userdata);
-	static Mutex *thread_load_mutex;
+	static void _run_load_task(ThreadLoadTask &p_load_task);
+	static void _reap_pool_tasks();
+	static BinaryMutex thread_load_mutex;
 	static HashMap<String, ThreadLoadTask> thread_load_tasks;
-	static Semaphore *thread_load_semaphore;
-	static int thread_waiting_count;
-	static int thread_loading_count;
-	static int thread_suspended_count;
-	static int thread_load_max;
+	static LocalVector<WorkerThreadPool::TaskID> pool_tasks;
+	static thread_local ThreadLoadTask *current_load_task;
+
+	static bool load_tracing;
+	static LocalVector<LoadTrace> load_trace;
 
 	static float _dependency_get_progress(const String &p_path);
 
@@ -224,6 +243,11 @@ public:
 
 	static void clear_thread_load_tasks();
 
+	static void set_load_tracing_enabled(bool p_enabled);
+	static bool is_load_tracing_enabled();
+	static void get_load_trace(List<LoadTrace> *r_trace);
+	static void clear_load_trace();
+
 	static void set_load_callback(ResourceLoadedCallback p_callback);
 	static ResourceLoaderImport import;
 
@@ -234,6 +258,9 @@ public:
 	static void set_create_missing_resources_if_class_unavailable(bool p_enable);
 	_FORCE_INLINE_ static bool is_creating_missing_resources_if_class_unavailable_enabled() { return create_missing_resources_if_class_unavailable; }
 
+	static void set_sub_resource_deduplication_enabled(bool p_enabled);
+	_FORCE_INLINE_ static bool is_sub_resource_deduplication_enabled() { return deduplicate_sub_resources; }
+
 	static void initialize();
 	static void finalize();
 };
@@ -212,13 +212,13 @@ void StreamPeer::put_utf8_string(const String &p_string) {
 	put_data((const uint8_t *)cs.get_data(), cs.length());
 }
 
-void StreamPeer::put_var(const Variant &p_variant, bool p_full_objects) {
+void StreamPeer::put_var(const Variant &p_variant, bool p_full_objects, bool p_bulk_containers) {
 	int len = 0;
 	Vector<uint8_t> buf;
-	encode_variant(p_variant, nullptr, len, p_full_objects);
+	encode_variant(p_variant, nullptr, len, p_full_objects, p_bulk_containers);
 	buf.resize(len);
 	put_32(len);
-	encode_variant(p_variant, buf.ptrw(), len, p_full_objects);
+	encode_variant(p_variant, buf.ptrw(), len, p_full_objects, p_bulk_containers);
 	put_data(buf.ptr(), buf.size());
 }
 
@@ -389,7 +389,7 @@ void StreamPeer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("put_double", "value"), &StreamPeer::put_double);
 	ClassDB::bind_method(D_METHOD("put_string", "value"), &StreamPeer::put_string);
 	ClassDB::bind_method(D_METHOD("put_utf8_string", "value"), &StreamPeer::put_utf8_string);
-	ClassDB::bind_method(D_METHOD("put_var", "value", "full_objects"), &StreamPeer::put_var, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("put_var", "value", "full_objects", "bulk_containers"), &StreamPeer::put_var, DEFVAL(false), DEFVAL(false));
 
 	ClassDB::bind_method(D_METHOD("get_8"), &StreamPeer::get_8);
 	ClassDB::bind_method(D_METHOD("get_u8"), &StreamPeer::get_u8);
@@ -78,7 +78,7 @@ public:
 	void put_double(double p_val);
 	void put_string(const String &p_string);
 	void put_utf8_string(const String &p_string);
-	void put_var(const Variant &p_variant, bool p_full_objects = false);
+	void put_var(const Variant &p_variant, bool p_full_objects = false, bool p_bulk_containers = false);
 
 	uint8_t get_u8();
 	int8_t get_8();
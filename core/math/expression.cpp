@@ -1425,7 +1425,7 @@ bool Expression::_execute(const Array &p_inputs, Object *p_instance, Expression:
 
 		} break;
 		case Expression::ENode::TYPE_CALL: {
-			const Expression::CallNode *call = static_cast<const Expression::CallNode *>(p_node);
+			Expression::CallNode *call = static_cast<Expression::CallNode *>(p_node);
 
 			Variant base;
 			bool ret = _execute(p_inputs, p_instance, call->base, base, p_const_calls_only, r_error_str);
@@ -1451,7 +1451,19 @@ bool Expression::_execute(const Array &p_inputs, Object *p_instance, Expression:
 			}
 
 			Callable::CallError ce;
-			if (p_const_calls_only) {
+			if (base.get_type() != Variant::OBJECT) {
+				uint64_t cached_method = call->cached_method.get();
+				if ((cached_method >> 32) != uint64_t(base.get_type())) {
+					cached_method = (uint64_t(base.get_type()) << 32) | uint32_t(Variant::get_builtin_method_id(base.get_type(), call->method));
+					call->cached_method.set(cached_method);
+				}
+				int method_id = int32_t(uint32_t(cached_method));
+				if (p_const_calls_only) {
+					base.call_builtin_const(method_id, (const Variant **)argp.ptr(), argp.size(), r_ret, ce);
+				} else {
+					base.call_builtin(method_id, (const Variant **)argp.ptr(), argp.size(), r_ret, ce);
+				}
+			} else if (p_const_calls_only) {
 				base.call_const(call->method, (const Variant **)argp.ptr(), argp.size(), r_ret, ce);
 			} else {
 				base.callp(call->method, (const Variant **)argp.ptr(), argp.size(), r_ret, ce);
@@ -216,6 +216,11 @@ private:
 		StringName method;
 		Vector<ENode *> arguments;
 
+		// Built-in method resolved on the last call, reused while the base type stays the same.
+		// The base type is stored in the high 32 bits and the method ID in the low ones, so that both
+		// are read and written together when execute() is called from several threads.
+		SafeNumeric<uint64_t> cached_method{ uint64_t(Variant::VARIANT_MAX) << 32 };
+
 		CallNode() {
 			type = TYPE_CALL;
 		}
@@ -34,23 +34,217 @@
 #include "core/core_string_names.h"
 #include "core/object/class_db.h"
 #include "core/object/script_language.h"
+#include "core/os/os.h"
 
 MessageQueue *MessageQueue::singleton = nullptr;
+thread_local MessageQueue::ThreadBufferRef MessageQueue::thread_buffer_ref;
+uint64_t MessageQueue::last_instance_id = 0;
+
+static constexpr uint32_t PAGE_HEADER_SIZE = (sizeof(std::atomic<void *>) + sizeof(std::atomic<uint32_t>) + sizeof(uint32_t) * 2 + 15) & ~15;
 
 MessageQueue *MessageQueue::get_singleton() {
 	return singleton;
 }
 
+MessageQueue::ThreadBufferRef::~ThreadBufferRef() {
+	// The thread is exiting; let the next flush free its buffer once drained.
+	if (buffer && singleton && singleton->instance_id == queue_id) {
+		buffer->abandoned.store(true, std::memory_order_release);
+	}
+}
+
+static _FORCE_INLINE_ uint8_t *_get_page_data(void *p_page) {
+	return reinterpret_cast<uint8_t *>(p_page) + PAGE_HEADER_SIZE;
+}
+
+MessageQueue::ThreadBuffer *MessageQueue::_get_thread_buffer() {
+	ThreadBufferRef &ref = thread_buffer_ref;
+	if (likely(ref.queue_id == instance_id)) {
+		return ref.buffer;
+	}
+
+	// First message pushed from this thread, register a buffer for it.
+	ThreadBuffer *buffer = memnew(ThreadBuffer);
+	buffer->write_page = _alloc_page(buffer, 0);
+	buffer->read_page = buffer->write_page;
+
+	{
+		MutexLock lock(mutex);
+		buffer->next = thread_buffers.load(std::memory_order_relaxed);
+		thread_buffers.store(buffer, std::memory_order_release);
+	}
+
+	ref.buffer = buffer;
+	ref.queue_id = instance_id;
+	return buffer;
+}
+
+MessageQueue::Page *MessageQueue::_alloc_page(ThreadBuffer *p_buffer, uint32_t p_room_needed) {
+	uint32_t size = MAX(page_size, p_room_needed);
+
+	Page *page = p_buffer->spare_page.exchange(nullptr, std::memory_order_acquire);
+	if (page && page->size < size) {
+		page->~Page();
+		memfree(page);
+		page = nullptr;
+	}
+
+	if (page) {
+		page->next.store(nullptr, std::memory_order_relaxed);
+		page->committed.store(0, std::memory_order_relaxed);
+		page->read_pos = 0;
+	} else {
+		static_assert(sizeof(Page) <= PAGE_HEADER_SIZE, "Page header does not fit in PAGE_HEADER_SIZE.");
+		page = memnew_placement(memalloc(PAGE_HEADER_SIZE + size), Page);
+		page->size = size;
+	}
+
+	return page;
+}
+
+void MessageQueue::_free_page(ThreadBuffer *p_buffer, Page *p_page) {
+	// Keep one drained page around so the writer doesn't allocate in steady state.
+	Page *old = p_buffer->spare_page.exchange(p_page, std::memory_order_acq_rel);
+	if (old) {
+		old->~Page();
+		memfree(old);
+	}
+}
+
+MessageQueue::Message *MessageQueue::_alloc_message(ThreadBuffer *p_buffer, uint32_t p_room_needed) {
+	Page *page = p_buffer->write_page;
+	uint32_t pos = page->committed.load(std::memory_order_relaxed);
+
+	if (pos + p_room_needed > page->size) {
+		Page *new_page = _alloc_page(p_buffer, p_room_needed);
+		// Everything written to the old page was committed before the reader can see the new one.
+		page->next.store(new_page, std::memory_order_release);
+		p_buffer->write_page = new_page;
+		page = new_page;
+		pos = 0;
+	}
+
+	Message *msg = memnew_placement(_get_page_data(page) + pos, Message);
+	msg->order = next_order.fetch_add(1, std::memory_order_relaxed);
+	return msg;
+}
+
+bool MessageQueue::_reserve_room(uint32_t p_room_needed) {
+	// Like the old fixed-size buffer, space is only given back once a flush ends, so calls
+	// that keep re-queuing themselves fail here instead of growing the queue forever.
+	uint64_t queued = queued_bytes.fetch_add(p_room_needed, std::memory_order_relaxed) + p_room_needed;
+	if (unlikely(queued > max_size)) {
+		queued_bytes.fetch_sub(p_room_needed, std::memory_order_relaxed);
+		return false;
+	}
+	return true;
+}
+
+void MessageQueue::_commit_message(ThreadBuffer *p_buffer, uint32_t p_room_needed) {
+	Page *page = p_buffer->write_page;
+	page->committed.store(page->committed.load(std::memory_order_relaxed) + p_room_needed, std::memory_order_release);
+
+	p_buffer->pushed_messages.store(p_buffer->pushed_messages.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+MessageQueue::Message *MessageQueue::_peek_message(ThreadBuffer *p_buffer) {
+	Page *page = p_buffer->read_page;
+
+	while (true) {
+		if (page->read_pos < page->committed.load(std::memory_order_acquire)) {
+			return reinterpret_cast<Message *>(_get_page_data(page) + page->read_pos);
+		}
+
+		Page *next = page->next.load(std::memory_order_acquire);
+		if (!next) {
+			return nullptr;
+		}
+
+		// The writer moved on to the next page, so `committed` is final now.
+		if (page->read_pos < page->committed.load(std::memory_order_acquire)) {
+			continue;
+		}
+
+		p_buffer->read_page = next;
+		_free_page(p_buffer, page);
+		page = next;
+	}
+}
+
+MessageQueue::Message *MessageQueue::_pop_message(ThreadBuffer *&r_buffer, uint32_t &r_size) {
+	// Each thread's messages are in order already, merge them by the order they were pushed in.
+	Message *best = nullptr;
+	r_buffer = nullptr;
+
+	for (ThreadBuffer *buffer = thread_buffers.load(std::memory_order_acquire); buffer; buffer = buffer->next) {
+		Message *msg = _peek_message(buffer);
+		if (msg && (!best || msg->order < best->order)) {
+			best = msg;
+			r_buffer = buffer;
+		}
+	}
+
+	if (best) {
+		r_size = _get_message_size(best);
+		r_buffer->read_page->read_pos += r_size;
+	}
+
+	return best;
+}
+
+void MessageQueue::_release_abandoned_buffers() {
+	MutexLock lock(mutex);
+
+	ThreadBuffer *prev = nullptr;
+	ThreadBuffer *buffer = thread_buffers.load(std::memory_order_relaxed);
+	while (buffer) {
+		ThreadBuffer *next = buffer->next;
+
+		if (buffer->abandoned.load(std::memory_order_acquire) && !_peek_message(buffer)) {
+			if (prev) {
+				prev->next = next;
+			} else {
+				thread_buffers.store(next, std::memory_order_release);
+			}
+
+			_free_page(buffer, buffer->read_page);
+			_free_page(buffer, nullptr);
+			memdelete(buffer);
+		} else {
+			prev = buffer;
+		}
+
+		buffer = next;
+	}
+}
+
+uint32_t MessageQueue::_get_message_size(const Message *p_message) {
+	uint32_t size = sizeof(Message);
+	if ((p_message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+		size += sizeof(Variant) * p_message->args;
+	}
+	return size;
+}
+
+void MessageQueue::_destroy_message(Message *p_message) {
+	if ((p_message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+		Variant *args = (Variant *)(p_message + 1);
+		for (int i = 0; i < p_message->args; i++) {
+			args[i].~Variant();
+		}
+	}
+
+	p_message->~Message();
+}
+
 Error MessageQueue::push_callp(ObjectID p_id, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error) {
 	return push_callablep(Callable(p_id, p_method), p_args, p_argcount, p_show_error);
 }
 
 Error MessageQueue::push_set(ObjectID p_id, const StringName &p_prop, const Variant &p_value) {
-	_THREAD_SAFE_METHOD_
+	uint32_t room_needed = sizeof(Message) + sizeof(Variant);
 
-	uint8_t room_needed = sizeof(Message) + sizeof(Variant);
-
-	if ((buffer_end + room_needed) >= buffer_size) {
+	if (!_reserve_room(room_needed)) {
 		String type;
 		if (ObjectDB::get_instance(p_id)) {
 			type = ObjectDB::get_instance(p_id)->get_class();
@@ -60,41 +254,40 @@ Error MessageQueue::push_set(ObjectID p_id, const StringName &p_prop, const Vari
 		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
 	}
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	ThreadBuffer *buffer = _get_thread_buffer();
+	Message *msg = _alloc_message(buffer, room_needed);
 	msg->args = 1;
 	msg->callable = Callable(p_id, p_prop);
 	msg->type = TYPE_SET;
 
-	buffer_end += sizeof(Message);
-
-	Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-	buffer_end += sizeof(Variant);
+	Variant *v = memnew_placement(msg + 1, Variant);
 	*v = p_value;
 
+	_commit_message(buffer, room_needed);
+
 	return OK;
 }
 
 Error MessageQueue::push_notification(ObjectID p_id, int p_notification) {
-	_THREAD_SAFE_METHOD_
-
 	ERR_FAIL_COND_V(p_notification < 0, ERR_INVALID_PARAMETER);
 
-	uint8_t room_needed = sizeof(Message);
+	uint32_t room_needed = sizeof(Message);
 
-	if ((buffer_end + room_needed) >= buffer_size) {
+	if (!_reserve_room(room_needed)) {
 		print_line("Failed notification: " + itos(p_notification) + " target ID: " + itos(p_id));
 		statistics();
 		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
 	}
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	ThreadBuffer *buffer = _get_thread_buffer();
+	Message *msg = _alloc_message(buffer, room_needed);
 
 	msg->type = TYPE_NOTIFICATION;
 	msg->callable = Callable(p_id, CoreStringNames::get_singleton()->notification); //name is meaningless but callable needs it
 	//msg->target;
 	msg->notification = p_notification;
 
-	buffer_end += sizeof(Message);
+	_commit_message(buffer, room_needed);
 
 	return OK;
 }
@@ -112,17 +305,16 @@ Error MessageQueue::push_set(Object *p_object, const StringName &p_prop, const V
 }
 
 Error MessageQueue::push_callablep(const Callable &p_callable, const Variant **p_args, int p_argcount, bool p_show_error) {
-	_THREAD_SAFE_METHOD_
+	uint32_t room_needed = sizeof(Message) + sizeof(Variant) * p_argcount;
 
-	int room_needed = sizeof(Message) + sizeof(Variant) * p_argcount;
-
-	if ((buffer_end + room_needed) >= buffer_size) {
+	if (!_reserve_room(room_needed)) {
 		print_line("Failed method: " + p_callable);
 		statistics();
 		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
 	}
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	ThreadBuffer *buffer = _get_thread_buffer();
+	Message *msg = _alloc_message(buffer, room_needed);
 	msg->args = p_argcount;
 	msg->callable = p_callable;
 	msg->type = TYPE_CALL;
@@ -130,14 +322,14 @@ Error MessageQueue::push_callablep(const Callable &p_callable, const Variant **p
 		msg->type |= FLAG_SHOW_ERROR;
 	}
 
-	buffer_end += sizeof(Message);
-
+	Variant *args = (Variant *)(msg + 1);
 	for (int i = 0; i < p_argcount; i++) {
-		Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-		buffer_end += sizeof(Variant);
+		Variant *v = memnew_placement(&args[i], Variant);
 		*v = *p_args[i];
 	}
 
+	_commit_message(buffer, room_needed);
+
 	return OK;
 }
 
@@ -146,56 +338,82 @@ void MessageQueue::statistics() {
 	HashMap<int, int> notify_count;
 	HashMap<Callable, int> call_count;
 	int null_count = 0;
+	uint64_t total_bytes = 0;
+
+	// Pages are only read and freed by the flushing thread, so only walk them from there.
+	bool claimed = false;
+	bool can_walk = false;
+	{
+		MutexLock lock(mutex);
+		if (!flushing) {
+			flushing = true;
+			flush_thread = Thread::get_caller_id();
+			claimed = true;
+		}
+		can_walk = flush_thread == Thread::get_caller_id();
+	}
 
-	uint32_t read_pos = 0;
-	while (read_pos < buffer_end) {
-		Message *message = (Message *)&buffer[read_pos];
+	if (can_walk) {
+		for (ThreadBuffer *buffer = thread_buffers.load(std::memory_order_acquire); buffer; buffer = buffer->next) {
+			for (Page *page = buffer->read_page; page; page = page->next.load(std::memory_order_acquire)) {
+				uint32_t read_pos = page->read_pos;
+				uint32_t committed = page->committed.load(std::memory_order_acquire);
+				while (read_pos < committed) {
+					Message *message = (Message *)(_get_page_data(page) + read_pos);
 
-		Object *target = message->callable.get_object();
+					Object *target = message->callable.get_object();
 
-		if (target != nullptr) {
-			switch (message->type & FLAG_MASK) {
-				case TYPE_CALL: {
-					if (!call_count.has(message->callable)) {
-						call_count[message->callable] = 0;
-					}
+					if (target != nullptr) {
+						switch (message->type & FLAG_MASK) {
+							case TYPE_CALL: {
+								if (!call_count.has(message->callable)) {
+									call_count[message->callable] = 0;
+								}
 
-					call_count[message->callable]++;
+								call_count[message->callable]++;
 
-				} break;
-				case TYPE_NOTIFICATION: {
-					if (!notify_count.has(message->notification)) {
-						notify_count[message->notification] = 0;
-					}
+							} break;
+							case TYPE_NOTIFICATION: {
+								if (!notify_count.has(message->notification)) {
+									notify_count[message->notification] = 0;
+								}
 
-					notify_count[message->notification]++;
+								notify_count[message->notification]++;
 
-				} break;
-				case TYPE_SET: {
-					StringName t = message->callable.get_method();
-					if (!set_count.has(t)) {
-						set_count[t] = 0;
-					}
+							} break;
+							case TYPE_SET: {
+								StringName t = message->callable.get_method();
+								if (!set_count.has(t)) {
+									set_count[t] = 0;
+								}
 
-					set_count[t]++;
+								set_count[t]++;
 
-				} break;
-			}
+							} break;
+						}
 
-		} else {
-			//object was deleted
-			print_line("Object was deleted while awaiting a callback");
+					} else {
+						//object was deleted
+						null_count++;
+					}
 
-			null_count++;
+					uint32_t size = _get_message_size(message);
+					read_pos += size;
+					total_bytes += size;
+				}
+			}
 		}
+	} else {
+		total_bytes = queued_bytes.load(std::memory_order_relaxed);
+		print_line("Message queue is being flushed by another thread, message counts are not available.");
+	}
 
-		read_pos += sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			read_pos += sizeof(Variant) * message->args;
-		}
+	if (claimed) {
+		MutexLock lock(mutex);
+		flushing = false;
 	}
 
-	print_line("TOTAL BYTES: " + itos(buffer_end));
+	print_line("TOTAL BYTES: " + itos(total_bytes));
 	print_line("NULL count: " + itos(null_count));
 
 	for (const KeyValue<StringName, int> &E : set_count) {
@@ -215,6 +433,32 @@ int MessageQueue::get_max_buffer_usage() const {
 	return buffer_max_used;
 }
 
+uint32_t MessageQueue::get_queue_depth() const {
+	uint64_t depth = 0;
+	MutexLock lock(mutex);
+	for (ThreadBuffer *buffer = thread_buffers.load(std::memory_order_acquire); buffer; buffer = buffer->next) {
+		depth += buffer->pushed_messages.load(std::memory_order_relaxed) - buffer->flushed_messages.load(std::memory_order_relaxed);
+	}
+	return depth;
+}
+
+uint32_t MessageQueue::get_thread_buffer_count() const {
+	uint32_t count = 0;
+	MutexLock lock(mutex);
+	for (ThreadBuffer *buffer = thread_buffers.load(std::memory_order_acquire); buffer; buffer = buffer->next) {
+		count++;
+	}
+	return count;
+}
+
+uint32_t MessageQueue::get_last_flush_message_count() const {
+	return last_flush_message_count;
+}
+
+uint64_t MessageQueue::get_last_flush_usec() const {
+	return last_flush_usec;
+}
+
 void MessageQueue::_call_function(const Callable &p_callable, const Variant *p_args, int p_argcount, bool p_show_error) {
 	const Variant **argptrs = nullptr;
 	if (p_argcount) {
@@ -233,36 +477,28 @@ void MessageQueue::_call_function(const Callable &p_callable, const Variant *p_a
 }
 
 void MessageQueue::flush() {
-	if (buffer_end > buffer_max_used) {
-		buffer_max_used = buffer_end;
-	}
-
-	uint32_t read_pos = 0;
-
-	//using reverse locking strategy
-	_THREAD_SAFE_LOCK_
-
-	if (flushing) {
-		_THREAD_SAFE_UNLOCK_
+	{
+		MutexLock lock(mutex);
 		ERR_FAIL_COND(flushing); //already flushing, you did something odd
+		flushing = true;
+		flush_thread = Thread::get_caller_id();
 	}
-	flushing = true;
 
-	while (read_pos < buffer_end) {
-		//lock on each iteration, so a call can re-add itself to the message queue
+	uint64_t begin_usec = OS::get_singleton()->get_ticks_usec();
 
-		Message *message = (Message *)&buffer[read_pos];
+	uint32_t message_count = 0;
+	uint64_t flushed_bytes = 0;
 
-		uint32_t advance = sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			advance += sizeof(Variant) * message->args;
+	while (true) {
+		// Messages pushed while flushing, including from the calls below, are processed too.
+		// Their space is only given back at the end, which bounds how much one flush can run.
+		ThreadBuffer *buffer = nullptr;
+		uint32_t size = 0;
+		Message *message = _pop_message(buffer, size);
+		if (!message) {
+			break;
 		}
 
-		//pre-advance so this function is reentrant
-		read_pos += advance;
-
-		_THREAD_SAFE_UNLOCK_
-
 		Object *target = message->callable.get_object();
 
 		if (target != nullptr) {
@@ -289,21 +525,25 @@ void MessageQueue::flush() {
 			}
 		}
 
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			Variant *args = (Variant *)(message + 1);
-			for (int i = 0; i < message->args; i++) {
-				args[i].~Variant();
-			}
-		}
+		_destroy_message(message);
 
-		message->~Message();
+		buffer->flushed_messages.store(buffer->flushed_messages.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		flushed_bytes += size;
+		message_count++;
+	}
 
-		_THREAD_SAFE_LOCK_
+	uint64_t used_bytes = queued_bytes.fetch_sub(flushed_bytes, std::memory_order_relaxed);
+	if (used_bytes > buffer_max_used) {
+		buffer_max_used = used_bytes;
 	}
 
-	buffer_end = 0; // reset buffer
+	_release_abandoned_buffers();
+
+	last_flush_message_count = message_count;
+	last_flush_usec = OS::get_singleton()->get_ticks_usec() - begin_usec;
+
+	MutexLock lock(mutex);
 	flushing = false;
-	_THREAD_SAFE_UNLOCK_
 }
 
 bool MessageQueue::is_flushing() const {
@@ -313,32 +553,28 @@ bool MessageQueue::is_flushing() const {
 MessageQueue::MessageQueue() {
 	ERR_FAIL_COND_MSG(singleton != nullptr, "A MessageQueue singleton already exists.");
 	singleton = this;
+	instance_id = ++last_instance_id;
 
-	buffer_size = GLOBAL_DEF_RST(PropertyInfo(Variant::INT, "memory/limits/message_queue/max_size_kb", PROPERTY_HINT_RANGE, "1024,4096,1,or_greater"), DEFAULT_QUEUE_SIZE_KB);
-	buffer_size *= 1024;
-	buffer = memnew_arr(uint8_t, buffer_size);
+	page_size = PAGE_SIZE_KB * 1024;
+	max_size = GLOBAL_DEF_RST(PropertyInfo(Variant::INT, "memory/limits/message_queue/max_size_kb", PROPERTY_HINT_RANGE, "1024,4096,1,or_greater"), DEFAULT_QUEUE_SIZE_KB);
+	max_size *= 1024;
 }
 
 MessageQueue::~MessageQueue() {
-	uint32_t read_pos = 0;
-
-	while (read_pos < buffer_end) {
-		Message *message = (Message *)&buffer[read_pos];
-		Variant *args = (Variant *)(message + 1);
-		int argc = message->args;
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			for (int i = 0; i < argc; i++) {
-				args[i].~Variant();
-			}
-		}
-		message->~Message();
+	ThreadBuffer *buffer = nullptr;
+	uint32_t size = 0;
+	while (Message *message = _pop_message(buffer, size)) {
+		_destroy_message(message);
+	}
 
-		read_pos += sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			read_pos += sizeof(Variant) * message->args;
-		}
+	buffer = thread_buffers.load(std::memory_order_acquire);
+	while (buffer) {
+		ThreadBuffer *next = buffer->next;
+		_free_page(buffer, buffer->read_page);
+		_free_page(buffer, nullptr);
+		memdelete(buffer);
+		buffer = next;
 	}
 
 	singleton = nullptr;
-	memdelete_arr(buffer);
 }
@@ -32,16 +32,19 @@
 #define MESSAGE_QUEUE_H
 
 #include "core/object/object_id.h"
+#include "core/os/mutex.h"
+#include "core/os/thread.h"
 #include "core/os/thread_safe.h"
 #include "core/variant/variant.h"
 
+#include <atomic>
+
 class Object;
 
 class MessageQueue {
-	_THREAD_SAFE_CLASS_
-
 	enum {
-		DEFAULT_QUEUE_SIZE_KB = 4096
+		DEFAULT_QUEUE_SIZE_KB = 4096,
+		PAGE_SIZE_KB = 64,
 	};
 
 	enum {
@@ -60,18 +63,69 @@ class MessageQueue {
 			int16_t notification;
 			int16_t args;
 		};
+		uint64_t order;
+	};
+
+	// Messages are written by a single thread into its own chain of pages, and
+	// read by the flushing thread. Only the owning thread writes `committed`.
+	struct Page {
+		std::atomic<Page *> next = { nullptr };
+		std::atomic<uint32_t> committed = { 0 };
+		uint32_t read_pos = 0;
+		uint32_t size = 0;
+	};
+
+	struct ThreadBuffer {
+		ThreadBuffer *next = nullptr;
+		Page *read_page = nullptr;
+		Page *write_page = nullptr;
+		std::atomic<Page *> spare_page = { nullptr };
+		std::atomic<uint64_t> pushed_messages = { 0 };
+		std::atomic<uint64_t> flushed_messages = { 0 };
+		std::atomic<bool> abandoned = { false };
+	};
+
+	struct ThreadBufferRef {
+		ThreadBuffer *buffer = nullptr;
+		uint64_t queue_id = 0;
+		~ThreadBufferRef();
 	};
 
-	uint8_t *buffer = nullptr;
-	uint32_t buffer_end = 0;
-	uint32_t buffer_max_used = 0;
-	uint32_t buffer_size = 0;
+	static thread_local ThreadBufferRef thread_buffer_ref;
+	static uint64_t last_instance_id;
+
+	std::atomic<ThreadBuffer *> thread_buffers = { nullptr };
+	std::atomic<uint64_t> next_order = { 0 };
+	// Bytes pushed since the end of the last flush, pushing fails past `max_size`.
+	std::atomic<uint64_t> queued_bytes = { 0 };
+	mutable BinaryMutex mutex; // Also keeps abandoned buffers alive while they are walked.
+
+	uint64_t instance_id = 0;
+	uint32_t page_size = 0;
+	uint64_t max_size = 0;
+
+	uint64_t buffer_max_used = 0;
+	uint32_t last_flush_message_count = 0;
+	uint64_t last_flush_usec = 0;
+
+	ThreadBuffer *_get_thread_buffer();
+	Page *_alloc_page(ThreadBuffer *p_buffer, uint32_t p_room_needed);
+	Message *_alloc_message(ThreadBuffer *p_buffer, uint32_t p_room_needed);
+	bool _reserve_room(uint32_t p_room_needed);
+	void _commit_message(ThreadBuffer *p_buffer, uint32_t p_room_needed);
+	Message *_peek_message(ThreadBuffer *p_buffer);
+	Message *_pop_message(ThreadBuffer *&r_buffer, uint32_t &r_size);
+	void _free_page(ThreadBuffer *p_buffer, Page *p_page);
+	void _release_abandoned_buffers();
+	static uint32_t _get_message_size(const Message *p_message);
+	static void _destroy_message(Message *p_message);
 
 	void _call_function(const Callable &p_callable, const Variant *p_args, int p_argcount, bool p_show_error);
 
 	static MessageQueue *singleton;
 
 	bool flushing = false;
+	Thread::ID flush_thread = 0;
 
 public:
 	static MessageQueue *get_singleton();
@@ -121,6 +175,10 @@ public:
 	bool is_flushing() const;
 
 	int get_max_buffer_usage() const;
+	uint32_t get_queue_depth() const;
+	uint32_t get_thread_buffer_count() const;
+	uint32_t get_last_flush_message_count() const;
+	uint64_t get_last_flush_usec() const;
 
 	MessageQueue();
 	~MessageQueue();
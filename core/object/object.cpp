@@ -1014,19 +1014,23 @@ Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int
 
 	List<_ObjectSignalDisconnectData> disconnect_data;
 
-	//copy on write will ensure that disconnecting the signal or even deleting the object will not affect the signal calling.
-	//this happens automatically and will not change the performance of calling.
-	//awesome, isn't it?
-	VMap<Callable, SignalData::Slot> slot_map = s->slot_map;
+	// Slots are not copied. If a callback connects or disconnects this signal, the slots this emission
+	// started with are kept alive through copy on write (see SignalData::prepare_modify()).
+	SignalData::Emission emission;
+	emission.prev = s->emissions;
+	s->emissions = &emission;
 
-	int ssize = slot_map.size();
+	int ssize = s->slot_map.size();
 
-	OBJ_DEBUG_LOCK
+	// Not OBJ_DEBUG_LOCK, the lock must not be released if a callback frees this object.
+#ifdef DEBUG_ENABLED
+	_lock_index.ref();
+#endif
 
 	Error err = OK;
 
 	for (int i = 0; i < ssize; i++) {
-		const Connection &c = slot_map.getv(i).conn;
+		const Connection &c = (emission.modified ? emission.slots : s->slot_map).getv(i).conn;
 
 		Object *target = c.callable.get_object();
 		if (!target) {
@@ -1041,14 +1045,18 @@ Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int
 			MessageQueue::get_singleton()->push_callablep(c.callable, args, argc, true);
 		} else {
 			Callable::CallError ce;
-			_emitting = true;
+			if (likely(!emission.aborted)) {
+				_emitting = true;
+			}
 			Variant ret;
 			c.callable.callp(args, argc, ret, ce);
-			_emitting = false;
+			if (likely(!emission.aborted)) {
+				_emitting = false;
+			}
 
 			if (ce.error != Callable::CallError::CALL_OK) {
 #ifdef DEBUG_ENABLED
-				if (c.flags & CONNECT_PERSIST && Engine::get_singleton()->is_editor_hint() && (script.is_null() || !Ref<Script>(script)->is_tool())) {
+				if (c.flags & CONNECT_PERSIST && !emission.aborted && Engine::get_singleton()->is_editor_hint() && (script.is_null() || !Ref<Script>(script)->is_tool())) {
 					continue;
 				}
 #endif
@@ -1076,6 +1084,21 @@ Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int
 		}
 	}
 
+	if (unlikely(emission.aborted)) {
+		// The remaining slots were still called, but this object and its connections are gone.
+		return err;
+	}
+
+#ifdef DEBUG_ENABLED
+	_lock_index.unref();
+#endif
+
+	// The signal data is not erased while emitting, so this is still valid.
+	s->emissions = emission.prev;
+	if (!s->emissions && s->slot_map.is_empty() && emission.modified && ClassDB::has_signal(get_class_name(), p_name)) {
+		signal_map.erase(p_name);
+	}
+
 	while (!disconnect_data.is_empty()) {
 		const _ObjectSignalDisconnectData &dd = disconnect_data.front()->get();
 
@@ -1264,6 +1287,7 @@ Error Object::connect(const StringName &p_signal, const Callable &p_callable, ui
 	//compare with the base callable, so binds can be ignored
 	if (s->slot_map.has(*target.get_base_comparator())) {
 		if (p_flags & CONNECT_REFERENCE_COUNTED) {
+			s->prepare_modify();
 			s->slot_map[*target.get_base_comparator()].reference_count++;
 			return OK;
 		} else {
@@ -1284,6 +1308,7 @@ Error Object::connect(const StringName &p_signal, const Callable &p_callable, ui
 	}
 
 	//use callable version as key, so binds can be ignored
+	s->prepare_modify();
 	s->slot_map[*target.get_base_comparator()] = slot;
 
 	return OK;
@@ -1330,6 +1355,7 @@ void Object::_disconnect(const StringName &p_signal, const Callable &p_callable,
 
 	ERR_FAIL_COND_MSG(!s->slot_map.has(*p_callable.get_base_comparator()), "Disconnecting nonexistent signal '" + p_signal + "', callable: " + p_callable + ".");
 
+	s->prepare_modify();
 	SignalData::Slot *slot = &s->slot_map[*p_callable.get_base_comparator()];
 
 	if (!p_force) {
@@ -1342,8 +1368,8 @@ void Object::_disconnect(const StringName &p_signal, const Callable &p_callable,
 	target_object->connections.erase(slot->cE);
 	s->slot_map.erase(*p_callable.get_base_comparator());
 
-	if (s->slot_map.is_empty() && ClassDB::has_signal(get_class_name(), p_signal)) {
-		//not user signal, delete
+	if (s->slot_map.is_empty() && !s->emissions && ClassDB::has_signal(get_class_name(), p_signal)) {
+		//not user signal, delete (if emitting, it's done when the emission ends)
 		signal_map.erase(p_signal);
 	}
 }
@@ -1783,6 +1809,14 @@ Object::~Object() {
 		ERR_PRINT("Object " + to_string() + " was freed or unreferenced while a signal is being emitted from it. Try connecting to the signal using 'CONNECT_DEFERRED' flag, or use queue_free() to free the object (if this object is a Node) to avoid this error and potential crashes.");
 	}
 
+	for (KeyValue<StringName, SignalData> &E : signal_map) {
+		// Emissions in progress keep the slots they started with, and stop accessing this object.
+		E.value.prepare_modify();
+		for (SignalData::Emission *e = E.value.emissions; e; e = e->prev) {
+			e->aborted = true;
+		}
+	}
+
 	while (signal_map.size()) {
 		// Avoid regular iteration so erasing is safe.
 		KeyValue<StringName, SignalData> &E = *signal_map.begin();
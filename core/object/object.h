@@ -589,8 +589,26 @@ private:
 			List<Connection>::Element *cE = nullptr;
 		};
 
+		// Emissions iterate slot_map in place. Before it is modified, each emission in progress
+		// takes a copy-on-write reference to the slots it started with.
+		struct Emission {
+			VMap<Callable, Slot> slots;
+			bool modified = false;
+			bool aborted = false; // The emitter was freed by a callback, it must not be accessed anymore.
+			Emission *prev = nullptr;
+		};
+
 		MethodInfo user;
 		VMap<Callable, Slot> slot_map;
+		Emission *emissions = nullptr;
+
+		_FORCE_INLINE_ void prepare_modify() {
+			// Newer emissions are first, and once one is modified all the older ones are too.
+			for (Emission *e = emissions; e && !e->modified; e = e->prev) {
+				e->slots = slot_map;
+				e->modified = true;
+			}
+		}
 	};
 
 	HashMap<StringName, SignalData> signal_map;
@@ -39,12 +39,14 @@
 #include "core/templates/paged_allocator.h"
 #include "core/templates/rid.h"
 #include "core/templates/safe_refcount.h"
+#include "core/templates/sort_array.h"
 
 class WorkerThreadPool : public Object {
 	GDCLASS(WorkerThreadPool, Object)
 public:
 	enum {
-		INVALID_TASK_ID = -1
+		INVALID_TASK_ID = -1,
+		PARALLEL_SORT_MIN_RUN_SIZE = 4096,
 	};
 
 	typedef int64_t TaskID;
@@ -152,6 +154,49 @@ private:
 		}
 	};
 
+	template <class F>
+	struct ParallelForUserdata {
+		const F *func = nullptr;
+		uint32_t count = 0;
+		uint32_t batch_size = 0;
+	};
+
+	template <class F>
+	static void _parallel_for_batch(void *p_userdata, uint32_t p_batch) {
+		ParallelForUserdata<F> *ud = (ParallelForUserdata<F> *)p_userdata;
+		uint32_t from = p_batch * ud->batch_size;
+		uint32_t to = MIN(from + ud->batch_size, ud->count);
+		(*ud->func)(from, to);
+	}
+
+	_FORCE_INLINE_ uint32_t _get_parallel_batch_size(uint32_t p_count, uint32_t p_batch_size) const {
+		if (p_batch_size > 0) {
+			return p_batch_size;
+		}
+		// A few batches per thread, so uneven batches don't leave threads idle.
+		return MAX(1u, p_count / MAX(1u, threads.size() * 4));
+	}
+
+	template <class T, class Comparator>
+	static void _merge_runs(const T *p_src, T *p_dst, uint32_t p_from, uint32_t p_middle, uint32_t p_to, const Comparator &p_compare) {
+		uint32_t a = p_from;
+		uint32_t b = p_middle;
+		uint32_t w = p_from;
+		while (a < p_middle && b < p_to) {
+			if (p_compare(p_src[b], p_src[a])) {
+				p_dst[w++] = p_src[b++];
+			} else {
+				p_dst[w++] = p_src[a++];
+			}
+		}
+		while (a < p_middle) {
+			p_dst[w++] = p_src[a++];
+		}
+		while (b < p_to) {
+			p_dst[w++] = p_src[b++];
+		}
+	}
+
 protected:
 	static void _bind_methods();
 
@@ -187,6 +232,150 @@ public:
 	void wait_for_group_task_completion(GroupID p_group);
 
 	_FORCE_INLINE_ int get_thread_count() const { return threads.size(); }
+	int get_thread_index() const; // -1 if the caller is not a pool thread.
+
+	/* Parallel algorithms
+	 *
+	 * These block the caller until all the work is done. They run serially when there is a single batch,
+	 * no pool threads, or when called from a pool thread (waiting there could starve the pool).
+	 */
+
+	// Calls p_func(from, to) for consecutive ranges covering [0, p_count).
+	template <class F>
+	void parallel_for(uint32_t p_count, const F &p_func, uint32_t p_batch_size = 0) {
+		if (p_count == 0) {
+			return;
+		}
+		uint32_t batch_size = _get_parallel_batch_size(p_count, p_batch_size);
+		uint32_t batches = (p_count + batch_size - 1) / batch_size;
+		if (batches <= 1 || threads.size() <= 1 || get_thread_index() != -1) {
+			p_func(0, p_count);
+			return;
+		}
+
+		ParallelForUserdata<F> ud;
+		ud.func = &p_func;
+		ud.count = p_count;
+		ud.batch_size = batch_size;
+		GroupID group = add_native_group_task(&_parallel_for_batch<F>, &ud, batches, MIN(batches, threads.size()), true, "Parallel for");
+		wait_for_group_task_completion(group);
+	}
+
+	// p_func(from, to) returns the result for a range, p_join(a, b) combines two results in order.
+	template <class T, class F, class J>
+	T parallel_reduce(uint32_t p_count, const T &p_identity, const F &p_func, const J &p_join, uint32_t p_batch_size = 0) {
+		uint32_t batch_size = _get_parallel_batch_size(p_count, p_batch_size);
+		uint32_t batches = (p_count + batch_size - 1) / batch_size;
+		LocalVector<T> partials;
+		partials.resize(batches);
+		parallel_for(
+				batches, [&](uint32_t p_from, uint32_t p_to) {
+					for (uint32_t i = p_from; i < p_to; i++) {
+						partials[i] = p_func(i * batch_size, MIN((i + 1) * batch_size, p_count));
+					}
+				},
+				1);
+
+		T result = p_identity;
+		for (uint32_t i = 0; i < batches; i++) {
+			result = p_join(result, partials[i]);
+		}
+		return result;
+	}
+
+	// Replaces each element with p_op applied to it and all the previous ones. p_op must be associative.
+	template <class T, class Op>
+	void parallel_inclusive_scan(T *p_array, uint32_t p_count, const Op &p_op, uint32_t p_batch_size = 0) {
+		if (p_count == 0) {
+			return;
+		}
+		uint32_t batch_size = _get_parallel_batch_size(p_count, p_batch_size);
+		uint32_t batches = (p_count + batch_size - 1) / batch_size;
+
+		// Scan each batch on its own, then add the totals of the previous batches.
+		parallel_for(
+				batches, [&](uint32_t p_from, uint32_t p_to) {
+					for (uint32_t i = p_from; i < p_to; i++) {
+						uint32_t end = MIN((i + 1) * batch_size, p_count);
+						for (uint32_t j = i * batch_size + 1; j < end; j++) {
+							p_array[j] = p_op(p_array[j - 1], p_array[j]);
+						}
+					}
+				},
+				1);
+
+		if (batches <= 1) {
+			return;
+		}
+		LocalVector<T> offsets;
+		offsets.resize(batches);
+		offsets[1] = p_array[batch_size - 1];
+		for (uint32_t i = 2; i < batches; i++) {
+			offsets[i] = p_op(offsets[i - 1], p_array[i * batch_size - 1]);
+		}
+
+		parallel_for(
+				batches - 1, [&](uint32_t p_from, uint32_t p_to) {
+					for (uint32_t i = p_from + 1; i < p_to + 1; i++) {
+						uint32_t end = MIN((i + 1) * batch_size, p_count);
+						for (uint32_t j = i * batch_size; j < end; j++) {
+							p_array[j] = p_op(offsets[i], p_array[j]);
+						}
+					}
+				},
+				1);
+	}
+
+	// Sorts one run per thread with SortArray, then merges runs pairwise. Not stable, like SortArray.
+	template <class T, class Comparator = _DefaultComparator<T>>
+	void parallel_sort(T *p_array, uint32_t p_count, const Comparator &p_compare = Comparator()) {
+		uint32_t runs = MIN(threads.size(), p_count / PARALLEL_SORT_MIN_RUN_SIZE);
+		if (runs <= 1 || get_thread_index() != -1) {
+			SortArray<T, Comparator> sorter;
+			sorter.compare = p_compare;
+			sorter.sort(p_array, p_count);
+			return;
+		}
+
+		uint32_t run_size = (p_count + runs - 1) / runs;
+		parallel_for(
+				runs, [&](uint32_t p_from, uint32_t p_to) {
+					SortArray<T, Comparator> sorter;
+					sorter.compare = p_compare;
+					for (uint32_t i = p_from; i < p_to; i++) {
+						uint32_t from = i * run_size;
+						sorter.sort(p_array + from, MIN(from + run_size, p_count) - from);
+					}
+				},
+				1);
+
+		LocalVector<T> buffer;
+		buffer.resize(p_count);
+		T *src = p_array;
+		T *dst = buffer.ptr();
+		for (uint32_t width = run_size; width < p_count; width *= 2) {
+			uint32_t pairs = (p_count + width * 2 - 1) / (width * 2);
+			parallel_for(
+					pairs, [&](uint32_t p_from, uint32_t p_to) {
+						for (uint32_t i = p_from; i < p_to; i++) {
+							uint32_t from = i * width * 2;
+							uint32_t middle = MIN(from + width, p_count);
+							uint32_t to = MIN(from + width * 2, p_count);
+							_merge_runs(src, dst, from, middle, to, p_compare);
+						}
+					},
+					1);
+			SWAP(src, dst);
+		}
+
+		if (src != p_array) {
+			parallel_for(p_count, [&](uint32_t p_from, uint32_t p_to) {
+				for (uint32_t i = p_from; i < p_to; i++) {
+					p_array[i] = src[i];
+				}
+			});
+		}
+	}
 
 	static WorkerThreadPool *get_singleton() { return singleton; }
 	void init(int p_thread_count = -1, bool p_use_native_threads_low_priority = true, float p_low_priority_task_ratio = 0.3);
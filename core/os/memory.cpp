@@ -35,6 +35,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 void *operator new(size_t p_size, const char *p_description) {
 	return Memory::alloc_static(p_size, false);
@@ -58,15 +59,33 @@ void operator delete(void *p_mem, void *p_pointer, size_t check, const char *p_d
 }
 #endif
 
-#ifdef DEBUG_ENABLED
+#if defined(DEBUG_ENABLED) || defined(MEMORY_TRACKING_ENABLED)
+#define MEMORY_USAGE_ENABLED
 SafeNumeric<uint64_t> Memory::mem_usage;
 SafeNumeric<uint64_t> Memory::max_usage;
 #endif
 
+#ifdef DEBUG_ENABLED
 SafeNumeric<uint64_t> Memory::alloc_count;
+#endif
+
+#ifdef MEMORY_TRACKING_ENABLED
+SafeNumeric<uint64_t> Memory::category_usage[CATEGORY_MAX];
+SafeNumeric<uint64_t> Memory::category_alloc_count[CATEGORY_MAX];
+thread_local Memory::Category Memory::current_category = Memory::CATEGORY_OTHER;
+
+// The category is kept in the top byte of the size stored in the padding,
+// the rest of the padding is already used by memnew_arr().
+#define MEMORY_CATEGORY_SHIFT 56
+#define MEMORY_SIZE_MASK ((UINT64_C(1) << MEMORY_CATEGORY_SHIFT) - 1)
+#define MEMORY_HEADER_SIZE(m_header) ((m_header) & MEMORY_SIZE_MASK)
+#define MEMORY_HEADER_CATEGORY(m_header) ((m_header) >> MEMORY_CATEGORY_SHIFT)
+#else
+#define MEMORY_HEADER_SIZE(m_header) (m_header)
+#endif
 
 void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
-#ifdef DEBUG_ENABLED
+#ifdef MEMORY_USAGE_ENABLED
 	bool prepad = true;
 #else
 	bool prepad = p_pad_align;
@@ -76,7 +95,9 @@ void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
 
 	ERR_FAIL_COND_V(!mem, nullptr);
 
+#ifdef DEBUG_ENABLED
 	alloc_count.increment();
+#endif
 
 	if (prepad) {
 		uint64_t *s = (uint64_t *)mem;
@@ -84,10 +105,16 @@ void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
 
 		uint8_t *s8 = (uint8_t *)mem;
 
-#ifdef DEBUG_ENABLED
+#ifdef MEMORY_USAGE_ENABLED
 		uint64_t new_mem_usage = mem_usage.add(p_bytes);
 		max_usage.exchange_if_greater(new_mem_usage);
 #endif
+
+#ifdef MEMORY_TRACKING_ENABLED
+		*s |= (uint64_t)current_category << MEMORY_CATEGORY_SHIFT;
+		category_usage[current_category].add(p_bytes);
+		category_alloc_count[current_category].increment();
+#endif
 		return s8 + PAD_ALIGN;
 	} else {
 		return mem;
@@ -101,7 +128,7 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 
 	uint8_t *mem = (uint8_t *)p_memory;
 
-#ifdef DEBUG_ENABLED
+#ifdef MEMORY_USAGE_ENABLED
 	bool prepad = true;
 #else
 	bool prepad = p_pad_align;
@@ -110,13 +137,27 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 	if (prepad) {
 		mem -= PAD_ALIGN;
 		uint64_t *s = (uint64_t *)mem;
+		uint64_t old_bytes = MEMORY_HEADER_SIZE(*s);
 
-#ifdef DEBUG_ENABLED
-		if (p_bytes > *s) {
-			uint64_t new_mem_usage = mem_usage.add(p_bytes - *s);
+#ifdef MEMORY_USAGE_ENABLED
+		if (p_bytes > old_bytes) {
+			uint64_t new_mem_usage = mem_usage.add(p_bytes - old_bytes);
 			max_usage.exchange_if_greater(new_mem_usage);
 		} else {
-			mem_usage.sub(*s - p_bytes);
+			mem_usage.sub(old_bytes - p_bytes);
+		}
+#endif
+
+#ifdef MEMORY_TRACKING_ENABLED
+		// Reallocations stay in the category of the original allocation.
+		uint64_t category = MEMORY_HEADER_CATEGORY(*s);
+		if (p_bytes > old_bytes) {
+			category_usage[category].add(p_bytes - old_bytes);
+		} else {
+			category_usage[category].sub(old_bytes - p_bytes);
+		}
+		if (p_bytes == 0) {
+			category_alloc_count[category].decrement();
 		}
 #endif
 
@@ -124,14 +165,14 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 			free(mem);
 			return nullptr;
 		} else {
-			*s = p_bytes;
+			uint64_t header = *s - old_bytes + p_bytes;
 
 			mem = (uint8_t *)realloc(mem, p_bytes + PAD_ALIGN);
 			ERR_FAIL_COND_V(!mem, nullptr);
 
 			s = (uint64_t *)mem;
 
-			*s = p_bytes;
+			*s = header;
 
 			return mem + PAD_ALIGN;
 		}
@@ -149,20 +190,28 @@ void Memory::free_static(void *p_ptr, bool p_pad_align) {
 
 	uint8_t *mem = (uint8_t *)p_ptr;
 
-#ifdef DEBUG_ENABLED
+#ifdef MEMORY_USAGE_ENABLED
 	bool prepad = true;
 #else
 	bool prepad = p_pad_align;
 #endif
 
+#ifdef DEBUG_ENABLED
 	alloc_count.decrement();
+#endif
 
 	if (prepad) {
 		mem -= PAD_ALIGN;
 
-#ifdef DEBUG_ENABLED
+#ifdef MEMORY_USAGE_ENABLED
 		uint64_t *s = (uint64_t *)mem;
-		mem_usage.sub(*s);
+		mem_usage.sub(MEMORY_HEADER_SIZE(*s));
+#endif
+
+#ifdef MEMORY_TRACKING_ENABLED
+		uint64_t category = MEMORY_HEADER_CATEGORY(*s);
+		category_usage[category].sub(MEMORY_HEADER_SIZE(*s));
+		category_alloc_count[category].decrement();
 #endif
 
 		free(mem);
@@ -176,7 +225,7 @@ uint64_t Memory::get_mem_available() {
 }
 
 uint64_t Memory::get_mem_usage() {
-#ifdef DEBUG_ENABLED
+#ifdef MEMORY_USAGE_ENABLED
 	return mem_usage.get();
 #else
 	return 0;
@@ -184,13 +233,194 @@ uint64_t Memory::get_mem_usage() {
 }
 
 uint64_t Memory::get_mem_max_usage() {
-#ifdef DEBUG_ENABLED
+#ifdef MEMORY_USAGE_ENABLED
 	return max_usage.get();
 #else
 	return 0;
 #endif
 }
 
+bool Memory::is_category_tracking_enabled() {
+#ifdef MEMORY_TRACKING_ENABLED
+	return true;
+#else
+	return false;
+#endif
+}
+
+uint64_t Memory::get_mem_usage(Category p_category) {
+	ERR_FAIL_INDEX_V(p_category, CATEGORY_MAX, 0);
+#ifdef MEMORY_TRACKING_ENABLED
+	return category_usage[p_category].get();
+#else
+	return 0;
+#endif
+}
+
+uint64_t Memory::get_alloc_count(Category p_category) {
+	ERR_FAIL_INDEX_V(p_category, CATEGORY_MAX, 0);
+#ifdef MEMORY_TRACKING_ENABLED
+	return category_alloc_count[p_category].get();
+#else
+	return 0;
+#endif
+}
+
+const char *Memory::get_category_name(Category p_category) {
+	ERR_FAIL_INDEX_V(p_category, CATEGORY_MAX, "");
+	static const char *names[CATEGORY_MAX] = {
+		"other",
+		"resources",
+		"scripts",
+		"rendering",
+		"physics",
+		"strings",
+		"variant_containers",
+	};
+	return names[p_category];
+}
+
+#define FRAME_ALLOCATOR_ALIGN(m_size) (((m_size) + (PAD_ALIGN - 1)) & ~(size_t)(PAD_ALIGN - 1))
+
+thread_local FrameAllocator::Arena FrameAllocator::arena;
+
+FrameAllocator::Arena::~Arena() {
+	Chunk *chunk = first;
+	while (chunk) {
+		Chunk *next = chunk->next;
+		Memory::free_static(chunk);
+		chunk = next;
+	}
+}
+
+uint8_t *FrameAllocator::_chunk_data(Chunk *p_chunk) {
+	return (uint8_t *)p_chunk + FRAME_ALLOCATOR_ALIGN(sizeof(Chunk));
+}
+
+FrameAllocator::Chunk *FrameAllocator::_chunk_alloc(size_t p_size) {
+	void *mem = Memory::alloc_static(FRAME_ALLOCATOR_ALIGN(sizeof(Chunk)) + p_size);
+	ERR_FAIL_COND_V(!mem, nullptr);
+	Chunk *chunk = memnew_placement(mem, Chunk);
+	chunk->size = p_size;
+	return chunk;
+}
+
+void *FrameAllocator::alloc(size_t p_bytes) {
+	// Every allocation is prefixed with its size, so it can be reallocated.
+	const size_t needed = PAD_ALIGN + FRAME_ALLOCATOR_ALIGN(p_bytes);
+
+	if (unlikely(arena.current == nullptr)) {
+		if (arena.first == nullptr) {
+			arena.first = _chunk_alloc(MAX(CHUNK_SIZE, needed));
+			ERR_FAIL_COND_V(!arena.first, nullptr);
+		}
+		arena.current = arena.first;
+		arena.current->used = 0;
+	}
+
+	Chunk *chunk = arena.current;
+	while (chunk->used + needed > chunk->size) {
+		if (chunk->next && chunk->next->size >= needed) {
+			chunk = chunk->next;
+		} else {
+			// Keep the following chunks for later, they may still be large enough for smaller allocations.
+			Chunk *new_chunk = _chunk_alloc(MAX(CHUNK_SIZE, needed));
+			ERR_FAIL_COND_V(!new_chunk, nullptr);
+			new_chunk->next = chunk->next;
+			chunk->next = new_chunk;
+			chunk = new_chunk;
+		}
+		chunk->used = 0;
+	}
+	arena.current = chunk;
+
+	uint8_t *mem = _chunk_data(chunk) + chunk->used;
+	chunk->used += needed;
+	*(uint64_t *)mem = p_bytes;
+
+#ifdef DEBUG_ENABLED
+	arena.live_allocations++;
+#endif
+
+	return mem + PAD_ALIGN;
+}
+
+void *FrameAllocator::realloc(void *p_memory, size_t p_bytes) {
+	if (p_memory == nullptr) {
+		return alloc(p_bytes);
+	}
+
+	if (p_bytes == 0) {
+		free(p_memory);
+		return nullptr;
+	}
+
+	uint8_t *mem = (uint8_t *)p_memory - PAD_ALIGN;
+	const size_t old_bytes = *(uint64_t *)mem;
+	Chunk *chunk = arena.current;
+
+	if (chunk) {
+		uint8_t *top = _chunk_data(chunk) + chunk->used;
+		const size_t old_size = PAD_ALIGN + FRAME_ALLOCATOR_ALIGN(old_bytes);
+		const size_t new_size = PAD_ALIGN + FRAME_ALLOCATOR_ALIGN(p_bytes);
+		if (mem + old_size == top && chunk->used - old_size + new_size <= chunk->size) {
+			// Most recent allocation, it can be resized in place.
+			chunk->used = chunk->used - old_size + new_size;
+			*(uint64_t *)mem = p_bytes;
+			return p_memory;
+		}
+	}
+
+	void *new_memory = alloc(p_bytes);
+	ERR_FAIL_COND_V(!new_memory, nullptr);
+	memcpy(new_memory, p_memory, MIN(old_bytes, p_bytes));
+	free(p_memory);
+	return new_memory;
+}
+
+void FrameAllocator::free(void *p_ptr) {
+	ERR_FAIL_COND(p_ptr == nullptr);
+
+#ifdef DEBUG_ENABLED
+	ERR_FAIL_COND_MSG(arena.live_allocations == 0, "Freeing memory that doesn't belong to the FrameAllocator of this thread.");
+	arena.live_allocations--;
+#endif
+
+	Chunk *chunk = arena.current;
+	if (chunk) {
+		uint8_t *mem = (uint8_t *)p_ptr - PAD_ALIGN;
+		const size_t size = PAD_ALIGN + FRAME_ALLOCATOR_ALIGN(*(uint64_t *)mem);
+		if (mem + size == _chunk_data(chunk) + chunk->used) {
+			chunk->used -= size;
+		}
+	}
+}
+
+void FrameAllocator::reset() {
+#ifdef DEBUG_ENABLED
+	if (arena.live_allocations != 0) {
+		WARN_PRINT("FrameAllocator reset while some of its allocations are still in use.");
+	}
+	arena.live_allocations = 0;
+#endif
+	arena.current = arena.first;
+	if (arena.current) {
+		arena.current->used = 0;
+	}
+}
+
+FrameAllocator::Scope::Scope() {
+	chunk = arena.current;
+	used = chunk ? chunk->used : 0;
+}
+
+FrameAllocator::Scope::~Scope() {
+	arena.current = chunk;
+	if (chunk) {
+		chunk->used = used;
+	}
+}
+
 _GlobalNil::_GlobalNil() {
 	left = this;
 	right = this;
@@ -43,12 +43,37 @@
 #endif
 
 class Memory {
-#ifdef DEBUG_ENABLED
+public:
+	// Allocations are attributed to the category of the innermost MEMORY_CATEGORY_SCOPE
+	// of the allocating thread. Only tracked when built with `memory_tracking=yes`.
+	enum Category {
+		CATEGORY_OTHER,
+		CATEGORY_RESOURCES,
+		CATEGORY_SCRIPTS,
+		CATEGORY_RENDERING,
+		CATEGORY_PHYSICS,
+		CATEGORY_STRINGS,
+		CATEGORY_VARIANT_CONTAINERS,
+		CATEGORY_MAX
+	};
+
+private:
+#if defined(DEBUG_ENABLED) || defined(MEMORY_TRACKING_ENABLED)
 	static SafeNumeric<uint64_t> mem_usage;
 	static SafeNumeric<uint64_t> max_usage;
 #endif
 
+#ifdef DEBUG_ENABLED
 	static SafeNumeric<uint64_t> alloc_count;
+#endif
+
+#ifdef MEMORY_TRACKING_ENABLED
+	static SafeNumeric<uint64_t> category_usage[CATEGORY_MAX];
+	static SafeNumeric<uint64_t> category_alloc_count[CATEGORY_MAX];
+	static thread_local Category current_category;
+
+	friend class MemoryCategoryScope;
+#endif
 
 public:
 	static void *alloc_static(size_t p_bytes, bool p_pad_align = false);
@@ -58,14 +83,91 @@ public:
 	static uint64_t get_mem_available();
 	static uint64_t get_mem_usage();
 	static uint64_t get_mem_max_usage();
+
+	static bool is_category_tracking_enabled();
+	static uint64_t get_mem_usage(Category p_category);
+	static uint64_t get_alloc_count(Category p_category);
+	static const char *get_category_name(Category p_category);
 };
 
+#ifdef MEMORY_TRACKING_ENABLED
+class MemoryCategoryScope {
+	Memory::Category prev_category;
+
+public:
+	_FORCE_INLINE_ MemoryCategoryScope(Memory::Category p_category) {
+		prev_category = Memory::current_category;
+		Memory::current_category = p_category;
+	}
+	_FORCE_INLINE_ ~MemoryCategoryScope() {
+		Memory::current_category = prev_category;
+	}
+};
+
+#define MEMORY_CATEGORY_SCOPE(m_category) MemoryCategoryScope _memory_category_scope_(Memory::m_category)
+#else
+#define MEMORY_CATEGORY_SCOPE(m_category)
+#endif
+
 class DefaultAllocator {
 public:
 	_FORCE_INLINE_ static void *alloc(size_t p_memory) { return Memory::alloc_static(p_memory, false); }
+	_FORCE_INLINE_ static void *realloc(void *p_memory, size_t p_bytes) { return Memory::realloc_static(p_memory, p_bytes, false); }
 	_FORCE_INLINE_ static void free(void *p_ptr) { Memory::free_static(p_ptr, false); }
 };
 
+/**
+ * Bump allocator working on an arena owned by the calling thread, meant for
+ * short-lived scratch memory that would otherwise churn the global heap.
+ *
+ * Memory obtained from it is only valid until the arena is rewound, either by
+ * reset() (Main::iteration() does it for the main thread at the start of every
+ * frame) or when the enclosing FrameAllocator::Scope goes out of scope. It must
+ * never be kept past that point nor passed to another thread to be freed.
+ * Freeing only gives memory back when it's the most recent allocation.
+ */
+class FrameAllocator {
+	struct Chunk {
+		Chunk *next = nullptr;
+		size_t size = 0;
+		size_t used = 0;
+	};
+
+	struct Arena {
+		Chunk *first = nullptr;
+		Chunk *current = nullptr;
+#ifdef DEBUG_ENABLED
+		uint64_t live_allocations = 0;
+#endif
+		~Arena();
+	};
+
+	static thread_local Arena arena;
+
+	static uint8_t *_chunk_data(Chunk *p_chunk);
+	static Chunk *_chunk_alloc(size_t p_size);
+
+public:
+	static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+	static void *alloc(size_t p_bytes);
+	static void *realloc(void *p_memory, size_t p_bytes);
+	static void free(void *p_ptr);
+
+	// Rewinds the arena of the calling thread. Its chunks are kept for reuse.
+	static void reset();
+
+	// Rewinds the arena of the calling thread to where it was when the scope was entered.
+	class Scope {
+		Chunk *chunk = nullptr;
+		size_t used = 0;
+
+	public:
+		Scope();
+		~Scope();
+	};
+};
+
 void *operator new(size_t p_size, const char *p_description); ///< operator new that takes a description and uses MemoryStaticPool
 void *operator new(size_t p_size, void *(*p_allocfunc)(size_t p_size)); ///< operator new that takes a description and uses MemoryStaticPool
 
@@ -41,12 +41,39 @@ StaticCString StaticCString::create(const char *p_ptr) {
 
 StringName::_Data *StringName::_table[STRING_TABLE_LEN];
 
+bool StringName::_Data::name_equals(const char *p_name) const {
+	if (cname) {
+		return strcmp(cname, p_name) == 0;
+	}
+	return name == p_name;
+}
+
+bool StringName::_Data::name_equals(const char32_t *p_name) const {
+	if (cname) {
+		const char *c = cname;
+		for (; *c && *p_name; c++, p_name++) {
+			if ((char32_t)(uint8_t)*c != *p_name) {
+				return false;
+			}
+		}
+		return *c == 0 && *p_name == 0;
+	}
+	return name == p_name;
+}
+
+bool StringName::_Data::name_equals(const String &p_name) const {
+	if (cname) {
+		return p_name == cname;
+	}
+	return name == p_name;
+}
+
 StringName _scs_create(const char *p_chr, bool p_static) {
 	return (p_chr[0] ? StringName(StaticCString::create(p_chr), p_static) : StringName());
 }
 
 bool StringName::configured = false;
-Mutex StringName::mutex;
+Mutex StringName::mutexes[STRING_TABLE_MUTEX_LEN];
 
 #ifdef DEBUG_ENABLED
 bool StringName::debug_stringname = false;
@@ -61,12 +88,11 @@ void StringName::setup() {
 }
 
 void StringName::cleanup() {
-	MutexLock lock(mutex);
-
 #ifdef DEBUG_ENABLED
 	if (unlikely(debug_stringname)) {
 		Vector<_Data *> data;
 		for (int i = 0; i < STRING_TABLE_LEN; i++) {
+			MutexLock lock(_get_table_mutex(i));
 			_Data *d = _table[i];
 			while (d) {
 				data.push_back(d);
@@ -94,6 +120,7 @@ void StringName::cleanup() {
 #endif
 	int lost_strings = 0;
 	for (int i = 0; i < STRING_TABLE_LEN; i++) {
+		MutexLock lock(_get_table_mutex(i));
 		while (_table[i]) {
 			_Data *d = _table[i];
 			if (d->static_count.get() != d->refcount.get()) {
@@ -122,7 +149,7 @@ void StringName::unref() {
 	ERR_FAIL_COND(!configured);
 
 	if (_data && _data->refcount.unref()) {
-		MutexLock lock(mutex);
+		MutexLock lock(_get_table_mutex(_data->idx));
 
 		if (_data->static_count.get() > 0) {
 			if (_data->cname) {
@@ -154,7 +181,7 @@ bool StringName::operator==(const String &p_name) const {
 		return (p_name.length() == 0);
 	}
 
-	return (_data->get_name() == p_name);
+	return (_data->name_equals(p_name));
 }
 
 bool StringName::operator==(const char *p_name) const {
@@ -162,7 +189,7 @@ bool StringName::operator==(const char *p_name) const {
 		return (p_name[0] == 0);
 	}
 
-	return (_data->get_name() == p_name);
+	return (_data->name_equals(p_name));
 }
 
 bool StringName::operator!=(const String &p_name) const {
@@ -210,17 +237,16 @@ StringName::StringName(const char *p_name, bool p_static) {
 		return; //empty, ignore
 	}
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = String::hash(p_name);
-
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
+	MutexLock lock(_get_table_mutex(idx));
+
 	_data = _table[idx];
 
 	while (_data) {
 		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
+		if (_data->hash == hash && _data->name_equals(p_name)) {
 			break;
 		}
 		_data = _data->next;
@@ -269,17 +295,16 @@ StringName::StringName(const StaticCString &p_static_string, bool p_static) {
 
 	ERR_FAIL_COND(!p_static_string.ptr || !p_static_string.ptr[0]);
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = String::hash(p_static_string.ptr);
-
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
+	MutexLock lock(_get_table_mutex(idx));
+
 	_data = _table[idx];
 
 	while (_data) {
 		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_static_string.ptr) {
+		if (_data->hash == hash && _data->name_equals(p_static_string.ptr)) {
 			break;
 		}
 		_data = _data->next;
@@ -329,15 +354,15 @@ StringName::StringName(const String &p_name, bool p_static) {
 		return;
 	}
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = p_name.hash();
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
+	MutexLock lock(_get_table_mutex(idx));
+
 	_data = _table[idx];
 
 	while (_data) {
-		if (_data->hash == hash && _data->get_name() == p_name) {
+		if (_data->hash == hash && _data->name_equals(p_name)) {
 			break;
 		}
 		_data = _data->next;
@@ -387,16 +412,16 @@ StringName StringName::search(const char *p_name) {
 		return StringName();
 	}
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = String::hash(p_name);
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
+	MutexLock lock(_get_table_mutex(idx));
+
 	_Data *_data = _table[idx];
 
 	while (_data) {
 		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
+		if (_data->hash == hash && _data->name_equals(p_name)) {
 			break;
 		}
 		_data = _data->next;
@@ -423,17 +448,16 @@ StringName StringName::search(const char32_t *p_name) {
 		return StringName();
 	}
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = String::hash(p_name);
-
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
+	MutexLock lock(_get_table_mutex(idx));
+
 	_Data *_data = _table[idx];
 
 	while (_data) {
 		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
+		if (_data->hash == hash && _data->name_equals(p_name)) {
 			break;
 		}
 		_data = _data->next;
@@ -449,17 +473,16 @@ StringName StringName::search(const char32_t *p_name) {
 StringName StringName::search(const String &p_name) {
 	ERR_FAIL_COND_V(p_name.is_empty(), StringName());
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = p_name.hash();
-
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
+	MutexLock lock(_get_table_mutex(idx));
+
 	_Data *_data = _table[idx];
 
 	while (_data) {
 		// compare hash first
-		if (_data->hash == hash && p_name == _data->get_name()) {
+		if (_data->hash == hash && _data->name_equals(p_name)) {
 			break;
 		}
 		_data = _data->next;
@@ -48,7 +48,12 @@ class StringName {
 	enum {
 		STRING_TABLE_BITS = 16,
 		STRING_TABLE_LEN = 1 << STRING_TABLE_BITS,
-		STRING_TABLE_MASK = STRING_TABLE_LEN - 1
+		STRING_TABLE_MASK = STRING_TABLE_LEN - 1,
+		// The table is guarded by several mutexes, each one owning a slice of the buckets,
+		// so threads creating unrelated names don't contend on the same lock.
+		STRING_TABLE_MUTEX_BITS = 6,
+		STRING_TABLE_MUTEX_LEN = 1 << STRING_TABLE_MUTEX_BITS,
+		STRING_TABLE_MUTEX_MASK = STRING_TABLE_MUTEX_LEN - 1
 	};
 
 	struct _Data {
@@ -60,6 +65,9 @@ class StringName {
 		uint32_t debug_references = 0;
 #endif
 		String get_name() const { return cname ? String(cname) : name; }
+		bool name_equals(const char *p_name) const;
+		bool name_equals(const char32_t *p_name) const;
+		bool name_equals(const String &p_name) const;
 		int idx = 0;
 		uint32_t hash = 0;
 		_Data *prev = nullptr;
@@ -80,7 +88,8 @@ class StringName {
 	friend void register_core_types();
 	friend void unregister_core_types();
 	friend class Main;
-	static Mutex mutex;
+	static Mutex mutexes[STRING_TABLE_MUTEX_LEN];
+	_FORCE_INLINE_ static Mutex &_get_table_mutex(uint32_t p_idx) { return mutexes[p_idx & STRING_TABLE_MUTEX_MASK]; }
 	static void setup();
 	static void cleanup();
 	static bool configured;
@@ -666,14 +666,8 @@ bool String::operator==(const String &p_str) const {
 	const char32_t *src = get_data();
 	const char32_t *dst = p_str.get_data();
 
-	/* Compare char by char */
-	for (int i = 0; i < l; i++) {
-		if (src[i] != dst[i]) {
-			return false;
-		}
-	}
-
-	return true;
+	// Both buffers are contiguous, let memcmp use the widest comparisons available.
+	return memcmp(src, dst, l * sizeof(char32_t)) == 0;
 }
 
 bool String::operator==(const StrRange &p_str_range) const {
@@ -1363,28 +1357,44 @@ char32_t String::char_lowercase(char32_t p_char) {
 }
 
 String String::to_upper() const {
-	String upper = *this;
+	const int len = length();
+	const char32_t *src = get_data();
 
-	for (int i = 0; i < upper.size(); i++) {
-		const char32_t s = upper[i];
-		const char32_t t = _find_upper(s);
-		if (s != t) { // avoid copy on write
-			upper[i] = t;
-		}
+	// Skip the characters which are already uppercase, to avoid copy on write when possible.
+	int i = 0;
+	while (i < len && _find_upper(src[i]) == (int)src[i]) {
+		i++;
+	}
+	if (i == len) {
+		return *this;
+	}
+
+	String upper = *this;
+	char32_t *dst = upper.ptrw();
+	for (; i < len; i++) {
+		dst[i] = _find_upper(dst[i]);
 	}
 
 	return upper;
 }
 
 String String::to_lower() const {
-	String lower = *this;
+	const int len = length();
+	const char32_t *src = get_data();
 
-	for (int i = 0; i < lower.size(); i++) {
-		const char32_t s = lower[i];
-		const char32_t t = _find_lower(s);
-		if (s != t) { // avoid copy on write
-			lower[i] = t;
-		}
+	// Skip the characters which are already lowercase, to avoid copy on write when possible.
+	int i = 0;
+	while (i < len && _find_lower(src[i]) == (int)src[i]) {
+		i++;
+	}
+	if (i == len) {
+		return *this;
+	}
+
+	String lower = *this;
+	char32_t *dst = lower.ptrw();
+	for (; i < len; i++) {
+		dst[i] = _find_lower(dst[i]);
 	}
 
 	return lower;
@@ -1696,6 +1706,7 @@ Error String::parse_utf8(const char *p_utf8, int p_len, bool p_skip_cr) {
 
 	bool decode_error = false;
 	bool decode_failed = false;
+	bool ascii = true;
 	{
 		const char *ptrtmp = p_utf8;
 		const char *ptrtmp_limit = &p_utf8[p_len];
@@ -1728,6 +1739,9 @@ Error String::parse_utf8(const char *p_utf8, int p_len, bool p_skip_cr) {
 					decode_failed = true;
 				}
 				c_start = c;
+				if (c & 0x80) {
+					ascii = false;
+				}
 
 				if (skip == 1 && (c & 0x1e) == 0) {
 					print_unicode_error(vformat("Overlong encoding (%x ...)", c));
@@ -1767,6 +1781,19 @@ Error String::parse_utf8(const char *p_utf8, int p_len, bool p_skip_cr) {
 	char32_t *dst = ptrw();
 	dst[str_size] = 0;
 
+	if (ascii) {
+		// Fast path, every byte is a character on its own.
+		while (cstr_size) {
+			char c = *(p_utf8++);
+			if (p_skip_cr && c == '\r') {
+				continue;
+			}
+			*(dst++) = c;
+			cstr_size--;
+		}
+		return OK;
+	}
+
 	int skip = 0;
 	uint32_t unichar = 0;
 	while (cstr_size) {
@@ -1851,8 +1878,25 @@ CharString String::utf8() const {
 	}
 
 	const char32_t *d = &operator[](0);
-	int fl = 0;
-	for (int i = 0; i < l; i++) {
+
+	int ascii_len = 0;
+	while (ascii_len < l && d[ascii_len] <= 0x7f) {
+		ascii_len++;
+	}
+	if (ascii_len == l) {
+		// Fast path, the string is plain ASCII and maps one to one to UTF-8.
+		CharString utf8s;
+		utf8s.resize(l + 1);
+		char *cdst = utf8s.ptrw();
+		for (int i = 0; i < l; i++) {
+			cdst[i] = d[i];
+		}
+		cdst[l] = 0;
+		return utf8s;
+	}
+
+	int fl = ascii_len;
+	for (int i = ascii_len; i < l; i++) {
 		uint32_t c = d[i];
 		if (c <= 0x7f) { // 7 bits.
 			fl += 1;
@@ -2840,24 +2884,12 @@ int String::find(const String &p_str, int p_from) const {
 
 	const char32_t *src = get_data();
 	const char32_t *str = p_str.get_data();
+	const char32_t first = str[0];
+	const size_t tail_size = (src_len - 1) * sizeof(char32_t);
 
 	for (int i = p_from; i <= (len - src_len); i++) {
-		bool found = true;
-		for (int j = 0; j < src_len; j++) {
-			int read_pos = i + j;
-
-			if (read_pos >= len) {
-				ERR_PRINT("read_pos>=len");
-				return -1;
-			}
-
-			if (src[read_pos] != str[j]) {
-				found = false;
-				break;
-			}
-		}
-
-		if (found) {
+		// Look for the first character, then compare the rest of the key in one go.
+		if (src[i] == first && memcmp(&src[i + 1], &str[1], tail_size) == 0) {
 			return i;
 		}
 	}
@@ -2989,21 +3021,18 @@ int String::findn(const String &p_str, int p_from) const {
 	}
 
 	const char32_t *srcd = get_data();
+	const char32_t *str = p_str.get_data();
+	const int len = length();
+	const char32_t first = _find_lower(str[0]);
 
-	for (int i = p_from; i <= (length() - src_len); i++) {
-		bool found = true;
-		for (int j = 0; j < src_len; j++) {
-			int read_pos = i + j;
-
-			if (read_pos >= length()) {
-				ERR_PRINT("read_pos>=length()");
-				return -1;
-			}
-
-			char32_t src = _find_lower(srcd[read_pos]);
-			char32_t dst = _find_lower(p_str[j]);
+	for (int i = p_from; i <= (len - src_len); i++) {
+		if ((char32_t)_find_lower(srcd[i]) != first) {
+			continue;
+		}
 
-			if (src != dst) {
+		bool found = true;
+		for (int j = 1; j < src_len; j++) {
+			if (_find_lower(srcd[i + j]) != _find_lower(str[j])) {
 				found = false;
 				break;
 			}
@@ -3220,14 +3249,12 @@ int String::_count(const String &p_string, int p_from, int p_to, bool p_case_ins
 		return 0;
 	}
 	int c = 0;
-	int idx = -1;
-	do {
-		idx = p_case_insensitive ? str.findn(p_string) : str.find(p_string);
-		if (idx != -1) {
-			str = str.substr(idx + slen, str.length() - slen);
-			++c;
-		}
-	} while (idx != -1);
+	int idx = 0;
+	// Search from the end of the previous match, instead of copying the remainder each time.
+	while ((idx = p_case_insensitive ? str.findn(p_string, idx) : str.find(p_string, idx)) != -1) {
+		idx += slen;
+		++c;
+	}
 	return c;
 }
 
@@ -37,6 +37,7 @@
 
 #include <string.h>
 #include <type_traits>
+#include <utility>
 
 template <class T>
 class Vector;
@@ -117,6 +118,17 @@ private:
 
 public:
 	void operator=(const CowData<T> &p_from) { _ref(p_from); }
+	void operator=(CowData<T> &&p_from) {
+		if (_ptr == p_from._ptr) {
+			return;
+		}
+
+		// Detach the source first, it may be owned by the current data.
+		T *ptr = p_from._ptr;
+		p_from._ptr = nullptr;
+		_unref(_ptr);
+		_ptr = ptr;
+	}
 
 	_FORCE_INLINE_ T *ptrw() {
 		_copy_on_write();
@@ -173,11 +185,14 @@ public:
 
 	Error insert(int p_pos, const T &p_val) {
 		ERR_FAIL_INDEX_V(p_pos, size() + 1, ERR_INVALID_PARAMETER);
+		// Copied first, p_val may be an element of this buffer, which is moved by the resize and the shift.
+		T val = p_val;
 		resize(size() + 1);
+		T *p = ptrw();
 		for (int i = (size() - 1); i > p_pos; i--) {
-			set(i, get(i - 1));
+			p[i] = std::move(p[i - 1]);
 		}
-		set(p_pos, p_val);
+		p[p_pos] = std::move(val);
 
 		return OK;
 	}
@@ -189,6 +204,10 @@ public:
 	_FORCE_INLINE_ CowData() {}
 	_FORCE_INLINE_ ~CowData();
 	_FORCE_INLINE_ CowData(CowData<T> &p_from) { _ref(p_from); };
+	_FORCE_INLINE_ CowData(CowData<T> &&p_from) {
+		_ptr = p_from._ptr;
+		p_from._ptr = nullptr;
+	}
 };
 
 template <class T>
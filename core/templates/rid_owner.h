@@ -36,10 +36,12 @@
 #include "core/string/print_string.h"
 #include "core/templates/hash_set.h"
 #include "core/templates/list.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/oa_hash_map.h"
 #include "core/templates/rid.h"
 #include "core/templates/safe_refcount.h"
 
+#include <atomic>
 #include <stdio.h>
 #include <typeinfo>
 
@@ -67,48 +69,79 @@ public:
 	virtual ~RID_AllocBase() {}
 };
 
+// Lookups (get_or_null() and owns()) never lock, even when THREAD_SAFE, so
+// they can run in parallel with each other and with allocations. Growing
+// publishes the chunk tables before the new max_alloc, and validators are
+// read atomically. When THREAD_SAFE, tables replaced by larger ones may still
+// be in use by lookups in other threads, so they are kept until destruction.
 template <class T, bool THREAD_SAFE = false>
 class RID_Alloc : public RID_AllocBase {
-	T **chunks = nullptr;
+	std::atomic<T **> chunks{ nullptr };
 	uint32_t **free_list_chunks = nullptr;
-	uint32_t **validator_chunks = nullptr;
+	std::atomic<SafeNumeric<uint32_t> **> validator_chunks{ nullptr };
+	LocalVector<void *> retired_tables;
 
 	uint32_t elements_in_chunk;
-	uint32_t max_alloc = 0;
+	uint32_t chunk_table_capacity = 0;
+	SafeNumeric<uint32_t> max_alloc;
 	uint32_t alloc_count = 0;
 
 	const char *description = nullptr;
 
 	mutable SpinLock spin_lock;
 
+	template <class C>
+	C **_append_to_table(C **p_table, uint32_t p_chunk_count, uint32_t p_new_capacity, C *p_chunk) {
+		C **table = p_table;
+		if (p_new_capacity != chunk_table_capacity) {
+			if (THREAD_SAFE) {
+				table = (C **)memalloc(sizeof(C *) * p_new_capacity);
+				if (p_table) {
+					memcpy(table, p_table, sizeof(C *) * p_chunk_count);
+					retired_tables.push_back(p_table);
+				}
+			} else {
+				table = (C **)memrealloc(p_table, sizeof(C *) * p_new_capacity);
+			}
+		}
+		// Lookups only read entries below max_alloc, so this one can be written while they run.
+		table[p_chunk_count] = p_chunk;
+		return table;
+	}
+
 	_FORCE_INLINE_ RID _allocate_rid() {
 		if (THREAD_SAFE) {
 			spin_lock.lock();
 		}
 
-		if (alloc_count == max_alloc) {
+		if (alloc_count == max_alloc.get()) {
 			//allocate a new chunk
-			uint32_t chunk_count = alloc_count == 0 ? 0 : (max_alloc / elements_in_chunk);
+			uint32_t chunk_count = alloc_count == 0 ? 0 : (max_alloc.get() / elements_in_chunk);
 
-			//grow chunks
-			chunks = (T **)memrealloc(chunks, sizeof(T *) * (chunk_count + 1));
-			chunks[chunk_count] = (T *)memalloc(sizeof(T) * elements_in_chunk); //but don't initialize
+			T *chunk = (T *)memalloc(sizeof(T) * elements_in_chunk); //but don't initialize
+			SafeNumeric<uint32_t> *validator_chunk = (SafeNumeric<uint32_t> *)memalloc(sizeof(SafeNumeric<uint32_t>) * elements_in_chunk);
 
-			//grow validators
-			validator_chunks = (uint32_t **)memrealloc(validator_chunks, sizeof(uint32_t *) * (chunk_count + 1));
-			validator_chunks[chunk_count] = (uint32_t *)memalloc(sizeof(uint32_t) * elements_in_chunk);
-			//grow free lists
+			//grow free lists, only used while locked
 			free_list_chunks = (uint32_t **)memrealloc(free_list_chunks, sizeof(uint32_t *) * (chunk_count + 1));
 			free_list_chunks[chunk_count] = (uint32_t *)memalloc(sizeof(uint32_t) * elements_in_chunk);
 
 			//initialize
 			for (uint32_t i = 0; i < elements_in_chunk; i++) {
 				// Don't initialize chunk.
-				validator_chunks[chunk_count][i] = 0xFFFFFFFF;
+				memnew_placement(&validator_chunk[i], SafeNumeric<uint32_t>(0xFFFFFFFF));
 				free_list_chunks[chunk_count][i] = alloc_count + i;
 			}
 
-			max_alloc += elements_in_chunk;
+			//grow chunk tables, and publish them before the new size
+			uint32_t new_capacity = chunk_table_capacity;
+			if (chunk_count == chunk_table_capacity) {
+				new_capacity = MAX(1u, chunk_table_capacity * 2);
+			}
+			chunks.store(_append_to_table(chunks.load(std::memory_order_relaxed), chunk_count, new_capacity, chunk), std::memory_order_release);
+			validator_chunks.store(_append_to_table(validator_chunks.load(std::memory_order_relaxed), chunk_count, new_capacity, validator_chunk), std::memory_order_release);
+			chunk_table_capacity = new_capacity;
+
+			max_alloc.set(max_alloc.get() + elements_in_chunk);
 		}
 
 		uint32_t free_index = free_list_chunks[alloc_count / elements_in_chunk][alloc_count % elements_in_chunk];
@@ -121,9 +154,7 @@ class RID_Alloc : public RID_AllocBase {
 		id <<= 32;
 		id |= free_index;
 
-		validator_chunks[free_chunk][free_element] = validator;
-
-		validator_chunks[free_chunk][free_element] |= 0x80000000; //mark uninitialized bit
+		validator_chunks.load(std::memory_order_relaxed)[free_chunk][free_element].set(validator | 0x80000000); //mark uninitialized bit
 
 		alloc_count++;
 
@@ -134,6 +165,56 @@ class RID_Alloc : public RID_AllocBase {
 		return _make_from_id(id);
 	}
 
+	T *_get_uninitialized(const RID &p_rid) {
+		if (THREAD_SAFE) {
+			spin_lock.lock();
+		}
+
+		uint64_t id = p_rid.get_id();
+		uint32_t idx = uint32_t(id & 0xFFFFFFFF);
+		if (unlikely(idx >= max_alloc.get())) {
+			if (THREAD_SAFE) {
+				spin_lock.unlock();
+			}
+			return nullptr;
+		}
+
+		uint32_t idx_chunk = idx / elements_in_chunk;
+		uint32_t idx_element = idx % elements_in_chunk;
+
+		uint32_t validator = uint32_t(id >> 32);
+		uint32_t current = validator_chunks.load(std::memory_order_relaxed)[idx_chunk][idx_element].get();
+
+		if (unlikely(!(current & 0x80000000))) {
+			if (THREAD_SAFE) {
+				spin_lock.unlock();
+			}
+			ERR_FAIL_V_MSG(nullptr, "Initializing already initialized RID");
+		}
+
+		if (unlikely((current & 0x7FFFFFFF) != validator)) {
+			if (THREAD_SAFE) {
+				spin_lock.unlock();
+			}
+			ERR_FAIL_V_MSG(nullptr, "Attempting to initialize the wrong RID");
+		}
+
+		T *ptr = &chunks.load(std::memory_order_relaxed)[idx_chunk][idx_element];
+
+		if (THREAD_SAFE) {
+			spin_lock.unlock();
+		}
+
+		return ptr;
+	}
+
+	// Only done once the element is constructed, so lookups in other threads never see it half-built.
+	void _set_initialized(const RID &p_rid) {
+		uint64_t id = p_rid.get_id();
+		uint32_t idx = uint32_t(id & 0xFFFFFFFF);
+		validator_chunks.load(std::memory_order_acquire)[idx / elements_in_chunk][idx % elements_in_chunk].set(uint32_t(id >> 32));
+	}
+
 public:
 	RID make_rid() {
 		RID rid = _allocate_rid();
@@ -155,16 +236,20 @@ public:
 		if (p_rid == RID()) {
 			return nullptr;
 		}
-		if (THREAD_SAFE) {
-			spin_lock.lock();
+
+		if (unlikely(p_initialize)) {
+			// The RID becomes valid before the caller constructs the element, so unlike initialize_rid(),
+			// it must not be shared with other threads until the caller is done.
+			T *ptr = _get_uninitialized(p_rid);
+			if (ptr) {
+				_set_initialized(p_rid);
+			}
+			return ptr;
 		}
 
 		uint64_t id = p_rid.get_id();
 		uint32_t idx = uint32_t(id & 0xFFFFFFFF);
-		if (unlikely(idx >= max_alloc)) {
-			if (THREAD_SAFE) {
-				spin_lock.unlock();
-			}
+		if (unlikely(idx >= max_alloc.get())) {
 			return nullptr;
 		}
 
@@ -172,65 +257,34 @@ public:
 		uint32_t idx_element = idx % elements_in_chunk;
 
 		uint32_t validator = uint32_t(id >> 32);
+		uint32_t current = validator_chunks.load(std::memory_order_acquire)[idx_chunk][idx_element].get();
 
-		if (unlikely(p_initialize)) {
-			if (unlikely(!(validator_chunks[idx_chunk][idx_element] & 0x80000000))) {
-				if (THREAD_SAFE) {
-					spin_lock.unlock();
-				}
-				ERR_FAIL_V_MSG(nullptr, "Initializing already initialized RID");
-			}
-
-			if (unlikely((validator_chunks[idx_chunk][idx_element] & 0x7FFFFFFF) != validator)) {
-				if (THREAD_SAFE) {
-					spin_lock.unlock();
-				}
-				ERR_FAIL_V_MSG(nullptr, "Attempting to initialize the wrong RID");
-				return nullptr;
-			}
-
-			validator_chunks[idx_chunk][idx_element] &= 0x7FFFFFFF; //initialized
-
-		} else if (unlikely(validator_chunks[idx_chunk][idx_element] != validator)) {
-			if (THREAD_SAFE) {
-				spin_lock.unlock();
-			}
-			if ((validator_chunks[idx_chunk][idx_element] & 0x80000000) && validator_chunks[idx_chunk][idx_element] != 0xFFFFFFFF) {
+		if (unlikely(current != validator)) {
+			if ((current & 0x80000000) && current != 0xFFFFFFFF) {
 				ERR_FAIL_V_MSG(nullptr, "Attempting to use an uninitialized RID");
 			}
 			return nullptr;
 		}
 
-		T *ptr = &chunks[idx_chunk][idx_element];
-
-		if (THREAD_SAFE) {
-			spin_lock.unlock();
-		}
-
-		return ptr;
+		return &chunks.load(std::memory_order_acquire)[idx_chunk][idx_element];
 	}
 	void initialize_rid(RID p_rid) {
-		T *mem = get_or_null(p_rid, true);
+		T *mem = _get_uninitialized(p_rid);
 		ERR_FAIL_COND(!mem);
 		memnew_placement(mem, T);
+		_set_initialized(p_rid);
 	}
 	void initialize_rid(RID p_rid, const T &p_value) {
-		T *mem = get_or_null(p_rid, true);
+		T *mem = _get_uninitialized(p_rid);
 		ERR_FAIL_COND(!mem);
 		memnew_placement(mem, T(p_value));
+		_set_initialized(p_rid);
 	}
 
 	_FORCE_INLINE_ bool owns(const RID &p_rid) const {
-		if (THREAD_SAFE) {
-			spin_lock.lock();
-		}
-
 		uint64_t id = p_rid.get_id();
 		uint32_t idx = uint32_t(id & 0xFFFFFFFF);
-		if (unlikely(idx >= max_alloc)) {
-			if (THREAD_SAFE) {
-				spin_lock.unlock();
-			}
+		if (unlikely(idx >= max_alloc.get())) {
 			return false;
 		}
 
@@ -239,13 +293,7 @@ public:
 
 		uint32_t validator = uint32_t(id >> 32);
 
-		bool owned = (validator_chunks[idx_chunk][idx_element] & 0x7FFFFFFF) == validator;
-
-		if (THREAD_SAFE) {
-			spin_lock.unlock();
-		}
-
-		return owned;
+		return (validator_chunks.load(std::memory_order_acquire)[idx_chunk][idx_element].get() & 0x7FFFFFFF) == validator;
 	}
 
 	_FORCE_INLINE_ void free(const RID &p_rid) {
@@ -255,7 +303,7 @@ public:
 
 		uint64_t id = p_rid.get_id();
 		uint32_t idx = uint32_t(id & 0xFFFFFFFF);
-		if (unlikely(idx >= max_alloc)) {
+		if (unlikely(idx >= max_alloc.get())) {
 			if (THREAD_SAFE) {
 				spin_lock.unlock();
 			}
@@ -266,20 +314,21 @@ public:
 		uint32_t idx_element = idx % elements_in_chunk;
 
 		uint32_t validator = uint32_t(id >> 32);
-		if (unlikely(validator_chunks[idx_chunk][idx_element] & 0x80000000)) {
+		SafeNumeric<uint32_t> &current = validator_chunks.load(std::memory_order_relaxed)[idx_chunk][idx_element];
+		if (unlikely(current.get() & 0x80000000)) {
 			if (THREAD_SAFE) {
 				spin_lock.unlock();
 			}
 			ERR_FAIL_MSG("Attempted to free an uninitialized or invalid RID");
-		} else if (unlikely(validator_chunks[idx_chunk][idx_element] != validator)) {
+		} else if (unlikely(current.get() != validator)) {
 			if (THREAD_SAFE) {
 				spin_lock.unlock();
 			}
 			ERR_FAIL();
 		}
 
-		chunks[idx_chunk][idx_element].~T();
-		validator_chunks[idx_chunk][idx_element] = 0xFFFFFFFF; // go invalid
+		current.set(0xFFFFFFFF); // go invalid, before destroying so lookups stop finding it
+		chunks.load(std::memory_order_relaxed)[idx_chunk][idx_element].~T();
 
 		alloc_count--;
 		free_list_chunks[alloc_count / elements_in_chunk][alloc_count % elements_in_chunk] = idx;
@@ -296,8 +345,9 @@ public:
 		if (THREAD_SAFE) {
 			spin_lock.lock();
 		}
-		for (size_t i = 0; i < max_alloc; i++) {
-			uint64_t validator = validator_chunks[i / elements_in_chunk][i % elements_in_chunk];
+		SafeNumeric<uint32_t> **validators = validator_chunks.load(std::memory_order_relaxed);
+		for (size_t i = 0; i < max_alloc.get(); i++) {
+			uint64_t validator = validators[i / elements_in_chunk][i % elements_in_chunk].get();
 			if (validator != 0xFFFFFFFF) {
 				p_owned->push_back(_make_from_id((validator << 32) | i));
 			}
@@ -312,9 +362,10 @@ public:
 		if (THREAD_SAFE) {
 			spin_lock.lock();
 		}
+		SafeNumeric<uint32_t> **validators = validator_chunks.load(std::memory_order_relaxed);
 		uint32_t idx = 0;
-		for (size_t i = 0; i < max_alloc; i++) {
-			uint64_t validator = validator_chunks[i / elements_in_chunk][i % elements_in_chunk];
+		for (size_t i = 0; i < max_alloc.get(); i++) {
+			uint64_t validator = validators[i / elements_in_chunk][i % elements_in_chunk].get();
 			if (validator != 0xFFFFFFFF) {
 				p_rid_buffer[idx] = _make_from_id((validator << 32) | i);
 				idx++;
@@ -334,32 +385,39 @@ public:
 	}
 
 	~RID_Alloc() {
+		T **chunk_table = chunks.load(std::memory_order_relaxed);
+		SafeNumeric<uint32_t> **validators = validator_chunks.load(std::memory_order_relaxed);
+
 		if (alloc_count) {
 			print_error(vformat("ERROR: %d RID allocations of type '%s' were leaked at exit.",
 					alloc_count, description ? description : typeid(T).name()));
 
-			for (size_t i = 0; i < max_alloc; i++) {
-				uint64_t validator = validator_chunks[i / elements_in_chunk][i % elements_in_chunk];
+			for (size_t i = 0; i < max_alloc.get(); i++) {
+				uint64_t validator = validators[i / elements_in_chunk][i % elements_in_chunk].get();
 				if (validator & 0x80000000) {
 					continue; //uninitialized
 				}
 				if (validator != 0xFFFFFFFF) {
-					chunks[i / elements_in_chunk][i % elements_in_chunk].~T();
+					chunk_table[i / elements_in_chunk][i % elements_in_chunk].~T();
 				}
 			}
 		}
 
-		uint32_t chunk_count = max_alloc / elements_in_chunk;
+		uint32_t chunk_count = max_alloc.get() / elements_in_chunk;
 		for (uint32_t i = 0; i < chunk_count; i++) {
-			memfree(chunks[i]);
-			memfree(validator_chunks[i]);
+			memfree(chunk_table[i]);
+			memfree(validators[i]);
 			memfree(free_list_chunks[i]);
 		}
 
-		if (chunks) {
-			memfree(chunks);
+		if (chunk_table) {
+			memfree(chunk_table);
 			memfree(free_list_chunks);
-			memfree(validator_chunks);
+			memfree(validators);
+		}
+
+		for (void *table : retired_tables) {
+			memfree(table);
 		}
 	}
 };
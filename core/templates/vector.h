@@ -143,6 +143,9 @@ public:
 	inline void operator=(const Vector &p_from) {
 		_cowdata._ref(p_from._cowdata);
 	}
+	inline void operator=(Vector &&p_from) {
+		_cowdata = std::move(p_from._cowdata);
+	}
 
 	Vector<uint8_t> to_byte_array() const {
 		Vector<uint8_t> ret;
@@ -283,14 +286,16 @@ public:
 		}
 	}
 	_FORCE_INLINE_ Vector(const Vector &p_from) { _cowdata._ref(p_from._cowdata); }
+	_FORCE_INLINE_ Vector(Vector &&p_from) :
+			_cowdata(std::move(p_from._cowdata)) {}
 
 	_FORCE_INLINE_ ~Vector() {}
 };
 
 template <class T>
 void Vector<T>::reverse() {
+	T *p = ptrw();
 	for (int i = 0; i < size() / 2; i++) {
-		T *p = ptrw();
 		SWAP(p[i], p[size() - i - 1]);
 	}
 }
@@ -303,8 +308,10 @@ void Vector<T>::append_array(Vector<T> p_other) {
 	}
 	const int bs = size();
 	resize(bs + ds);
+	T *p = ptrw();
+	const T *r = p_other.ptr();
 	for (int i = 0; i < ds; ++i) {
-		ptrw()[bs + i] = p_other[i];
+		p[bs + i] = r[i];
 	}
 }
 
@@ -312,7 +319,7 @@ template <class T>
 bool Vector<T>::push_back(T p_elem) {
 	Error err = resize(size() + 1);
 	ERR_FAIL_COND_V(err, true);
-	set(size() - 1, p_elem);
+	ptrw()[size() - 1] = std::move(p_elem);
 
 	return false;
 }
@@ -265,6 +265,7 @@ void Array::assign(const Array &p_array) {
 
 void Array::push_back(const Variant &p_value) {
 	ERR_FAIL_COND_MSG(_p->read_only, "Array is in read-only state.");
+	MEMORY_CATEGORY_SCOPE(CATEGORY_VARIANT_CONTAINERS);
 	Variant value = p_value;
 	ERR_FAIL_COND(!_p->typed.validate(value, "push_back"));
 	_p->array.push_back(value);
@@ -272,6 +273,13 @@ void Array::push_back(const Variant &p_value) {
 
 void Array::append_array(const Array &p_array) {
 	ERR_FAIL_COND_MSG(_p->read_only, "Array is in read-only state.");
+	MEMORY_CATEGORY_SCOPE(CATEGORY_VARIANT_CONTAINERS);
+
+	if (_p->typed.type == Variant::NIL || (_p->typed.type != Variant::OBJECT && _p->typed == p_array._p->typed)) {
+		// Elements are already known to be valid, no need to check them one by one.
+		_p->array.append_array(p_array._p->array);
+		return;
+	}
 
 	Vector<Variant> validated_array = p_array._p->array;
 	for (int i = 0; i < validated_array.size(); ++i) {
@@ -283,6 +291,7 @@ void Array::append_array(const Array &p_array) {
 
 Error Array::resize(int p_new_size) {
 	ERR_FAIL_COND_V_MSG(_p->read_only, ERR_LOCKED, "Array is in read-only state.");
+	MEMORY_CATEGORY_SCOPE(CATEGORY_VARIANT_CONTAINERS);
 	Variant::Type &variant_type = _p->typed.type;
 	int old_size = _p->array.size();
 	Error err = _p->array.resize_zeroed(p_new_size);
@@ -296,6 +305,7 @@ Error Array::resize(int p_new_size) {
 
 Error Array::insert(int p_pos, const Variant &p_value) {
 	ERR_FAIL_COND_V_MSG(_p->read_only, ERR_LOCKED, "Array is in read-only state.");
+	MEMORY_CATEGORY_SCOPE(CATEGORY_VARIANT_CONTAINERS);
 	Variant value = p_value;
 	ERR_FAIL_COND_V(!_p->typed.validate(value, "insert"), ERR_INVALID_PARAMETER);
 	return _p->array.insert(p_pos, value);
@@ -409,6 +419,10 @@ void Array::remove_at(int p_pos) {
 
 void Array::set(int p_idx, const Variant &p_value) {
 	ERR_FAIL_COND_MSG(_p->read_only, "Array is in read-only state.");
+	if (_p->typed.is_exact(p_value)) {
+		_p->array.write[p_idx] = p_value;
+		return;
+	}
 	Variant value = p_value;
 	ERR_FAIL_COND(!_p->typed.validate(value, "set"));
 
@@ -30,7 +30,9 @@
 
 #include "dictionary.h"
 
+#include "core/os/mutex.h"
 #include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/safe_refcount.h"
 #include "core/variant/variant.h"
 // required in this order by VariantInternal, do not remove this comment.
@@ -39,99 +41,392 @@
 #include "core/variant/type_info.h"
 #include "core/variant/variant_internal.h"
 
-struct DictionaryPrivate {
+// Small dictionaries with only string keys don't own their keys. They point to a shape, shared
+// by every dictionary that had the same keys inserted in the same order, and only store values.
+// A shape is only created for a sequence of keys that was already inserted before, so dictionaries
+// with one-off keys don't allocate shapes that nothing shares.
+// Keys that can't be added to the shape (other key types, too many keys, keys inserted after an
+// erase or after a key sequence seen for the first time) go to a regular HashMap, ordered after the
+// shape keys. Erased shape keys are only flagged, so the values of other keys never move.
+
+#define DICTIONARY_SHAPE_MAX_KEYS 16
+#define DICTIONARY_SHAPE_PAGE_SIZE 4
+#define DICTIONARY_SHAPE_ROOT_SHARDS 64
+#define DICTIONARY_SHAPE_SEEN_PATHS 1024
+#define DICTIONARY_SHAPE_ROOT_PATH 0x5bd1e995
+
+struct DictionaryShape;
+
+struct DictionaryShapeTransitions {
+	HashMap<String, DictionaryShape *> shapes; // Not referenced, children remove themselves when freed.
+	BinaryMutex mutex;
+};
+
+struct DictionaryShape {
 	SafeRefCount refcount;
-	Variant *read_only = nullptr; // If enabled, a pointer is used to a temporary value that is used to return read-only values.
-	HashMap<Variant, Variant, VariantHasher, StringLikeVariantComparator> variant_map;
+	DictionaryShape *parent = nullptr; // Referenced, nullptr only for the empty root shape.
+	uint32_t path_hash = DICTIONARY_SHAPE_ROOT_PATH; // Hash of the keys, in order.
+	LocalVector<Variant> keys; // Always String, in insertion order.
+	LocalVector<uint32_t> key_hashes;
+	DictionaryShapeTransitions transitions; // Unused by the root shape, see _get_shape_transitions().
+
+	int find(const Variant &p_key) const {
+		if (p_key.get_type() == Variant::STRING) {
+			const String *str = VariantInternal::get_string(&p_key);
+			const uint32_t hash = str->hash();
+			for (uint32_t i = 0; i < key_hashes.size(); i++) {
+				if (key_hashes[i] == hash && *VariantInternal::get_string(&keys[i]) == *str) {
+					return i;
+				}
+			}
+		} else if (p_key.get_type() == Variant::STRING_NAME) {
+			const StringName *sn = VariantInternal::get_string_name(&p_key);
+			for (uint32_t i = 0; i < keys.size(); i++) {
+				if (*sn == *VariantInternal::get_string(&keys[i])) {
+					return i;
+				}
+			}
+		}
+		return -1;
+	}
 };
 
-void Dictionary::get_key_list(List<Variant> *p_keys) const {
-	if (_p->variant_map.is_empty()) {
-		return;
+static DictionaryShape *_get_root_shape() {
+	static DictionaryShape root;
+	return &root;
+}
+
+static DictionaryShapeTransitions &_get_shape_transitions(DictionaryShape *p_shape, uint32_t p_key_hash) {
+	if (p_shape->parent) {
+		return p_shape->transitions;
 	}
+	// The first key of every dictionary transitions from the root, so its table is split by key.
+	static DictionaryShapeTransitions root_transitions[DICTIONARY_SHAPE_ROOT_SHARDS];
+	return root_transitions[p_key_hash % DICTIONARY_SHAPE_ROOT_SHARDS];
+}
 
-	for (const KeyValue<Variant, Variant> &E : _p->variant_map) {
-		p_keys->push_back(E.key);
+static _FORCE_INLINE_ uint32_t _get_shape_path_hash(uint32_t p_path_hash, uint32_t p_key_hash) {
+	const uint32_t hash = hash_murmur3_one_32(p_key_hash, p_path_hash);
+	return hash ? hash : 1; // 0 means the keys can't form a shape.
+}
+
+// Returns whether the key sequence with this hash was inserted recently, and remembers it.
+// Collisions only cost a missed or an extra shape.
+static bool _mark_shape_path_seen(uint32_t p_path_hash) {
+	static SafeNumeric<uint32_t> seen_paths[DICTIONARY_SHAPE_SEEN_PATHS];
+	SafeNumeric<uint32_t> &seen = seen_paths[p_path_hash % DICTIONARY_SHAPE_SEEN_PATHS];
+	if (seen.get() == p_path_hash) {
+		return true;
 	}
+	seen.set(p_path_hash);
+	return false;
 }
 
-Variant Dictionary::get_key_at_index(int p_index) const {
-	int index = 0;
-	for (const KeyValue<Variant, Variant> &E : _p->variant_map) {
-		if (index == p_index) {
-			return E.key;
+static void _unref_shape(DictionaryShape *p_shape) {
+	if (!p_shape->parent || !p_shape->refcount.unref()) {
+		return;
+	}
+
+	DictionaryShape *parent = p_shape->parent;
+	{
+		const uint32_t last = p_shape->keys.size() - 1;
+		DictionaryShapeTransitions &transitions = _get_shape_transitions(parent, p_shape->key_hashes[last]);
+		MutexLock lock(transitions.mutex);
+		// A new shape may have replaced this one while its count was zero.
+		const String &key = *VariantInternal::get_string(&p_shape->keys[last]);
+		DictionaryShape **E = transitions.shapes.getptr(key);
+		if (E && *E == p_shape) {
+			transitions.shapes.erase(key);
 		}
-		index++;
 	}
+	memdelete(p_shape);
+	_unref_shape(parent);
+}
 
-	return Variant();
+// Returns a referenced shape with p_key appended to the keys of p_from, or nullptr if these keys
+// were never inserted in this order before.
+static DictionaryShape *_get_shape_transition(DictionaryShape *p_from, const String &p_key, uint32_t p_key_hash) {
+	DictionaryShapeTransitions &transitions = _get_shape_transitions(p_from, p_key_hash);
+	MutexLock lock(transitions.mutex);
+
+	DictionaryShape **E = transitions.shapes.getptr(p_key);
+	if (E && (*E)->refcount.ref()) {
+		return *E;
+	}
+
+	const uint32_t path_hash = _get_shape_path_hash(p_from->path_hash, p_key_hash);
+	if (!E && !_mark_shape_path_seen(path_hash)) {
+		return nullptr;
+	}
+
+	DictionaryShape *shape = memnew(DictionaryShape);
+	shape->refcount.init();
+	shape->parent = p_from;
+	shape->path_hash = path_hash;
+	if (p_from->parent) {
+		p_from->refcount.ref();
+	}
+	shape->keys.resize(p_from->keys.size() + 1);
+	shape->key_hashes.resize(p_from->keys.size() + 1);
+	for (uint32_t i = 0; i < p_from->keys.size(); i++) {
+		shape->keys[i] = p_from->keys[i];
+		shape->key_hashes[i] = p_from->key_hashes[i];
+	}
+	shape->keys[p_from->keys.size()] = p_key;
+	shape->key_hashes[p_from->keys.size()] = p_key_hash;
+
+	transitions.shapes[p_key] = shape;
+	return shape;
 }
 
-Variant Dictionary::get_value_at_index(int p_index) const {
-	int index = 0;
-	for (const KeyValue<Variant, Variant> &E : _p->variant_map) {
-		if (index == p_index) {
-			return E.value;
+struct DictionaryPrivate {
+	SafeRefCount refcount;
+	Variant *read_only = nullptr; // If enabled, a pointer is used to a temporary value that is used to return read-only values.
+	DictionaryShape *shape = nullptr; // The root shape while no key was added to it.
+	uint32_t erased_slots = 0; // One bit per erased shape key.
+	int erased_count = 0;
+	uint32_t path_hash = DICTIONARY_SHAPE_ROOT_PATH; // Hash of all keys while they could form a shape, 0 otherwise.
+	Variant *value_pages[DICTIONARY_SHAPE_MAX_KEYS / DICTIONARY_SHAPE_PAGE_SIZE] = {};
+	HashMap<Variant, Variant, VariantHasher, StringLikeVariantComparator> variant_map; // Keys after the shape keys.
+
+	_FORCE_INLINE_ Variant &shape_value(uint32_t p_index) {
+		return value_pages[p_index / DICTIONARY_SHAPE_PAGE_SIZE][p_index % DICTIONARY_SHAPE_PAGE_SIZE];
+	}
+
+	_FORCE_INLINE_ const Variant &shape_value(uint32_t p_index) const {
+		return value_pages[p_index / DICTIONARY_SHAPE_PAGE_SIZE][p_index % DICTIONARY_SHAPE_PAGE_SIZE];
+	}
+
+	_FORCE_INLINE_ bool is_shape_slot_erased(uint32_t p_index) const {
+		return erased_slots & (1u << p_index);
+	}
+
+	_FORCE_INLINE_ int size() const {
+		return shape->keys.size() - erased_count + variant_map.size();
+	}
+
+	// Returns the index of p_key in the shape, or -1 if it's not there or was erased.
+	_FORCE_INLINE_ int find_shape_slot(const Variant &p_key) const {
+		int index = shape->find(p_key);
+		return index >= 0 && !is_shape_slot_erased(index) ? index : -1;
+	}
+
+	const Variant *find(const Variant &p_key) const {
+		int index = find_shape_slot(p_key);
+		if (index >= 0) {
+			return &shape_value(index);
 		}
-		index++;
+		if (variant_map.is_empty()) {
+			return nullptr;
+		}
+		HashMap<Variant, Variant, VariantHasher, StringLikeVariantComparator>::ConstIterator E(variant_map.find(p_key));
+		return E ? &E->value : nullptr;
 	}
 
-	return Variant();
+	Variant *find(const Variant &p_key) {
+		return const_cast<Variant *>(const_cast<const DictionaryPrivate *>(this)->find(p_key));
+	}
+
+	bool get_at_index(int p_index, const Variant **r_key, const Variant **r_value) const {
+		if (p_index < 0) {
+			return false;
+		}
+		for (uint32_t i = 0; i < shape->keys.size(); i++) {
+			if (is_shape_slot_erased(i)) {
+				continue;
+			}
+			if (p_index == 0) {
+				*r_key = &shape->keys[i];
+				*r_value = &shape_value(i);
+				return true;
+			}
+			p_index--;
+		}
+		for (const KeyValue<Variant, Variant> &E : variant_map) {
+			if (p_index == 0) {
+				*r_key = &E.key;
+				*r_value = &E.value;
+				return true;
+			}
+			p_index--;
+		}
+		return false;
+	}
+
+	template <class F>
+	void for_each(F p_func) const {
+		for (uint32_t i = 0; i < shape->keys.size(); i++) {
+			if (!is_shape_slot_erased(i)) {
+				p_func(shape->keys[i], shape_value(i));
+			}
+		}
+		for (const KeyValue<Variant, Variant> &E : variant_map) {
+			p_func(E.key, E.value);
+		}
+	}
+
+	// Value pages never move, so references to values stay valid while keys are added.
+	Variant &shape_insert(DictionaryShape *p_shape) {
+		uint32_t index = shape->keys.size();
+		_unref_shape(shape);
+		shape = p_shape;
+
+		Variant *&page = value_pages[index / DICTIONARY_SHAPE_PAGE_SIZE];
+		if (!page) {
+			page = memnew_arr(Variant, DICTIONARY_SHAPE_PAGE_SIZE);
+		}
+		return page[index % DICTIONARY_SHAPE_PAGE_SIZE];
+	}
+
+	Variant &insert(const Variant &p_key) {
+		Variant *value = find(p_key);
+		if (value) {
+			return *value;
+		}
+
+		if (p_key.get_type() != Variant::STRING || !path_hash) {
+			path_hash = 0;
+			return variant_map[p_key];
+		}
+
+		// Keys are recorded even when the shape can't grow yet, so that the next dictionary inserting
+		// the same keys gets a shape.
+		const String &key = *VariantInternal::get_string(&p_key);
+		const uint32_t key_hash = key.hash();
+		const uint32_t next_path_hash = _get_shape_path_hash(path_hash, key_hash);
+		const bool last = size() + 1 >= DICTIONARY_SHAPE_MAX_KEYS;
+		if (variant_map.is_empty()) {
+			DictionaryShape *new_shape = _get_shape_transition(shape, key, key_hash);
+			if (new_shape) {
+				path_hash = last ? 0 : next_path_hash;
+				return shape_insert(new_shape);
+			}
+		} else {
+			_mark_shape_path_seen(next_path_hash);
+		}
+		path_hash = last ? 0 : next_path_hash;
+		return variant_map[p_key];
+	}
+
+	bool erase(const Variant &p_key) {
+		int index = find_shape_slot(p_key);
+		if (index >= 0) {
+			erased_slots |= 1u << index;
+			erased_count++;
+			shape_value(index) = Variant();
+		} else if (variant_map.is_empty() || !variant_map.erase(p_key)) {
+			return false;
+		}
+		path_hash = 0;
+		return true;
+	}
+
+	void free_shape() {
+		for (int i = 0; i < DICTIONARY_SHAPE_MAX_KEYS / DICTIONARY_SHAPE_PAGE_SIZE; i++) {
+			if (value_pages[i]) {
+				memdelete_arr(value_pages[i]);
+				value_pages[i] = nullptr;
+			}
+		}
+		if (shape) {
+			_unref_shape(shape);
+			shape = nullptr;
+		}
+		erased_slots = 0;
+		erased_count = 0;
+	}
+
+	void clear() {
+		free_shape();
+		variant_map.clear();
+		shape = _get_root_shape();
+		path_hash = DICTIONARY_SHAPE_ROOT_PATH;
+	}
+
+	DictionaryPrivate() {
+		shape = _get_root_shape();
+	}
+
+	~DictionaryPrivate() {
+		free_shape();
+	}
+};
+
+void Dictionary::get_key_list(List<Variant> *p_keys) const {
+	_p->for_each([p_keys](const Variant &p_key, const Variant &p_value) {
+		p_keys->push_back(p_key);
+	});
+}
+
+Variant Dictionary::get_key_at_index(int p_index) const {
+	const Variant *key;
+	const Variant *value;
+	return _p->get_at_index(p_index, &key, &value) ? *key : Variant();
+}
+
+Variant Dictionary::get_value_at_index(int p_index) const {
+	const Variant *key;
+	const Variant *value;
+	return _p->get_at_index(p_index, &key, &value) ? *value : Variant();
 }
 
 Variant &Dictionary::operator[](const Variant &p_key) {
+	MEMORY_CATEGORY_SCOPE(CATEGORY_VARIANT_CONTAINERS);
 	if (unlikely(_p->read_only)) {
 		if (p_key.get_type() == Variant::STRING_NAME) {
 			const StringName *sn = VariantInternal::get_string_name(&p_key);
-			*_p->read_only = _p->variant_map[sn->operator String()];
+			*_p->read_only = _p->insert(sn->operator String());
 		} else {
-			*_p->read_only = _p->variant_map[p_key];
+			*_p->read_only = _p->insert(p_key);
 		}
 
 		return *_p->read_only;
 	} else {
 		if (p_key.get_type() == Variant::STRING_NAME) {
+			// Existing keys are found without converting to String.
+			Variant *value = _p->find(p_key);
+			if (value) {
+				return *value;
+			}
 			const StringName *sn = VariantInternal::get_string_name(&p_key);
-			return _p->variant_map[sn->operator String()];
+			return _p->insert(sn->operator String());
 		} else {
-			return _p->variant_map[p_key];
+			return _p->insert(p_key);
 		}
 	}
 }
 
 const Variant &Dictionary::operator[](const Variant &p_key) const {
 	// Will not insert key, so no conversion is necessary.
-	return _p->variant_map[p_key];
+	const Variant *value = _p->find(p_key);
+	CRASH_COND(!value);
+	return *value;
 }
 
 const Variant *Dictionary::getptr(const Variant &p_key) const {
-	HashMap<Variant, Variant, VariantHasher, StringLikeVariantComparator>::ConstIterator E(_p->variant_map.find(p_key));
-	if (!E) {
-		return nullptr;
-	}
-	return &E->value;
+	return _p->find(p_key);
 }
 
 Variant *Dictionary::getptr(const Variant &p_key) {
-	HashMap<Variant, Variant, VariantHasher, StringLikeVariantComparator>::Iterator E(_p->variant_map.find(p_key));
-	if (!E) {
+	Variant *value = _p->find(p_key);
+	if (!value) {
 		return nullptr;
 	}
 	if (unlikely(_p->read_only != nullptr)) {
-		*_p->read_only = E->value;
+		*_p->read_only = *value;
 		return _p->read_only;
 	} else {
-		return &E->value;
+		return value;
 	}
 }
 
 Variant Dictionary::get_valid(const Variant &p_key) const {
-	HashMap<Variant, Variant, VariantHasher, StringLikeVariantComparator>::ConstIterator E(_p->variant_map.find(p_key));
+	const Variant *value = _p->find(p_key);
 
-	if (!E) {
+	if (!value) {
 		return Variant();
 	}
-	return E->value;
+	return *value;
 }
 
 Variant Dictionary::get(const Variant &p_key, const Variant &p_default) const {
@@ -144,15 +439,15 @@ Variant Dictionary::get(const Variant &p_key, const Variant &p_default) const {
 }
 
 int Dictionary::size() const {
-	return _p->variant_map.size();
+	return _p->size();
 }
 
 bool Dictionary::is_empty() const {
-	return !_p->variant_map.size();
+	return !_p->size();
 }
 
 bool Dictionary::has(const Variant &p_key) const {
-	return _p->variant_map.has(p_key);
+	return _p->find(p_key) != nullptr;
 }
 
 bool Dictionary::has_all(const Array &p_keys) const {
@@ -165,6 +460,12 @@ bool Dictionary::has_all(const Array &p_keys) const {
 }
 
 Variant Dictionary::find_key(const Variant &p_value) const {
+	for (uint32_t i = 0; i < _p->shape->keys.size(); i++) {
+		if (!_p->is_shape_slot_erased(i) && _p->shape_value(i) == p_value) {
+			return _p->shape->keys[i];
+		}
+	}
+
 	for (const KeyValue<Variant, Variant> &E : _p->variant_map) {
 		if (E.value == p_value) {
 			return E.key;
@@ -175,7 +476,7 @@ Variant Dictionary::find_key(const Variant &p_value) const {
 
 bool Dictionary::erase(const Variant &p_key) {
 	ERR_FAIL_COND_V_MSG(_p->read_only, false, "Dictionary is in read-only state.");
-	return _p->variant_map.erase(p_key);
+	return _p->erase(p_key);
 }
 
 bool Dictionary::operator==(const Dictionary &p_dictionary) const {
@@ -191,7 +492,7 @@ bool Dictionary::recursive_equal(const Dictionary &p_dictionary, int recursion_c
 	if (_p == p_dictionary._p) {
 		return true;
 	}
-	if (_p->variant_map.size() != p_dictionary._p->variant_map.size()) {
+	if (_p->size() != p_dictionary._p->size()) {
 		return false;
 	}
 
@@ -201,13 +502,24 @@ bool Dictionary::recursive_equal(const Dictionary &p_dictionary, int recursion_c
 		return true;
 	}
 	recursion_count++;
-	for (const KeyValue<Variant, Variant> &this_E : _p->variant_map) {
-		HashMap<Variant, Variant, VariantHasher, StringLikeVariantComparator>::ConstIterator other_E(p_dictionary._p->variant_map.find(this_E.key));
-		if (!other_E || !this_E.value.hash_compare(other_E->value, recursion_count)) {
-			return false;
+	if (_p->shape == p_dictionary._p->shape && !_p->erased_count && !p_dictionary._p->erased_count && _p->variant_map.is_empty() && p_dictionary._p->variant_map.is_empty()) {
+		// Same keys in the same slots, only values need comparing.
+		for (int i = 0; i < _p->size(); i++) {
+			if (!_p->shape_value(i).hash_compare(p_dictionary._p->shape_value(i), recursion_count)) {
+				return false;
+			}
 		}
+		return true;
 	}
-	return true;
+
+	bool equal = true;
+	_p->for_each([&](const Variant &p_key, const Variant &p_value) {
+		if (equal) {
+			const Variant *other_value = p_dictionary._p->find(p_key);
+			equal = other_value && p_value.hash_compare(*other_value, recursion_count);
+		}
+	});
+	return equal;
 }
 
 void Dictionary::_ref(const Dictionary &p_from) const {
@@ -229,15 +541,15 @@ void Dictionary::_ref(const Dictionary &p_from) const {
 
 void Dictionary::clear() {
 	ERR_FAIL_COND_MSG(_p->read_only, "Dictionary is in read-only state.");
-	_p->variant_map.clear();
+	_p->clear();
 }
 
 void Dictionary::merge(const Dictionary &p_dictionary, bool p_overwrite) {
-	for (const KeyValue<Variant, Variant> &E : p_dictionary._p->variant_map) {
-		if (p_overwrite || !has(E.key)) {
-			this->operator[](E.key) = E.value;
+	p_dictionary._p->for_each([&](const Variant &p_key, const Variant &p_value) {
+		if (p_overwrite || !has(p_key)) {
+			this->operator[](p_key) = p_value;
 		}
-	}
+	});
 }
 
 void Dictionary::_unref() const {
@@ -264,49 +576,67 @@ uint32_t Dictionary::recursive_hash(int recursion_count) const {
 	uint32_t h = hash_murmur3_one_32(Variant::DICTIONARY);
 
 	recursion_count++;
-	for (const KeyValue<Variant, Variant> &E : _p->variant_map) {
-		h = hash_murmur3_one_32(E.key.recursive_hash(recursion_count), h);
-		h = hash_murmur3_one_32(E.value.recursive_hash(recursion_count), h);
-	}
+	_p->for_each([&](const Variant &p_key, const Variant &p_value) {
+		h = hash_murmur3_one_32(p_key.recursive_hash(recursion_count), h);
+		h = hash_murmur3_one_32(p_value.recursive_hash(recursion_count), h);
+	});
 
 	return hash_fmix32(h);
 }
 
 Array Dictionary::keys() const {
 	Array varr;
-	if (_p->variant_map.is_empty()) {
+	if (is_empty()) {
 		return varr;
 	}
 
 	varr.resize(size());
 
 	int i = 0;
-	for (const KeyValue<Variant, Variant> &E : _p->variant_map) {
-		varr[i] = E.key;
+	_p->for_each([&](const Variant &p_key, const Variant &p_value) {
+		varr[i] = p_key;
 		i++;
-	}
+	});
 
 	return varr;
 }
 
 Array Dictionary::values() const {
 	Array varr;
-	if (_p->variant_map.is_empty()) {
+	if (is_empty()) {
 		return varr;
 	}
 
 	varr.resize(size());
 
 	int i = 0;
-	for (const KeyValue<Variant, Variant> &E : _p->variant_map) {
-		varr[i] = E.value;
+	_p->for_each([&](const Variant &p_key, const Variant &p_value) {
+		varr[i] = p_value;
 		i++;
-	}
+	});
 
 	return varr;
 }
 
 const Variant *Dictionary::next(const Variant *p_key) const {
+	const LocalVector<Variant> &shape_keys = _p->shape->keys;
+	int index = 0;
+	if (p_key != nullptr) {
+		index = _p->find_shape_slot(*p_key);
+		if (index >= 0) {
+			index++;
+		}
+	}
+	if (index >= 0) {
+		for (; index < (int)shape_keys.size(); index++) {
+			if (!_p->is_shape_slot_erased(index)) {
+				return &shape_keys[index];
+			}
+		}
+		// The shape keys are followed by the others.
+		p_key = nullptr;
+	}
+
 	if (p_key == nullptr) {
 		// caller wants to get the first element
 		if (_p->variant_map.begin()) {
@@ -352,13 +682,30 @@ Dictionary Dictionary::recursive_duplicate(bool p_deep, int recursion_count) con
 
 	if (p_deep) {
 		recursion_count++;
-		for (const KeyValue<Variant, Variant> &E : _p->variant_map) {
-			n[E.key.recursive_duplicate(true, recursion_count)] = E.value.recursive_duplicate(true, recursion_count);
+		_p->for_each([&](const Variant &p_key, const Variant &p_value) {
+			n[p_key.recursive_duplicate(true, recursion_count)] = p_value.recursive_duplicate(true, recursion_count);
+		});
+	} else if (_p->shape->parent) {
+		// Keys don't change, so the copy can share the shape.
+		_p->shape->refcount.ref();
+		n._p->shape = _p->shape;
+		n._p->erased_slots = _p->erased_slots;
+		n._p->erased_count = _p->erased_count;
+		n._p->path_hash = _p->path_hash;
+		for (uint32_t i = 0; i < _p->shape->keys.size(); i++) {
+			Variant *&page = n._p->value_pages[i / DICTIONARY_SHAPE_PAGE_SIZE];
+			if (!page) {
+				page = memnew_arr(Variant, DICTIONARY_SHAPE_PAGE_SIZE);
+			}
+			page[i % DICTIONARY_SHAPE_PAGE_SIZE] = _p->shape_value(i);
 		}
-	} else {
 		for (const KeyValue<Variant, Variant> &E : _p->variant_map) {
-			n[E.key] = E.value;
+			n._p->variant_map.insert(E.key, E.value);
 		}
+	} else {
+		_p->for_each([&](const Variant &p_key, const Variant &p_value) {
+			n[p_key] = p_value;
+		});
 	}
 
 	return n;
@@ -36,9 +36,10 @@
 #include "core/io/compression.h"
 #include "core/io/marshalls.h"
 #include "core/object/class_db.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
+#include "core/templates/a_hash_map.h"
 #include "core/templates/local_vector.h"
-#include "core/templates/oa_hash_map.h"
 
 typedef void (*VariantFunc)(Variant &r_ret, Variant &p_self, const Variant **p_args);
 typedef void (*VariantConstructFunc)(Variant &r_ret, const Variant **p_args);
@@ -659,6 +660,17 @@ static _FORCE_INLINE_ void vc_ptrcall(void (*method)(T *, P...), void *p_base, c
 	};
 
 struct _VariantCall {
+	template <class T>
+	static void func_PackedArray_sort(Vector<T> *p_instance) {
+		// Large arrays are sorted on the worker threads.
+		WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+		if (pool) {
+			pool->parallel_sort(p_instance->ptrw(), p_instance->size());
+		} else {
+			p_instance->sort();
+		}
+	}
+
 	static String func_PackedByteArray_get_string_from_ascii(PackedByteArray *p_instance) {
 		String s;
 		if (p_instance->size() > 0) {
@@ -1105,15 +1117,27 @@ struct VariantBuiltInMethodInfo {
 	Variant::Type (*get_argument_type)(int p_arg) = nullptr;
 };
 
-typedef OAHashMap<StringName, VariantBuiltInMethodInfo> BuiltinMethodMap;
-static BuiltinMethodMap *builtin_method_info;
+// Methods are stored in a flat table per type, so a call site can resolve a method ID once
+// and then dispatch without hashing the name again.
+typedef LocalVector<VariantBuiltInMethodInfo> BuiltinMethodTable;
+typedef AHashMap<StringName, int> BuiltinMethodIDMap;
+static BuiltinMethodTable *builtin_method_table;
+static BuiltinMethodIDMap *builtin_method_ids;
 static List<StringName> *builtin_method_names;
 
+static _FORCE_INLINE_ const VariantBuiltInMethodInfo *get_builtin_method(Variant::Type p_type, const StringName &p_method) {
+	const int *id = builtin_method_ids[p_type].getptr(p_method);
+	if (!id) {
+		return nullptr;
+	}
+	return &builtin_method_table[p_type][*id];
+}
+
 template <class T>
 static void register_builtin_method(const Vector<String> &p_argnames, const Vector<Variant> &p_def_args) {
 	StringName name = T::get_name();
 
-	ERR_FAIL_COND(builtin_method_info[T::get_base_type()].has(name));
+	ERR_FAIL_COND(builtin_method_ids[T::get_base_type()].has(name));
 
 	VariantBuiltInMethodInfo imi;
 
@@ -1139,7 +1163,8 @@ static void register_builtin_method(const Vector<String> &p_argnames, const Vect
 	ERR_FAIL_COND(!imi.is_vararg && imi.argument_count != imi.argument_names.size());
 #endif
 
-	builtin_method_info[T::get_base_type()].insert(name, imi);
+	builtin_method_ids[T::get_base_type()].insert(name, builtin_method_table[T::get_base_type()].size());
+	builtin_method_table[T::get_base_type()].push_back(imi);
 	builtin_method_names[T::get_base_type()].push_back(name);
 }
 
@@ -1163,7 +1188,7 @@ void Variant::callp(const StringName &p_method, const Variant **p_args, int p_ar
 	} else {
 		r_error.error = Callable::CallError::CALL_OK;
 
-		const VariantBuiltInMethodInfo *imf = builtin_method_info[type].lookup_ptr(p_method);
+		const VariantBuiltInMethodInfo *imf = get_builtin_method(type, p_method);
 
 		if (!imf) {
 			r_error.error = Callable::CallError::CALL_ERROR_INVALID_METHOD;
@@ -1195,7 +1220,7 @@ void Variant::call_const(const StringName &p_method, const Variant **p_args, int
 	} else {
 		r_error.error = Callable::CallError::CALL_OK;
 
-		const VariantBuiltInMethodInfo *imf = builtin_method_info[type].lookup_ptr(p_method);
+		const VariantBuiltInMethodInfo *imf = get_builtin_method(type, p_method);
 
 		if (!imf) {
 			r_error.error = Callable::CallError::CALL_ERROR_INVALID_METHOD;
@@ -1214,7 +1239,7 @@ void Variant::call_const(const StringName &p_method, const Variant **p_args, int
 void Variant::call_static(Variant::Type p_type, const StringName &p_method, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_error) {
 	r_error.error = Callable::CallError::CALL_OK;
 
-	const VariantBuiltInMethodInfo *imf = builtin_method_info[p_type].lookup_ptr(p_method);
+	const VariantBuiltInMethodInfo *imf = get_builtin_method(p_type, p_method);
 
 	if (!imf) {
 		r_error.error = Callable::CallError::CALL_ERROR_INVALID_METHOD;
@@ -1229,6 +1254,35 @@ void Variant::call_static(Variant::Type p_type, const StringName &p_method, cons
 	imf->call(nullptr, p_args, p_argcount, r_ret, imf->default_arguments, r_error);
 }
 
+void Variant::call_builtin(int p_method_id, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_error) {
+	// Objects have no entries in the table, so they fail the bounds check as well.
+	if (unlikely((uint32_t)p_method_id >= builtin_method_table[type].size())) {
+		r_error.error = Callable::CallError::CALL_ERROR_INVALID_METHOD;
+		return;
+	}
+
+	r_error.error = Callable::CallError::CALL_OK;
+	const VariantBuiltInMethodInfo &imf = builtin_method_table[type][p_method_id];
+	imf.call(this, p_args, p_argcount, r_ret, imf.default_arguments, r_error);
+}
+
+void Variant::call_builtin_const(int p_method_id, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_error) {
+	// Objects have no entries in the table, so they fail the bounds check as well.
+	if (unlikely((uint32_t)p_method_id >= builtin_method_table[type].size())) {
+		r_error.error = Callable::CallError::CALL_ERROR_INVALID_METHOD;
+		return;
+	}
+
+	const VariantBuiltInMethodInfo &imf = builtin_method_table[type][p_method_id];
+	if (!imf.is_const) {
+		r_error.error = Callable::CallError::CALL_ERROR_METHOD_NOT_CONST;
+		return;
+	}
+
+	r_error.error = Callable::CallError::CALL_OK;
+	imf.call(this, p_args, p_argcount, r_ret, imf.default_arguments, r_error);
+}
+
 bool Variant::has_method(const StringName &p_method) const {
 	if (type == OBJECT) {
 		Object *obj = get_validated_object();
@@ -1239,38 +1293,44 @@ bool Variant::has_method(const StringName &p_method) const {
 		return obj->has_method(p_method);
 	}
 
-	return builtin_method_info[type].has(p_method);
+	return builtin_method_ids[type].has(p_method);
 }
 
 bool Variant::has_builtin_method(Variant::Type p_type, const StringName &p_method) {
 	ERR_FAIL_INDEX_V(p_type, Variant::VARIANT_MAX, false);
-	return builtin_method_info[p_type].has(p_method);
+	return builtin_method_ids[p_type].has(p_method);
+}
+
+int Variant::get_builtin_method_id(Variant::Type p_type, const StringName &p_method) {
+	ERR_FAIL_INDEX_V(p_type, Variant::VARIANT_MAX, -1);
+	const int *id = builtin_method_ids[p_type].getptr(p_method);
+	return id ? *id : -1;
 }
 
 Variant::ValidatedBuiltInMethod Variant::get_validated_builtin_method(Variant::Type p_type, const StringName &p_method) {
 	ERR_FAIL_INDEX_V(p_type, Variant::VARIANT_MAX, nullptr);
-	const VariantBuiltInMethodInfo *method = builtin_method_info[p_type].lookup_ptr(p_method);
+	const VariantBuiltInMethodInfo *method = get_builtin_method(p_type, p_method);
 	ERR_FAIL_COND_V(!method, nullptr);
 	return method->validated_call;
 }
 
 Variant::PTRBuiltInMethod Variant::get_ptr_builtin_method(Variant::Type p_type, const StringName &p_method) {
 	ERR_FAIL_INDEX_V(p_type, Variant::VARIANT_MAX, nullptr);
-	const VariantBuiltInMethodInfo *method = builtin_method_info[p_type].lookup_ptr(p_method);
+	const VariantBuiltInMethodInfo *method = get_builtin_method(p_type, p_method);
 	ERR_FAIL_COND_V(!method, nullptr);
 	return method->ptrcall;
 }
 
 int Variant::get_builtin_method_argument_count(Variant::Type p_type, const StringName &p_method) {
 	ERR_FAIL_INDEX_V(p_type, Variant::VARIANT_MAX, 0);
-	const VariantBuiltInMethodInfo *method = builtin_method_info[p_type].lookup_ptr(p_method);
+	const VariantBuiltInMethodInfo *method = get_builtin_method(p_type, p_method);
 	ERR_FAIL_COND_V(!method, 0);
 	return method->argument_count;
 }
 
 Variant::Type Variant::get_builtin_method_argument_type(Variant::Type p_type, const StringName &p_method, int p_argument) {
 	ERR_FAIL_INDEX_V(p_type, Variant::VARIANT_MAX, Variant::NIL);
-	const VariantBuiltInMethodInfo *method = builtin_method_info[p_type].lookup_ptr(p_method);
+	const VariantBuiltInMethodInfo *method = get_builtin_method(p_type, p_method);
 	ERR_FAIL_COND_V(!method, Variant::NIL);
 	ERR_FAIL_INDEX_V(p_argument, method->argument_count, Variant::NIL);
 	return method->get_argument_type(p_argument);
@@ -1278,7 +1338,7 @@ Variant::Type Variant::get_builtin_method_argument_type(Variant::Type p_type, co
 
 String Variant::get_builtin_method_argument_name(Variant::Type p_type, const StringName &p_method, int p_argument) {
 	ERR_FAIL_INDEX_V(p_type, Variant::VARIANT_MAX, String());
-	const VariantBuiltInMethodInfo *method = builtin_method_info[p_type].lookup_ptr(p_method);
+	const VariantBuiltInMethodInfo *method = get_builtin_method(p_type, p_method);
 	ERR_FAIL_COND_V(!method, String());
 #ifdef DEBUG_METHODS_ENABLED
 	ERR_FAIL_INDEX_V(p_argument, method->argument_count, String());
@@ -1290,14 +1350,14 @@ String Variant::get_builtin_method_argument_name(Variant::Type p_type, const Str
 
 Vector<Variant> Variant::get_builtin_method_default_arguments(Variant::Type p_type, const StringName &p_method) {
 	ERR_FAIL_INDEX_V(p_type, Variant::VARIANT_MAX, Vector<Variant>());
-	const VariantBuiltInMethodInfo *method = builtin_method_info[p_type].lookup_ptr(p_method);
+	const VariantBuiltInMethodInfo *method = get_builtin_method(p_type, p_method);
 	ERR_FAIL_COND_V(!method, Vector<Variant>());
 	return method->default_arguments;
 }
 
 bool Variant::has_builtin_method_return_value(Variant::Type p_type, const StringName &p_method) {
 	ERR_FAIL_INDEX_V(p_type, Variant::VARIANT_MAX, false);
-	const VariantBuiltInMethodInfo *method = builtin_method_info[p_type].lookup_ptr(p_method);
+	const VariantBuiltInMethodInfo *method = get_builtin_method(p_type, p_method);
 	ERR_FAIL_COND_V(!method, false);
 	return method->has_return_type;
 }
@@ -1316,35 +1376,35 @@ int Variant::get_builtin_method_count(Variant::Type p_type) {
 
 Variant::Type Variant::get_builtin_method_return_type(Variant::Type p_type, const StringName &p_method) {
 	ERR_FAIL_INDEX_V(p_type, Variant::VARIANT_MAX, Variant::NIL);
-	const VariantBuiltInMethodInfo *method = builtin_method_info[p_type].lookup_ptr(p_method);
+	const VariantBuiltInMethodInfo *method = get_builtin_method(p_type, p_method);
 	ERR_FAIL_COND_V(!method, Variant::NIL);
 	return method->return_type;
 }
 
 bool Variant::is_builtin_method_const(Variant::Type p_type, const StringName &p_method) {
 	ERR_FAIL_INDEX_V(p_type, Variant::VARIANT_MAX, false);
-	const VariantBuiltInMethodInfo *method = builtin_method_info[p_type].lookup_ptr(p_method);
+	const VariantBuiltInMethodInfo *method = get_builtin_method(p_type, p_method);
 	ERR_FAIL_COND_V(!method, false);
 	return method->is_const;
 }
 
 bool Variant::is_builtin_method_static(Variant::Type p_type, const StringName &p_method) {
 	ERR_FAIL_INDEX_V(p_type, Variant::VARIANT_MAX, false);
-	const VariantBuiltInMethodInfo *method = builtin_method_info[p_type].lookup_ptr(p_method);
+	const VariantBuiltInMethodInfo *method = get_builtin_method(p_type, p_method);
 	ERR_FAIL_COND_V(!method, false);
 	return method->is_static;
 }
 
 bool Variant::is_builtin_method_vararg(Variant::Type p_type, const StringName &p_method) {
 	ERR_FAIL_INDEX_V(p_type, Variant::VARIANT_MAX, false);
-	const VariantBuiltInMethodInfo *method = builtin_method_info[p_type].lookup_ptr(p_method);
+	const VariantBuiltInMethodInfo *method = get_builtin_method(p_type, p_method);
 	ERR_FAIL_COND_V(!method, false);
 	return method->is_vararg;
 }
 
 uint32_t Variant::get_builtin_method_hash(Variant::Type p_type, const StringName &p_method) {
 	ERR_FAIL_INDEX_V(p_type, Variant::VARIANT_MAX, 0);
-	const VariantBuiltInMethodInfo *method = builtin_method_info[p_type].lookup_ptr(p_method);
+	const VariantBuiltInMethodInfo *method = get_builtin_method(p_type, p_method);
 	ERR_FAIL_COND_V(!method, 0);
 	uint32_t hash = hash_murmur3_one_32(method->is_const);
 	hash = hash_murmur3_one_32(method->is_static, hash);
@@ -1369,7 +1429,7 @@ void Variant::get_method_list(List<MethodInfo> *p_list) const {
 		}
 	} else {
 		for (const StringName &E : builtin_method_names[type]) {
-			const VariantBuiltInMethodInfo *method = builtin_method_info[type].lookup_ptr(E);
+			const VariantBuiltInMethodInfo *method = get_builtin_method(type, E);
 			ERR_CONTINUE(!method);
 
 			MethodInfo mi;
@@ -1613,7 +1673,8 @@ int Variant::get_enum_value(Variant::Type p_type, StringName p_enum_name, String
 static void _register_variant_builtin_methods() {
 	_VariantCall::constant_data = memnew_arr(_VariantCall::ConstantData, Variant::VARIANT_MAX);
 	_VariantCall::enum_data = memnew_arr(_VariantCall::EnumData, Variant::VARIANT_MAX);
-	builtin_method_info = memnew_arr(BuiltinMethodMap, Variant::VARIANT_MAX);
+	builtin_method_table = memnew_arr(BuiltinMethodTable, Variant::VARIANT_MAX);
+	builtin_method_ids = memnew_arr(BuiltinMethodIDMap, Variant::VARIANT_MAX);
 	builtin_method_names = memnew_arr(List<StringName>, Variant::VARIANT_MAX);
 
 	/* String */
@@ -2313,7 +2374,7 @@ static void _register_variant_builtin_methods() {
 	bind_method(PackedInt32Array, reverse, sarray(), varray());
 	bind_method(PackedInt32Array, slice, sarray("begin", "end"), varray(INT_MAX));
 	bind_method(PackedInt32Array, to_byte_array, sarray(), varray());
-	bind_method(PackedInt32Array, sort, sarray(), varray());
+	bind_functionnc(PackedInt32Array, sort, _VariantCall::func_PackedArray_sort<int32_t>, sarray(), varray());
 	bind_method(PackedInt32Array, bsearch, sarray("value", "before"), varray(true));
 	bind_method(PackedInt32Array, duplicate, sarray(), varray());
 	bind_method(PackedInt32Array, find, sarray("value", "from"), varray(0));
@@ -2337,7 +2398,7 @@ static void _register_variant_builtin_methods() {
 	bind_method(PackedInt64Array, reverse, sarray(), varray());
 	bind_method(PackedInt64Array, slice, sarray("begin", "end"), varray(INT_MAX));
 	bind_method(PackedInt64Array, to_byte_array, sarray(), varray());
-	bind_method(PackedInt64Array, sort, sarray(), varray());
+	bind_functionnc(PackedInt64Array, sort, _VariantCall::func_PackedArray_sort<int64_t>, sarray(), varray());
 	bind_method(PackedInt64Array, bsearch, sarray("value", "before"), varray(true));
 	bind_method(PackedInt64Array, duplicate, sarray(), varray());
 	bind_method(PackedInt64Array, find, sarray("value", "from"), varray(0));
@@ -2361,7 +2422,7 @@ static void _register_variant_builtin_methods() {
 	bind_method(PackedFloat32Array, reverse, sarray(), varray());
 	bind_method(PackedFloat32Array, slice, sarray("begin", "end"), varray(INT_MAX));
 	bind_method(PackedFloat32Array, to_byte_array, sarray(), varray());
-	bind_method(PackedFloat32Array, sort, sarray(), varray());
+	bind_functionnc(PackedFloat32Array, sort, _VariantCall::func_PackedArray_sort<float>, sarray(), varray());
 	bind_method(PackedFloat32Array, bsearch, sarray("value", "before"), varray(true));
 	bind_method(PackedFloat32Array, duplicate, sarray(), varray());
 	bind_method(PackedFloat32Array, find, sarray("value", "from"), varray(0));
@@ -2385,7 +2446,7 @@ static void _register_variant_builtin_methods() {
 	bind_method(PackedFloat64Array, reverse, sarray(), varray());
 	bind_method(PackedFloat64Array, slice, sarray("begin", "end"), varray(INT_MAX));
 	bind_method(PackedFloat64Array, to_byte_array, sarray(), varray());
-	bind_method(PackedFloat64Array, sort, sarray(), varray());
+	bind_functionnc(PackedFloat64Array, sort, _VariantCall::func_PackedArray_sort<double>, sarray(), varray());
 	bind_method(PackedFloat64Array, bsearch, sarray("value", "before"), varray(true));
 	bind_method(PackedFloat64Array, duplicate, sarray(), varray());
 	bind_method(PackedFloat64Array, find, sarray("value", "from"), varray(0));
@@ -2409,7 +2470,7 @@ static void _register_variant_builtin_methods() {
 	bind_method(PackedStringArray, reverse, sarray(), varray());
 	bind_method(PackedStringArray, slice, sarray("begin", "end"), varray(INT_MAX));
 	bind_method(PackedStringArray, to_byte_array, sarray(), varray());
-	bind_method(PackedStringArray, sort, sarray(), varray());
+	bind_functionnc(PackedStringArray, sort, _VariantCall::func_PackedArray_sort<String>, sarray(), varray());
 	bind_method(PackedStringArray, bsearch, sarray("value", "before"), varray(true));
 	bind_method(PackedStringArray, duplicate, sarray(), varray());
 	bind_method(PackedStringArray, find, sarray("value", "from"), varray(0));
@@ -2638,7 +2699,8 @@ void Variant::_register_variant_methods() {
 void Variant::_unregister_variant_methods() {
 	//clear methods
 	memdelete_arr(builtin_method_names);
-	memdelete_arr(builtin_method_info);
+	memdelete_arr(builtin_method_ids);
+	memdelete_arr(builtin_method_table);
 	memdelete_arr(_VariantCall::constant_data);
 	memdelete_arr(_VariantCall::enum_data);
 }
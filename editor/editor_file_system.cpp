@@ -32,13 +32,16 @@
 
 #include "core/config/project_settings.h"
 #include "core/extension/gdextension_manager.h"
+#include "core/io/config_file.h"
 #include "core/io/file_access.h"
 #include "core/io/resource_importer.h"
 #include "core/io/resource_loader.h"
 #include "core/io/resource_saver.h"
 #include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
+#include "core/os/time.h"
 #include "core/variant/variant_parser.h"
+#include "core/version.h"
 #include "editor/editor_help.h"
 #include "editor/editor_node.h"
 #include "editor/editor_paths.h"
@@ -1214,6 +1217,11 @@ void EditorFileSystem::scan_changes() {
 
 void EditorFileSystem::_notification(int p_what) {
 	switch (p_what) {
+		case NOTIFICATION_ENTER_TREE:
+		case EditorSettings::NOTIFICATION_EDITOR_SETTINGS_CHANGED: {
+			_update_import_cache_path();
+		} break;
+
 		case NOTIFICATION_EXIT_TREE: {
 			Thread &active_thread = thread.is_started() ? thread : thread_sources;
 			if (use_threads && active_thread.is_started()) {
@@ -2009,9 +2017,22 @@ Error EditorFileSystem::_reimport_file(const String &p_file, const HashMap<Strin
 	List<String> import_variants;
 	List<String> gen_files;
 	Variant meta;
-	Error err = importer->import(p_file, base_path, params, &import_variants, &gen_files, &meta);
 
-	ERR_FAIL_COND_V_MSG(err != OK, ERR_FILE_UNRECOGNIZED, "Error importing '" + p_file + "'.");
+	String cache_key;
+	if (!import_cache_path.is_empty() && importer->can_cache_import() && !importer->get_save_extension().is_empty()) {
+		cache_key = get_import_cache_key(p_file, importer, params, opts, generator_parameters);
+	}
+
+	Error err = OK;
+	if (cache_key.is_empty() || !import_from_cache(import_cache_path, cache_key, base_path, importer->get_save_extension(), &import_variants, &meta)) {
+		err = importer->import(p_file, base_path, params, &import_variants, &gen_files, &meta);
+
+		ERR_FAIL_COND_V_MSG(err != OK, ERR_FILE_UNRECOGNIZED, "Error importing '" + p_file + "'.");
+
+		if (!cache_key.is_empty() && gen_files.is_empty()) {
+			store_in_import_cache(import_cache_path, cache_key, base_path, importer->get_save_extension(), import_variants, meta);
+		}
+	}
 
 	//as import is complete, save the .import file
 
@@ -2148,6 +2169,178 @@ Error EditorFileSystem::_reimport_file(const String &p_file, const HashMap<Strin
 	return OK;
 }
 
+void EditorFileSystem::_update_import_cache_path() {
+	import_cache_path = EDITOR_GET("filesystem/import/use_shared_import_cache") ? EditorPaths::get_singleton()->get_cache_dir().path_join("import_cache") : String();
+}
+
+String EditorFileSystem::get_import_cache_key(const String &p_file, const Ref<ResourceImporter> &p_importer, const HashMap<StringName, Variant> &p_params, const List<ResourceImporter::ImportOption> &p_opts, const Variant &p_generator_parameters) {
+	// The source path is part of the key because imported files can reference others by path.
+	String key = String(VERSION_FULL_BUILD) + "\n" + p_file + "\n" + FileAccess::get_md5(p_file);
+	key += "\n" + p_importer->get_importer_name() + "\n" + itos(p_importer->get_format_version()) + "\n" + p_importer->get_import_settings_string();
+	for (const ResourceImporter::ImportOption &E : p_opts) {
+		String value;
+		const Variant *param = p_params.getptr(E.option.name);
+		if (param) {
+			VariantWriter::write_to_string(*param, value);
+		}
+		key += "\n" + String(E.option.name) + "=" + value;
+	}
+	if (p_generator_parameters != Variant()) {
+		key += "\n" + p_generator_parameters.get_construct_string();
+	}
+	return key.md5_text();
+}
+
+static Vector<String> _get_import_cache_suffixes(const String &p_extension, const Vector<String> &p_import_variants) {
+	Vector<String> suffixes;
+	if (p_import_variants.is_empty()) {
+		suffixes.push_back("." + p_extension);
+	}
+	for (const String &E : p_import_variants) {
+		suffixes.push_back("." + E + "." + p_extension);
+	}
+	return suffixes;
+}
+
+bool EditorFileSystem::import_from_cache(const String &p_cache_dir, const String &p_key, const String &p_base_path, const String &p_extension, List<String> *r_import_variants, Variant *r_metadata) {
+	String entry_dir = p_cache_dir.path_join(p_key);
+	Ref<ConfigFile> cf;
+	cf.instantiate();
+	if (cf->load(entry_dir.path_join("import.cfg")) != OK) {
+		return false;
+	}
+
+	Vector<String> import_variants = cf->get_value("import", "variants", Vector<String>());
+	Ref<DirAccess> da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	for (const String &E : _get_import_cache_suffixes(p_extension, import_variants)) {
+		if (da->copy(entry_dir.path_join("data" + E), ProjectSettings::get_singleton()->globalize_path(p_base_path + E)) != OK) {
+			return false;
+		}
+	}
+
+	for (const String &E : import_variants) {
+		r_import_variants->push_back(E);
+	}
+	*r_metadata = cf->get_value("import", "metadata", Variant());
+	_mark_import_cache_entry_used(entry_dir);
+	return true;
+}
+
+void EditorFileSystem::store_in_import_cache(const String &p_cache_dir, const String &p_key, const String &p_base_path, const String &p_extension, const List<String> &p_import_variants, const Variant &p_metadata) {
+	String entry_dir = p_cache_dir.path_join(p_key);
+	Ref<DirAccess> da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	if (da->dir_exists(entry_dir)) {
+		return;
+	}
+
+	// Written to a unique directory first, then renamed, so other editors never see an incomplete entry.
+	String tmp_dir = entry_dir + vformat(".%d.%d.tmp", OS::get_singleton()->get_process_id(), (uint64_t)Thread::get_caller_id());
+	ERR_FAIL_COND(da->make_dir_recursive(tmp_dir) != OK);
+
+	Vector<String> import_variants;
+	for (const String &E : p_import_variants) {
+		import_variants.push_back(E);
+	}
+
+	Vector<String> written;
+	bool ok = true;
+	for (const String &E : _get_import_cache_suffixes(p_extension, import_variants)) {
+		String dest = tmp_dir.path_join("data" + E);
+		ok = da->copy(ProjectSettings::get_singleton()->globalize_path(p_base_path + E), dest) == OK;
+		if (!ok) {
+			break;
+		}
+		written.push_back(dest);
+	}
+
+	if (ok) {
+		Ref<ConfigFile> cf;
+		cf.instantiate();
+		cf->set_value("import", "variants", import_variants);
+		cf->set_value("import", "metadata", p_metadata);
+		ok = cf->save(tmp_dir.path_join("import.cfg")) == OK;
+		written.push_back(tmp_dir.path_join("import.cfg"));
+	}
+
+	if (ok) {
+		ok = _mark_import_cache_entry_used(tmp_dir);
+		written.push_back(tmp_dir.path_join("last_used"));
+	}
+
+	if (ok && da->rename(tmp_dir, entry_dir) == OK) {
+		return;
+	}
+
+	// Failed, or another editor stored the same entry first.
+	for (const String &E : written) {
+		da->remove(E);
+	}
+	da->remove(tmp_dir);
+}
+
+bool EditorFileSystem::_mark_import_cache_entry_used(const String &p_entry_dir) {
+	// Stored in the file rather than its modification time, which is only precise to the second.
+	Ref<FileAccess> f = FileAccess::open(p_entry_dir.path_join("last_used"), FileAccess::WRITE);
+	if (f.is_null()) {
+		return false;
+	}
+	f->store_double(Time::get_singleton()->get_unix_time_from_system());
+	return true;
+}
+
+void EditorFileSystem::prune_import_cache(const String &p_cache_dir, uint64_t p_max_size) {
+	struct Entry {
+		String path;
+		double last_used = 0;
+		uint64_t size = 0;
+		bool operator<(const Entry &p_entry) const { return last_used < p_entry.last_used; }
+	};
+
+	Ref<DirAccess> da = DirAccess::open(p_cache_dir);
+	if (da.is_null()) {
+		return;
+	}
+
+	Vector<Entry> entries;
+	uint64_t total_size = 0;
+	for (const String &dir : da->get_directories()) {
+		if (dir.ends_with(".tmp")) {
+			continue; // Being written by an editor.
+		}
+
+		Entry entry;
+		entry.path = p_cache_dir.path_join(dir);
+		for (const String &file : DirAccess::get_files_at(entry.path)) {
+			Ref<FileAccess> f = FileAccess::open(entry.path.path_join(file), FileAccess::READ);
+			if (f.is_null()) {
+				continue;
+			}
+			entry.size += f->get_length();
+			if (file == "last_used") {
+				entry.last_used = f->get_double();
+			}
+		}
+		total_size += entry.size;
+		entries.push_back(entry);
+	}
+
+	if (total_size <= p_max_size) {
+		return;
+	}
+
+	// Remove the least recently used entries first.
+	entries.sort();
+	for (const Entry &entry : entries) {
+		if (total_size <= p_max_size) {
+			break;
+		}
+		Ref<DirAccess> entry_da = DirAccess::open(entry.path);
+		if (entry_da.is_valid() && entry_da->erase_contents_recursive() == OK && da->remove(entry.path) == OK) {
+			total_size -= entry.size;
+		}
+	}
+}
+
 void EditorFileSystem::_find_group_files(EditorFileSystemDirectory *efd, HashMap<String, Vector<String>> &group_files, HashSet<String> &groups_to_reimport) {
 	int fc = efd->files.size();
 	const EditorFileSystemDirectory::FileInfo *const *files = efd->files.ptr();
@@ -2170,8 +2363,8 @@ void EditorFileSystem::reimport_file_with_custom_parameters(const String &p_file
 }
 
 void EditorFileSystem::_reimport_thread(uint32_t p_index, ImportThreadData *p_import_data) {
-	p_import_data->max_index = MAX(p_import_data->reimport_from + int(p_index), p_import_data->max_index);
-	_reimport_file(p_import_data->reimport_files[p_import_data->reimport_from + p_index].path);
+	_reimport_file(p_import_data->reimport_files[p_import_data->indices[p_index]].path);
+	p_import_data->imported_count.increment();
 }
 
 void EditorFileSystem::reimport_files(const Vector<String> &p_files) {
@@ -2227,56 +2420,81 @@ void EditorFileSystem::reimport_files(const Vector<String> &p_files) {
 
 	bool use_multiple_threads = GLOBAL_GET("editor/import/use_multiple_threads");
 
-	int from = 0;
-	for (int i = 0; i < reimport_files.size(); i++) {
-		if (groups_to_reimport.has(reimport_files[i].path)) {
-			continue;
+	// Files are imported by order, so the resources others depend on (like textures used by scenes) are
+	// imported first. Within the same order, files of importers that support it are imported on the
+	// WorkerThreadPool, after the others are imported on this thread. Importers only expect their own
+	// files to be imported at the same time, so each importer gets a group task of its own.
+	int level_from = 0;
+	while (level_from < reimport_files.size()) {
+		int level_to = level_from + 1;
+		while (level_to < reimport_files.size() && reimport_files[level_to].order == reimport_files[level_from].order) {
+			level_to++;
+		}
+
+		// Files are sorted by importer within an order, so each importer's files are contiguous.
+		LocalVector<LocalVector<int>> threaded_indices;
+		LocalVector<int> main_indices;
+		for (int i = level_from; i < level_to; i++) {
+			if (groups_to_reimport.has(reimport_files[i].path)) {
+				continue;
+			}
+			if (use_multiple_threads && reimport_files[i].threaded) {
+				if (threaded_indices.is_empty() || reimport_files[threaded_indices[threaded_indices.size() - 1][0]].importer != reimport_files[i].importer) {
+					threaded_indices.push_back(LocalVector<int>());
+				}
+				threaded_indices[threaded_indices.size() - 1].push_back(i);
+			} else {
+				main_indices.push_back(i);
+			}
 		}
 
-		if (use_multiple_threads && reimport_files[i].threaded) {
-			if (i + 1 == reimport_files.size() || reimport_files[i + 1].importer != reimport_files[from].importer) {
-				if (from - i == 0) {
-					// Single file, do not use threads.
-					pr.step(reimport_files[i].path.get_file(), i);
-					_reimport_file(reimport_files[i].path);
-				} else {
-					Ref<ResourceImporter> importer = ResourceFormatImporter::get_singleton()->get_importer_by_name(reimport_files[from].importer);
-					ERR_CONTINUE(!importer.is_valid());
-
-					importer->import_threaded_begin();
-
-					ImportThreadData tdata;
-					tdata.max_index = from;
-					tdata.reimport_from = from;
-					tdata.reimport_files = reimport_files.ptr();
-
-					WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &EditorFileSystem::_reimport_thread, &tdata, i - from + 1, -1, false, vformat(TTR("Import resources of type: %s"), reimport_files[from].importer));
-					int current_index = from - 1;
-					do {
-						if (current_index < tdata.max_index) {
-							current_index = tdata.max_index;
-							pr.step(reimport_files[current_index].path.get_file(), current_index);
-						}
-						OS::get_singleton()->delay_usec(1);
-					} while (!WorkerThreadPool::get_singleton()->is_group_task_completed(group_task));
+		// Importers that can't import in threads may rely on being the only ones importing, so they run before the others.
+		int level_step = level_from;
+		for (int index : main_indices) {
+			pr.step(reimport_files[index].path.get_file(), level_step++);
+			_reimport_file(reimport_files[index].path);
+		}
+
+		for (const LocalVector<int> &indices : threaded_indices) {
+			if (indices.size() == 1) {
+				// Single file, do not use threads.
+				pr.step(reimport_files[indices[0]].path.get_file(), level_step++);
+				_reimport_file(reimport_files[indices[0]].path);
+				continue;
+			}
+
+			Ref<ResourceImporter> importer = ResourceFormatImporter::get_singleton()->get_importer_by_name(reimport_files[indices[0]].importer);
+			ERR_CONTINUE(!importer.is_valid());
+
+			importer->import_threaded_begin();
 
-					WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+			ImportThreadData tdata;
+			tdata.reimport_files = reimport_files.ptr();
+			tdata.indices = indices.ptr();
 
-					importer->import_threaded_end();
+			WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &EditorFileSystem::_reimport_thread, &tdata, indices.size(), -1, false, vformat(TTR("Import resources of type: %s"), reimport_files[indices[0]].importer));
+			uint32_t stepped = 0;
+			do {
+				uint32_t imported = tdata.imported_count.get();
+				if (imported > stepped) {
+					stepped = imported;
+					pr.step(reimport_files[indices[imported - 1]].path.get_file(), level_step + imported - 1);
 				}
+				OS::get_singleton()->delay_usec(1);
+			} while (!WorkerThreadPool::get_singleton()->is_group_task_completed(group_task));
 
-				from = i + 1;
-			}
+			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
 
-		} else {
-			pr.step(reimport_files[i].path.get_file(), i);
-			_reimport_file(reimport_files[i].path);
+			importer->import_threaded_end();
+			level_step += indices.size();
 		}
+
+		level_from = level_to;
 	}
 
 	// Reimport groups.
 
-	from = reimport_files.size();
+	int from = reimport_files.size();
 
 	if (groups_to_reimport.size()) {
 		HashMap<String, Vector<String>> group_files;
@@ -2294,6 +2512,10 @@ void EditorFileSystem::reimport_files(const Vector<String> &p_files) {
 
 	ResourceUID::get_singleton()->update_cache(); // After reimporting, update the cache.
 
+	if (!import_cache_path.is_empty()) {
+		prune_import_cache(import_cache_path, (uint64_t)(int64_t)EDITOR_GET("filesystem/import/shared_import_cache_max_size_mb") * 1024 * 1024);
+	}
+
 	_save_filesystem_cache();
 	importing = false;
 	if (!is_scanning()) {
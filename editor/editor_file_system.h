@@ -32,6 +32,7 @@
 #define EDITOR_FILE_SYSTEM_H
 
 #include "core/io/dir_access.h"
+#include "core/io/resource_importer.h"
 #include "core/os/thread.h"
 #include "core/os/thread_safe.h"
 #include "core/templates/hash_set.h"
@@ -281,12 +282,17 @@ class EditorFileSystem : public Node {
 
 	struct ImportThreadData {
 		const ImportFile *reimport_files;
-		int reimport_from;
-		int max_index = 0;
+		const int *indices;
+		SafeNumeric<uint32_t> imported_count;
 	};
 
 	void _reimport_thread(uint32_t p_index, ImportThreadData *p_import_data);
 
+	// Imported files are shared between projects on this machine, by source path and content and import options.
+	String import_cache_path; // Empty when the shared import cache is disabled.
+	void _update_import_cache_path();
+	static bool _mark_import_cache_entry_used(const String &p_entry_dir);
+
 	static ResourceUID::ID _resource_saver_get_resource_id_for_path(const String &p_path, bool p_generate);
 
 	bool _scan_extensions();
@@ -324,6 +330,11 @@ public:
 
 	static bool _should_skip_directory(const String &p_path);
 
+	static String get_import_cache_key(const String &p_file, const Ref<ResourceImporter> &p_importer, const HashMap<StringName, Variant> &p_params, const List<ResourceImporter::ImportOption> &p_opts, const Variant &p_generator_parameters);
+	static bool import_from_cache(const String &p_cache_dir, const String &p_key, const String &p_base_path, const String &p_extension, List<String> *r_import_variants, Variant *r_metadata);
+	static void store_in_import_cache(const String &p_cache_dir, const String &p_key, const String &p_base_path, const String &p_extension, const List<String> &p_import_variants, const Variant &p_metadata);
+	static void prune_import_cache(const String &p_cache_dir, uint64_t p_max_size);
+
 	void add_import_format_support_query(Ref<EditorFileSystemImportFormatSupportQuery> p_query);
 	void remove_import_format_support_query(Ref<EditorFileSystemImportFormatSupportQuery> p_query);
 	EditorFileSystem();
@@ -494,6 +494,10 @@ void EditorSettings::_load_defaults(Ref<ConfigFile> p_extra_config) {
 	EDITOR_SETTING(Variant::INT, PROPERTY_HINT_ENUM, "filesystem/file_dialog/display_mode", 0, "Thumbnails,List")
 	EDITOR_SETTING(Variant::INT, PROPERTY_HINT_RANGE, "filesystem/file_dialog/thumbnail_size", 64, "32,128,16")
 
+	// Import
+	_initial_set("filesystem/import/use_shared_import_cache", false);
+	EDITOR_SETTING(Variant::INT, PROPERTY_HINT_RANGE, "filesystem/import/shared_import_cache_max_size_mb", 2048, "64,65536,1,or_greater")
+
 	/* Docks */
 
 	// SceneTree
@@ -83,6 +83,7 @@ void EditorExport::_save() {
 		config->set_value(section, "encryption_exclude_filters", preset->get_enc_ex_filter());
 		config->set_value(section, "encrypt_pck", preset->get_enc_pck());
 		config->set_value(section, "encrypt_directory", preset->get_enc_directory());
+		config->set_value(section, "compress_pck", preset->get_compress_pck());
 		config->set_value(section, "script_encryption_key", preset->get_script_encryption_key());
 
 		String option_section = "preset." + itos(i) + ".options";
@@ -278,6 +279,9 @@ void EditorExport::load_config() {
 		if (config->has_section_key(section, "encrypt_directory")) {
 			preset->set_enc_directory(config->get_value(section, "encrypt_directory"));
 		}
+		if (config->has_section_key(section, "compress_pck")) {
+			preset->set_compress_pck(config->get_value(section, "compress_pck"));
+		}
 		if (config->has_section_key(section, "encryption_include_filters")) {
 			preset->set_enc_in_filter(config->get_value(section, "encryption_include_filters"));
 		}
@@ -210,6 +210,15 @@ Error EditorExportPlatform::_save_pack_file(void *p_userdata, const String &p_pa
 		}
 	}
 
+	Vector<uint8_t> compressed_data;
+	if (pd->compress) {
+		compressed_data = FileAccessPack::compress_data(p_data.ptr(), p_data.size());
+		if (!compressed_data.is_empty()) {
+			sd.compressed = true;
+			sd.size = compressed_data.size();
+		}
+	}
+
 	Ref<FileAccessEncrypted> fae;
 	Ref<FileAccess> ftmp = pd->f;
 
@@ -223,7 +232,11 @@ Error EditorExportPlatform::_save_pack_file(void *p_userdata, const String &p_pa
 	}
 
 	// Store file content.
-	ftmp->store_buffer(p_data.ptr(), p_data.size());
+	if (sd.compressed) {
+		ftmp->store_buffer(compressed_data.ptr(), compressed_data.size());
+	} else {
+		ftmp->store_buffer(p_data.ptr(), p_data.size());
+	}
 
 	if (fae.is_valid()) {
 		ftmp.unref();
@@ -1490,6 +1503,7 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, b
 	PackData pd;
 	pd.ep = &ep;
 	pd.f = ftmp;
+	pd.compress = p_preset->get_compress_pck();
 	pd.so_files = p_so_files;
 
 	Error err = export_project_files(p_preset, p_debug, _save_pack_file, &pd, _add_shared_object);
@@ -1541,8 +1555,13 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, b
 
 	int64_t pck_start_pos = f->get_position();
 
+	bool has_compressed_files = false;
+	for (const SavedData &E : pd.file_ofs) {
+		has_compressed_files = has_compressed_files || E.compressed;
+	}
+
 	f->store_32(PACK_HEADER_MAGIC);
-	f->store_32(PACK_FORMAT_VERSION);
+	f->store_32(has_compressed_files ? PACK_FORMAT_VERSION : PACK_FORMAT_VERSION_UNCOMPRESSED);
 	f->store_32(VERSION_MAJOR);
 	f->store_32(VERSION_MINOR);
 	f->store_32(VERSION_PATCH);
@@ -1629,6 +1648,9 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, b
 		if (pd.file_ofs[i].encrypted) {
 			flags |= PACK_FILE_ENCRYPTED;
 		}
+		if (pd.file_ofs[i].compressed) {
+			flags |= PACK_FILE_COMPRESSED;
+		}
 		fhead->store_32(flags);
 	}
 
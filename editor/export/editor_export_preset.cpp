@@ -285,6 +285,15 @@ bool EditorExportPreset::get_enc_directory() const {
 	return enc_directory;
 }
 
+void EditorExportPreset::set_compress_pck(bool p_enabled) {
+	compress_pck = p_enabled;
+	EditorExport::singleton->save_presets();
+}
+
+bool EditorExportPreset::get_compress_pck() const {
+	return compress_pck;
+}
+
 void EditorExportPreset::set_script_encryption_key(const String &p_key) {
 	script_key = p_key;
 	EditorExport::singleton->save_presets();
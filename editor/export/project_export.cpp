@@ -245,6 +245,7 @@ void ProjectExportDialog::_edit_preset(int p_index) {
 	export_filter->select(current->get_export_filter());
 	include_filters->set_text(current->get_include_filter());
 	exclude_filters->set_text(current->get_exclude_filter());
+	compress_pck->set_pressed(current->get_compress_pck());
 	server_strip_message->set_visible(current->get_export_filter() == EditorExportPreset::EXPORT_CUSTOMIZED);
 
 	_fill_resource_tree();
@@ -724,6 +725,19 @@ void ProjectExportDialog::_filter_changed(const String &p_filter) {
 	current->set_exclude_filter(exclude_filters->get_text());
 }
 
+void ProjectExportDialog::_compress_pck_changed(bool p_pressed) {
+	if (updating) {
+		return;
+	}
+
+	Ref<EditorExportPreset> current = get_current_preset();
+	if (current.is_null()) {
+		return;
+	}
+
+	current->set_compress_pck(p_pressed);
+}
+
 void ProjectExportDialog::_fill_resource_tree() {
 	include_files->clear();
 	include_label->hide();
@@ -1231,6 +1245,12 @@ ProjectExportDialog::ProjectExportDialog() {
 			exclude_filters);
 	exclude_filters->connect("text_changed", callable_mp(this, &ProjectExportDialog::_filter_changed));
 
+	compress_pck = memnew(CheckButton);
+	compress_pck->set_text(TTR("Compress Exported PCK"));
+	compress_pck->set_tooltip_text(TTR("Store files compressed in the PCK, unless that wouldn't make them smaller.\nThe PCK can't be loaded by Godot versions that predate this option."));
+	compress_pck->connect("toggled", callable_mp(this, &ProjectExportDialog::_compress_pck_changed));
+	resources_vb->add_child(compress_pck);
+
 	// Feature tags.
 
 	VBoxContainer *feature_vb = memnew(VBoxContainer);
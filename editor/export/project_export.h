@@ -75,6 +75,7 @@ private:
 	OptionButton *export_filter = nullptr;
 	LineEdit *include_filters = nullptr;
 	LineEdit *exclude_filters = nullptr;
+	CheckButton *compress_pck = nullptr;
 	Tree *include_files = nullptr;
 	Label *server_strip_message = nullptr;
 	PopupMenu *file_mode_popup = nullptr;
@@ -115,6 +116,7 @@ private:
 
 	void _export_type_changed(int p_which);
 	void _filter_changed(const String &p_filter);
+	void _compress_pck_changed(bool p_pressed);
 	void _fill_resource_tree();
 	void _setup_item_for_file_mode(TreeItem *p_item, EditorExportPreset::FileExportMode p_mode);
 	bool _fill_tree(EditorFileSystemDirectory *p_dir, TreeItem *p_item, Ref<EditorExportPreset> &current, EditorExportPreset::ExportFilter p_export_filter);
@@ -294,6 +294,7 @@ public:
 	virtual void show_advanced_options(const String &p_path) override;
 
 	virtual bool can_import_threaded() const override { return false; }
+	virtual bool can_cache_import() const override { return false; } // Can save meshes, materials and animations to files set in the options.
 
 	ResourceImporterScene(bool p_animation_import = false);
 
@@ -3037,6 +3037,9 @@ bool Main::iteration() {
 
 	iterating++;
 
+	// Scratch memory handed out during the previous frame is no longer in use.
+	FrameAllocator::reset();
+
 	const uint64_t ticks = OS::get_singleton()->get_ticks_usec();
 	Engine::get_singleton()->_frame_ticks = ticks;
 	main_timer_sync.set_cpu_ticks_usec(ticks);
@@ -3107,11 +3110,15 @@ bool Main::iteration() {
 
 		message_queue->flush();
 
-		PhysicsServer3D::get_singleton()->end_sync();
-		PhysicsServer3D::get_singleton()->step(physics_step * time_scale);
+		{
+			MEMORY_CATEGORY_SCOPE(CATEGORY_PHYSICS);
+
+			PhysicsServer3D::get_singleton()->end_sync();
+			PhysicsServer3D::get_singleton()->step(physics_step * time_scale);
 
-		PhysicsServer2D::get_singleton()->end_sync();
-		PhysicsServer2D::get_singleton()->step(physics_step * time_scale);
+			PhysicsServer2D::get_singleton()->end_sync();
+			PhysicsServer2D::get_singleton()->step(physics_step * time_scale);
+		}
 
 		message_queue->flush();
 
@@ -85,6 +85,15 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(NAVIGATION_EDGE_MERGE_COUNT);
 	BIND_ENUM_CONSTANT(NAVIGATION_EDGE_CONNECTION_COUNT);
 	BIND_ENUM_CONSTANT(NAVIGATION_EDGE_FREE_COUNT);
+	BIND_ENUM_CONSTANT(MEMORY_RESOURCES);
+	BIND_ENUM_CONSTANT(MEMORY_SCRIPTS);
+	BIND_ENUM_CONSTANT(MEMORY_RENDERING);
+	BIND_ENUM_CONSTANT(MEMORY_PHYSICS);
+	BIND_ENUM_CONSTANT(MEMORY_STRINGS);
+	BIND_ENUM_CONSTANT(MEMORY_VARIANT_CONTAINERS);
+	BIND_ENUM_CONSTANT(MEMORY_OTHER);
+	BIND_ENUM_CONSTANT(OBJECT_MESSAGE_QUEUE_LAST_FLUSH_COUNT);
+	BIND_ENUM_CONSTANT(TIME_MESSAGE_QUEUE_FLUSH);
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
 
@@ -133,6 +142,15 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		"navigation/edges_merged",
 		"navigation/edges_connected",
 		"navigation/edges_free",
+		"memory/resources",
+		"memory/scripts",
+		"memory/rendering",
+		"memory/physics",
+		"memory/strings",
+		"memory/variant_containers",
+		"memory/other",
+		"object/message_queue_last_flush_count",
+		"time/message_queue_flush",
 
 	};
 
@@ -207,6 +225,24 @@ double Performance::get_monitor(Monitor p_monitor) const {
 			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_EDGE_CONNECTION_COUNT);
 		case NAVIGATION_EDGE_FREE_COUNT:
 			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_EDGE_FREE_COUNT);
+		case MEMORY_RESOURCES:
+			return Memory::get_mem_usage(Memory::CATEGORY_RESOURCES);
+		case MEMORY_SCRIPTS:
+			return Memory::get_mem_usage(Memory::CATEGORY_SCRIPTS);
+		case MEMORY_RENDERING:
+			return Memory::get_mem_usage(Memory::CATEGORY_RENDERING);
+		case MEMORY_PHYSICS:
+			return Memory::get_mem_usage(Memory::CATEGORY_PHYSICS);
+		case MEMORY_STRINGS:
+			return Memory::get_mem_usage(Memory::CATEGORY_STRINGS);
+		case MEMORY_VARIANT_CONTAINERS:
+			return Memory::get_mem_usage(Memory::CATEGORY_VARIANT_CONTAINERS);
+		case MEMORY_OTHER:
+			return Memory::get_mem_usage(Memory::CATEGORY_OTHER);
+		case OBJECT_MESSAGE_QUEUE_LAST_FLUSH_COUNT:
+			return MessageQueue::get_singleton()->get_last_flush_message_count();
+		case TIME_MESSAGE_QUEUE_FLUSH:
+			return MessageQueue::get_singleton()->get_last_flush_usec() / 1000000.0;
 
 		default: {
 		}
@@ -252,6 +288,15 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_TIME,
 
 	};
 
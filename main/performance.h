@@ -100,6 +100,15 @@ public:
 		NAVIGATION_EDGE_MERGE_COUNT,
 		NAVIGATION_EDGE_CONNECTION_COUNT,
 		NAVIGATION_EDGE_FREE_COUNT,
+		MEMORY_RESOURCES,
+		MEMORY_SCRIPTS,
+		MEMORY_RENDERING,
+		MEMORY_PHYSICS,
+		MEMORY_STRINGS,
+		MEMORY_VARIANT_CONTAINERS,
+		MEMORY_OTHER,
+		OBJECT_MESSAGE_QUEUE_LAST_FLUSH_COUNT,
+		TIME_MESSAGE_QUEUE_FLUSH,
 		MONITOR_MAX
 	};
 
@@ -816,6 +816,7 @@ Error GDScript::reload(bool p_keep_state) {
 	if (reloading) {
 		return OK;
 	}
+	MEMORY_CATEGORY_SCOPE(CATEGORY_SCRIPTS);
 	reloading = true;
 
 	bool has_instances;
@@ -1941,6 +1942,7 @@ GDScriptInstance::~GDScriptInstance() {
 /************* SCRIPT LANGUAGE **************/
 
 GDScriptLanguage *GDScriptLanguage::singleton = nullptr;
+thread_local GDScriptLanguage::FuncStateStackPool GDScriptLanguage::func_state_stack_pool;
 
 String GDScriptLanguage::get_name() const {
 	return "GDScript";
@@ -2590,9 +2592,32 @@ GDScriptLanguage::GDScriptLanguage() {
 }
 
 GDScriptLanguage::~GDScriptLanguage() {
+	for (uint32_t i = 0; i < FUNC_STATE_STACK_POOL_CLASSES; i++) {
+		func_state_stack_pool.stacks[i].reset();
+	}
 	singleton = nullptr;
 }
 
+Vector<uint8_t> GDScriptLanguage::acquire_func_state_stack(int p_size) {
+	Vector<uint8_t> stack;
+	uint32_t size_class = nearest_shift(next_power_of_2(p_size)) - 1;
+	if (size_class < FUNC_STATE_STACK_POOL_CLASSES && !func_state_stack_pool.stacks[size_class].is_empty()) {
+		LocalVector<Vector<uint8_t>> &stacks = func_state_stack_pool.stacks[size_class];
+		stack = stacks[stacks.size() - 1];
+		stacks.resize(stacks.size() - 1);
+	}
+	stack.resize(p_size);
+	return stack;
+}
+
+void GDScriptLanguage::release_func_state_stack(Vector<uint8_t> &r_stack) {
+	uint32_t size_class = nearest_shift(next_power_of_2(r_stack.size())) - 1;
+	if (!r_stack.is_empty() && size_class < FUNC_STATE_STACK_POOL_CLASSES && func_state_stack_pool.stacks[size_class].size() < FUNC_STATE_STACK_POOL_MAX) {
+		func_state_stack_pool.stacks[size_class].push_back(r_stack);
+	}
+	r_stack.clear();
+}
+
 void GDScriptLanguage::add_orphan_subclass(const String &p_qualified_name, const ObjectID &p_subclass) {
 	orphan_subclasses[p_qualified_name] = p_subclass;
 }
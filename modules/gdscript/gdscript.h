@@ -37,6 +37,7 @@
 #include "core/io/resource_loader.h"
 #include "core/io/resource_saver.h"
 #include "core/object/script_language.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/rb_set.h"
 #include "gdscript_function.h"
 
@@ -375,6 +376,16 @@ class GDScriptLanguage : public ScriptLanguage {
 	friend class GDScriptFunction;
 
 	SelfList<GDScriptFunction>::List function_list;
+
+	// Stack buffers of finished GDScriptFunctionStates, reused to avoid allocating a new one on every `await`.
+	// Pools are per thread, so no lock is taken, and per power of 2 size class, so a reused buffer is never reallocated.
+	static const uint32_t FUNC_STATE_STACK_POOL_CLASSES = 15; // Up to 16 KiB, larger stacks are freed.
+	static const uint32_t FUNC_STATE_STACK_POOL_MAX = 16; // Per size class.
+	struct FuncStateStackPool {
+		LocalVector<Vector<uint8_t>> stacks[FUNC_STATE_STACK_POOL_CLASSES];
+	};
+	static thread_local FuncStateStackPool func_state_stack_pool;
+
 	bool profiling;
 	uint64_t script_frame_time;
 
@@ -467,6 +478,9 @@ public:
 
 	_FORCE_INLINE_ static GDScriptLanguage *get_singleton() { return singleton; }
 
+	static Vector<uint8_t> acquire_func_state_stack(int p_size);
+	static void release_func_state_stack(Vector<uint8_t> &r_stack);
+
 	virtual String get_name() const override;
 
 	/* LANGUAGE FUNCTIONS */
@@ -30,6 +30,7 @@
 
 #include "gdscript_function.h"
 
+#include "core/templates/hashfuncs.h"
 #include "gdscript.h"
 
 const int *GDScriptFunction::get_code() const {
@@ -170,26 +171,31 @@ GDScriptFunction::~GDScriptFunction() {
 
 /////////////////////
 
-Variant GDScriptFunctionState::_signal_callback(const Variant **p_args, int p_argcount, Callable::CallError &r_error) {
+Variant GDScriptFunctionState::_resume_with_signal_args(const Variant **p_args, int p_argcount) {
 	Variant arg;
-	r_error.error = Callable::CallError::CALL_OK;
 
-	if (p_argcount == 0) {
-		r_error.error = Callable::CallError::CALL_ERROR_TOO_FEW_ARGUMENTS;
-		r_error.argument = 1;
-		return Variant();
-	} else if (p_argcount == 1) {
-		//noooneee
-	} else if (p_argcount == 2) {
+	if (p_argcount == 1) {
 		arg = *p_args[0];
-	} else {
+	} else if (p_argcount > 1) {
 		Array extra_args;
-		for (int i = 0; i < p_argcount - 1; i++) {
+		for (int i = 0; i < p_argcount; i++) {
 			extra_args.push_back(*p_args[i]);
 		}
 		arg = extra_args;
 	}
 
+	return resume(arg);
+}
+
+Variant GDScriptFunctionState::_signal_callback(const Variant **p_args, int p_argcount, Callable::CallError &r_error) {
+	r_error.error = Callable::CallError::CALL_OK;
+
+	if (p_argcount == 0) {
+		r_error.error = Callable::CallError::CALL_ERROR_TOO_FEW_ARGUMENTS;
+		r_error.argument = 1;
+		return Variant();
+	}
+
 	Ref<GDScriptFunctionState> self = *p_args[p_argcount - 1];
 
 	if (self.is_null()) {
@@ -199,7 +205,7 @@ Variant GDScriptFunctionState::_signal_callback(const Variant **p_args, int p_ar
 		return Variant();
 	}
 
-	return resume(arg);
+	return _resume_with_signal_args(p_args, p_argcount - 1);
 }
 
 bool GDScriptFunctionState::is_valid(bool p_extended_check) const {
@@ -277,11 +283,14 @@ Variant GDScriptFunctionState::resume(const Variant &p_arg) {
 		if (EngineDebugger::is_active()) {
 			GDScriptLanguage::get_singleton()->exit_function();
 		}
-
-		_clear_stack();
 #endif
 	}
 
+	// The call above only frees the stack if it reached the end of the function or awaited again,
+	// so anything left must be destroyed before the buffer is reused by the next `await`.
+	_clear_stack();
+	GDScriptLanguage::release_func_state_stack(state.stack);
+
 	return ret;
 }
 
@@ -325,3 +334,52 @@ GDScriptFunctionState::~GDScriptFunctionState() {
 		instances_list.remove_from_list();
 	}
 }
+
+/////////////////////
+
+bool GDScriptFunctionStateCallable::compare_equal(const CallableCustom *p_a, const CallableCustom *p_b) {
+	// Resume callables are only compared by reference.
+	return p_a == p_b;
+}
+
+bool GDScriptFunctionStateCallable::compare_less(const CallableCustom *p_a, const CallableCustom *p_b) {
+	// Resume callables are only compared by reference.
+	return p_a < p_b;
+}
+
+uint32_t GDScriptFunctionStateCallable::hash() const {
+	return h;
+}
+
+String GDScriptFunctionStateCallable::get_as_text() const {
+#ifdef DEBUG_ENABLED
+	return String(state->state.function_name) + "(await)";
+#else
+	return "(await)";
+#endif
+}
+
+CallableCustom::CompareEqualFunc GDScriptFunctionStateCallable::get_compare_equal_func() const {
+	return compare_equal;
+}
+
+CallableCustom::CompareLessFunc GDScriptFunctionStateCallable::get_compare_less_func() const {
+	return compare_less;
+}
+
+ObjectID GDScriptFunctionStateCallable::get_object() const {
+	return state->get_instance_id();
+}
+
+void GDScriptFunctionStateCallable::call(const Variant **p_arguments, int p_argcount, Variant &r_return_value, Callable::CallError &r_call_error) const {
+	r_call_error.error = Callable::CallError::CALL_OK;
+	// Keep the state alive while resuming, the connection owning this callable may be removed meanwhile.
+	Ref<GDScriptFunctionState> keep = state;
+	r_return_value = keep->_resume_with_signal_args(p_arguments, p_argcount);
+}
+
+GDScriptFunctionStateCallable::GDScriptFunctionStateCallable(const Ref<GDScriptFunctionState> &p_state) {
+	state = p_state;
+
+	h = (uint32_t)hash_murmur3_one_64((uint64_t)this);
+}
@@ -0,0 +1,20 @@
+signal no_arguments
+signal one_argument(value)
+signal two_arguments(first, second)
+
+
+func wait_for_signals(iteration: int) -> void:
+	await no_arguments
+	var value = await one_argument
+	var values = await two_arguments
+	prints(iteration, value, values)
+
+
+func test():
+	# Every iteration suspends and resumes several times, reusing the saved stack frames.
+	for i in 3:
+		wait_for_signals(i)
+		no_arguments.emit()
+		one_argument.emit(i * 10)
+		two_arguments.emit(i, i + 1)
+	print("end")
@@ -569,6 +569,14 @@ bool SceneMultiplayer::is_object_decoding_allowed() const {
 	return allow_object_decoding;
 }
 
+void SceneMultiplayer::set_bulk_container_encoding_enabled(bool p_enabled) {
+	bulk_container_encoding = p_enabled;
+}
+
+bool SceneMultiplayer::is_bulk_container_encoding_enabled() const {
+	return bulk_container_encoding;
+}
+
 String SceneMultiplayer::get_rpc_md5(const Object *p_obj) {
 	return rpc->get_rpc_md5(p_obj);
 }
@@ -637,6 +645,8 @@ void SceneMultiplayer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_refusing_new_connections"), &SceneMultiplayer::is_refusing_new_connections);
 	ClassDB::bind_method(D_METHOD("set_allow_object_decoding", "enable"), &SceneMultiplayer::set_allow_object_decoding);
 	ClassDB::bind_method(D_METHOD("is_object_decoding_allowed"), &SceneMultiplayer::is_object_decoding_allowed);
+	ClassDB::bind_method(D_METHOD("set_bulk_container_encoding_enabled", "enabled"), &SceneMultiplayer::set_bulk_container_encoding_enabled);
+	ClassDB::bind_method(D_METHOD("is_bulk_container_encoding_enabled"), &SceneMultiplayer::is_bulk_container_encoding_enabled);
 	ClassDB::bind_method(D_METHOD("set_server_relay_enabled", "enabled"), &SceneMultiplayer::set_server_relay_enabled);
 	ClassDB::bind_method(D_METHOD("is_server_relay_enabled"), &SceneMultiplayer::is_server_relay_enabled);
 	ClassDB::bind_method(D_METHOD("send_bytes", "bytes", "id", "mode", "channel"), &SceneMultiplayer::send_bytes, DEFVAL(MultiplayerPeer::TARGET_PEER_BROADCAST), DEFVAL(MultiplayerPeer::TRANSFER_MODE_RELIABLE), DEFVAL(0));
@@ -645,6 +655,7 @@ void SceneMultiplayer::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::CALLABLE, "auth_callback"), "set_auth_callback", "get_auth_callback");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "auth_timeout", PROPERTY_HINT_RANGE, "0,30,0.1,or_greater,suffix:s"), "set_auth_timeout", "get_auth_timeout");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "allow_object_decoding"), "set_allow_object_decoding", "is_object_decoding_allowed");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "bulk_container_encoding"), "set_bulk_container_encoding_enabled", "is_bulk_container_encoding_enabled");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "refuse_new_connections"), "set_refuse_new_connections", "is_refusing_new_connections");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "server_relay"), "set_server_relay_enabled", "is_server_relay_enabled");
 
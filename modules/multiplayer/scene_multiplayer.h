@@ -121,6 +121,7 @@ private:
 
 	NodePath root_path;
 	bool allow_object_decoding = false;
+	bool bulk_container_encoding = false;
 	bool server_relay = true;
 	Ref<StreamPeerBuffer> relay_buffer;
 
@@ -192,6 +193,9 @@ public:
 	void set_allow_object_decoding(bool p_enable);
 	bool is_object_decoding_allowed() const;
 
+	void set_bulk_container_encoding_enabled(bool p_enabled);
+	bool is_bulk_container_encoding_enabled() const;
+
 	void set_server_relay_enabled(bool p_enabled);
 	bool is_server_relay_enabled() const;
 
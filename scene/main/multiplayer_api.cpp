@@ -69,7 +69,7 @@ Ref<MultiplayerAPI> MultiplayerAPI::create_default_interface() {
 #define ENCODE_16 1 << 6
 #define ENCODE_32 2 << 6
 #define ENCODE_64 3 << 6
-Error MultiplayerAPI::encode_and_compress_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_allow_object_decoding) {
+Error MultiplayerAPI::encode_and_compress_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_allow_object_decoding, bool p_bulk_containers) {
 	// Unreachable because `VARIANT_MAX` == 38 and `ENCODE_VARIANT_MASK` == 77
 	CRASH_COND(p_variant.get_type() > VARIANT_META_TYPE_MASK);
 
@@ -130,7 +130,7 @@ Error MultiplayerAPI::encode_and_compress_variant(const Variant &p_variant, uint
 		} break;
 		default:
 			// Any other case is not yet compressed.
-			Error err = encode_variant(p_variant, r_buffer, r_len, p_allow_object_decoding);
+			Error err = encode_variant(p_variant, r_buffer, r_len, p_allow_object_decoding, p_bulk_containers);
 			if (err != OK) {
 				return err;
 			}
@@ -212,7 +212,7 @@ Error MultiplayerAPI::decode_and_decompress_variant(Variant &r_variant, const ui
 	return OK;
 }
 
-Error MultiplayerAPI::encode_and_compress_variants(const Variant **p_variants, int p_count, uint8_t *p_buffer, int &r_len, bool *r_raw, bool p_allow_object_decoding) {
+Error MultiplayerAPI::encode_and_compress_variants(const Variant **p_variants, int p_count, uint8_t *p_buffer, int &r_len, bool *r_raw, bool p_allow_object_decoding, bool p_bulk_containers) {
 	r_len = 0;
 	int size = 0;
 
@@ -235,7 +235,7 @@ Error MultiplayerAPI::encode_and_compress_variants(const Variant **p_variants, i
 			}
 			r_len += pba.size();
 		} else {
-			encode_and_compress_variant(v, p_buffer, size, p_allow_object_decoding);
+			encode_and_compress_variant(v, p_buffer, size, p_allow_object_decoding, p_bulk_containers);
 			r_len += size;
 		}
 		return OK;
@@ -244,7 +244,7 @@ Error MultiplayerAPI::encode_and_compress_variants(const Variant **p_variants, i
 	// Regular encoding.
 	for (int i = 0; i < p_count; i++) {
 		const Variant &v = *(p_variants[i]);
-		encode_and_compress_variant(v, p_buffer ? p_buffer + r_len : nullptr, size, p_allow_object_decoding);
+		encode_and_compress_variant(v, p_buffer ? p_buffer + r_len : nullptr, size, p_allow_object_decoding, p_bulk_containers);
 		r_len += size;
 	}
 	return OK;
@@ -305,18 +305,19 @@ void Mesh::generate_debug_mesh_lines(Vector<Vector3> &r_lines) {
 
 	const int *ind_r = triangle_indices.ptr();
 	const Vector3 *ver_r = vertices.ptr();
+	Vector3 *lines_w = debug_lines.ptrw();
 	for (int j = 0, x = 0, i = 0; i < triangles_num; j += 6, x += 3, ++i) {
 		// Triangle line 1
-		debug_lines.write[j + 0] = ver_r[ind_r[x + 0]];
-		debug_lines.write[j + 1] = ver_r[ind_r[x + 1]];
+		lines_w[j + 0] = ver_r[ind_r[x + 0]];
+		lines_w[j + 1] = ver_r[ind_r[x + 1]];
 
 		// Triangle line 2
-		debug_lines.write[j + 2] = ver_r[ind_r[x + 1]];
-		debug_lines.write[j + 3] = ver_r[ind_r[x + 2]];
+		lines_w[j + 2] = ver_r[ind_r[x + 1]];
+		lines_w[j + 3] = ver_r[ind_r[x + 2]];
 
 		// Triangle line 3
-		debug_lines.write[j + 4] = ver_r[ind_r[x + 2]];
-		debug_lines.write[j + 5] = ver_r[ind_r[x + 0]];
+		lines_w[j + 4] = ver_r[ind_r[x + 2]];
+		lines_w[j + 5] = ver_r[ind_r[x + 0]];
 	}
 
 	r_lines = debug_lines;
@@ -328,13 +329,7 @@ void Mesh::generate_debug_mesh_indices(Vector<Vector3> &r_points) {
 		return;
 	}
 
-	Vector<Vector3> vertices = tm->get_vertices();
-
-	int vertices_size = vertices.size();
-	r_points.resize(vertices_size);
-	for (int i = 0; i < vertices_size; ++i) {
-		r_points.write[i] = vertices[i];
-	}
+	r_points = tm->get_vertices();
 }
 
 Vector<Face3> Mesh::get_faces() const {
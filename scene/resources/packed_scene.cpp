@@ -35,6 +35,7 @@
 #include "core/core_string_names.h"
 #include "core/io/missing_resource.h"
 #include "core/io/resource_loader.h"
+#include "core/os/os.h"
 #include "core/templates/local_vector.h"
 #include "scene/2d/node_2d.h"
 #include "scene/3d/node_3d.h"
@@ -70,356 +71,452 @@ static Array _sanitize_node_pinned_properties(Node *p_node) {
 	return pinned;
 }
 
-Node *SceneState::instantiate(GenEditState p_edit_state) const {
-	// Nodes where instantiation failed (because something is missing.)
-	List<Node *> stray_instances;
-
 #define NODE_FROM_ID(p_name, p_id)                      \
 	Node *p_name;                                       \
 	if (p_id & FLAG_ID_IS_PATH) {                       \
 		NodePath np = node_paths[p_id & FLAG_MASK];     \
 		p_name = ret_nodes[0]->get_node_or_null(np);    \
 	} else {                                            \
-		ERR_FAIL_INDEX_V(p_id &FLAG_MASK, nc, nullptr); \
+		ERR_FAIL_INDEX_V(p_id &FLAG_MASK, nc, false);   \
 		p_name = ret_nodes[p_id & FLAG_MASK];           \
 	}
 
-	int nc = nodes.size();
-	ERR_FAIL_COND_V(nc == 0, nullptr);
+Node *SceneState::instantiate(GenEditState p_edit_state) const {
+	InstantiationState state;
+	if (!_instantiate_begin(state, p_edit_state)) {
+		return nullptr;
+	}
 
-	const StringName *snames = nullptr;
-	int sname_count = names.size();
-	if (sname_count) {
-		snames = &names[0];
+	while (state.next_node < nodes.size()) {
+		if (!_instantiate_node(state)) {
+			return nullptr;
+		}
 	}
 
-	const Variant *props = nullptr;
-	int prop_count = variants.size();
-	if (prop_count) {
-		props = &variants[0];
+	if (!_instantiate_end(state)) {
+		return nullptr;
 	}
 
-	//Vector<Variant> properties;
+	return state.nodes[0];
+}
 
-	const NodeData *nd = &nodes[0];
+bool SceneState::_instantiate_begin(InstantiationState &r_state, GenEditState p_edit_state) const {
+	int nc = nodes.size();
+	ERR_FAIL_COND_V(nc == 0, false);
 
-	Node **ret_nodes = (Node **)alloca(sizeof(Node *) * nc);
+	r_state.edit_state = p_edit_state;
+	r_state.nodes.resize(nc);
+	for (int i = 0; i < nc; i++) {
+		r_state.nodes[i] = nullptr;
+	}
+	r_state.gen_node_path_cache = p_edit_state != GEN_EDIT_STATE_DISABLED && node_path_cache.is_empty();
+	r_state.next_node = 0;
 
-	bool gen_node_path_cache = p_edit_state != GEN_EDIT_STATE_DISABLED && node_path_cache.is_empty();
+	// The editor needs Object::set() to track edits, and isn't instantiating in a hot loop anyway.
+	r_state.use_plan = p_edit_state == GEN_EDIT_STATE_DISABLED && !Engine::get_singleton()->is_editor_hint();
+	if (r_state.use_plan) {
+		MutexLock lock(instantiation_plan_mutex);
+		if (!instantiation_plan_valid) {
+			_build_instantiation_plan();
+		}
+	}
 
-	HashMap<Ref<Resource>, Ref<Resource>> resources_local_to_scene;
+	return true;
+}
 
-	LocalVector<DeferredNodePathProperties> deferred_node_paths;
+void SceneState::_build_instantiation_plan() const {
+	int nc = nodes.size();
+	instantiation_plan.clear();
+	instantiation_plan.resize(nc);
 
 	for (int i = 0; i < nc; i++) {
-		const NodeData &n = nd[i];
+		const NodeData &n = nodes[i];
+		NodePlan &plan = instantiation_plan[i];
+
+		bool created_from_class = n.instance < 0 && n.type != TYPE_INSTANTIATED && !(i == 0 && base_scene_idx >= 0);
+		if (!created_from_class || n.type < 0 || n.type >= names.size()) {
+			continue;
+		}
 
-		Node *parent = nullptr;
-		String old_parent_path;
+		const StringName &class_name = names[n.type];
+		plan.creation_func = ClassDB::get_native_creation_func(class_name);
+		if (!plan.creation_func) {
+			continue;
+		}
 
-		if (i > 0) {
-			ERR_FAIL_COND_V_MSG(n.parent == -1, nullptr, vformat("Invalid scene: node %s does not specify its parent node.", snames[n.name]));
-			NODE_FROM_ID(nparent, n.parent);
-#ifdef DEBUG_ENABLED
-			if (!nparent && (n.parent & FLAG_ID_IS_PATH)) {
-				WARN_PRINT(String("Parent path '" + String(node_paths[n.parent & FLAG_MASK]) + "' for node '" + String(snames[n.name]) + "' has vanished when instantiating: '" + get_path() + "'.").ascii().get_data());
-				old_parent_path = String(node_paths[n.parent & FLAG_MASK]).trim_prefix("./").replace("/", "@");
-				nparent = ret_nodes[0];
+		plan.properties.resize(n.properties.size());
+		for (int j = 0; j < n.properties.size(); j++) {
+			int name_idx = n.properties[j].name;
+			if (name_idx < 0 || name_idx >= names.size() || names[name_idx] == CoreStringNames::get_singleton()->_script) {
+				continue; // Node path properties have the flag set, so they're skipped as well.
 			}
+			plan.properties[j].setter = ClassDB::get_property_setter_bind(class_name, names[name_idx], &plan.properties[j].index);
+		}
+	}
+
+	instantiation_plan_valid = true;
+}
+
+void SceneState::_invalidate_instantiation_plan() {
+	MutexLock lock(instantiation_plan_mutex);
+	instantiation_plan.clear();
+	instantiation_plan_valid = false;
+}
+
+bool SceneState::_instantiate_node(InstantiationState &r_state) const {
+	int nc = nodes.size();
+	ERR_FAIL_INDEX_V(r_state.next_node, nc, false);
+	ERR_FAIL_COND_V((int)r_state.nodes.size() != nc, false);
+
+	const StringName *snames = names.ptr();
+	int sname_count = names.size();
+
+	const Variant *props = variants.ptr();
+	int prop_count = variants.size();
+
+	Node **ret_nodes = r_state.nodes.ptr();
+
+	const int i = r_state.next_node++;
+	const NodeData &n = nodes[i];
+
+	Node *parent = nullptr;
+	String old_parent_path;
+
+	if (i > 0) {
+		ERR_FAIL_COND_V_MSG(n.parent == -1, false, vformat("Invalid scene: node %s does not specify its parent node.", snames[n.name]));
+		NODE_FROM_ID(nparent, n.parent);
+#ifdef DEBUG_ENABLED
+		if (!nparent && (n.parent & FLAG_ID_IS_PATH)) {
+			WARN_PRINT(String("Parent path '" + String(node_paths[n.parent & FLAG_MASK]) + "' for node '" + String(snames[n.name]) + "' has vanished when instantiating: '" + get_path() + "'.").ascii().get_data());
+			old_parent_path = String(node_paths[n.parent & FLAG_MASK]).trim_prefix("./").replace("/", "@");
+			nparent = ret_nodes[0];
+		}
 #endif
-			parent = nparent;
-		} else {
-			// i == 0 is root node.
-			ERR_FAIL_COND_V_MSG(n.parent != -1, nullptr, vformat("Invalid scene: root node %s cannot specify a parent node.", snames[n.name]));
-			ERR_FAIL_COND_V_MSG(n.type == TYPE_INSTANTIATED && base_scene_idx < 0, nullptr, vformat("Invalid scene: root node %s in an instance, but there's no base scene.", snames[n.name]));
-		}
-
-		Node *node = nullptr;
-		MissingNode *missing_node = nullptr;
-
-		if (i == 0 && base_scene_idx >= 0) {
-			//scene inheritance on root node
-			Ref<PackedScene> sdata = props[base_scene_idx];
-			ERR_FAIL_COND_V(!sdata.is_valid(), nullptr);
-			node = sdata->instantiate(p_edit_state == GEN_EDIT_STATE_DISABLED ? PackedScene::GEN_EDIT_STATE_DISABLED : PackedScene::GEN_EDIT_STATE_INSTANCE); //only main gets main edit state
-			ERR_FAIL_COND_V(!node, nullptr);
-			if (p_edit_state != GEN_EDIT_STATE_DISABLED) {
-				node->set_scene_inherited_state(sdata->get_state());
-			}
+		parent = nparent;
+	} else {
+		// i == 0 is root node.
+		ERR_FAIL_COND_V_MSG(n.parent != -1, false, vformat("Invalid scene: root node %s cannot specify a parent node.", snames[n.name]));
+		ERR_FAIL_COND_V_MSG(n.type == TYPE_INSTANTIATED && base_scene_idx < 0, false, vformat("Invalid scene: root node %s in an instance, but there's no base scene.", snames[n.name]));
+	}
+
+	Node *node = nullptr;
+	MissingNode *missing_node = nullptr;
+	const NodePlan *plan = nullptr;
+
+	if (i == 0 && base_scene_idx >= 0) {
+		//scene inheritance on root node
+		Ref<PackedScene> sdata = props[base_scene_idx];
+		ERR_FAIL_COND_V(!sdata.is_valid(), false);
+		node = sdata->instantiate(r_state.edit_state == GEN_EDIT_STATE_DISABLED ? PackedScene::GEN_EDIT_STATE_DISABLED : PackedScene::GEN_EDIT_STATE_INSTANCE); //only main gets main edit state
+		ERR_FAIL_COND_V(!node, false);
+		if (r_state.edit_state != GEN_EDIT_STATE_DISABLED) {
+			node->set_scene_inherited_state(sdata->get_state());
+		}
 
-		} else if (n.instance >= 0) {
-			//instance a scene into this node
-			if (n.instance & FLAG_INSTANCE_IS_PLACEHOLDER) {
-				String scene_path = props[n.instance & FLAG_MASK];
-				if (disable_placeholders) {
-					Ref<PackedScene> sdata = ResourceLoader::load(scene_path, "PackedScene");
-					ERR_FAIL_COND_V(!sdata.is_valid(), nullptr);
-					node = sdata->instantiate(p_edit_state == GEN_EDIT_STATE_DISABLED ? PackedScene::GEN_EDIT_STATE_DISABLED : PackedScene::GEN_EDIT_STATE_INSTANCE);
-					ERR_FAIL_COND_V(!node, nullptr);
-				} else {
-					InstancePlaceholder *ip = memnew(InstancePlaceholder);
-					ip->set_instance_path(scene_path);
-					node = ip;
-				}
-				node->set_scene_instance_load_placeholder(true);
+	} else if (n.instance >= 0) {
+		//instance a scene into this node
+		if (n.instance & FLAG_INSTANCE_IS_PLACEHOLDER) {
+			String scene_path = props[n.instance & FLAG_MASK];
+			if (disable_placeholders) {
+				Ref<PackedScene> sdata = ResourceLoader::load(scene_path, "PackedScene");
+				ERR_FAIL_COND_V(!sdata.is_valid(), false);
+				node = sdata->instantiate(r_state.edit_state == GEN_EDIT_STATE_DISABLED ? PackedScene::GEN_EDIT_STATE_DISABLED : PackedScene::GEN_EDIT_STATE_INSTANCE);
+				ERR_FAIL_COND_V(!node, false);
 			} else {
-				Ref<PackedScene> sdata = props[n.instance & FLAG_MASK];
-				ERR_FAIL_COND_V(!sdata.is_valid(), nullptr);
-				node = sdata->instantiate(p_edit_state == GEN_EDIT_STATE_DISABLED ? PackedScene::GEN_EDIT_STATE_DISABLED : PackedScene::GEN_EDIT_STATE_INSTANCE);
-				ERR_FAIL_COND_V(!node, nullptr);
+				InstancePlaceholder *ip = memnew(InstancePlaceholder);
+				ip->set_instance_path(scene_path);
+				node = ip;
 			}
+			node->set_scene_instance_load_placeholder(true);
+		} else {
+			Ref<PackedScene> sdata = props[n.instance & FLAG_MASK];
+			ERR_FAIL_COND_V(!sdata.is_valid(), false);
+			node = sdata->instantiate(r_state.edit_state == GEN_EDIT_STATE_DISABLED ? PackedScene::GEN_EDIT_STATE_DISABLED : PackedScene::GEN_EDIT_STATE_INSTANCE);
+			ERR_FAIL_COND_V(!node, false);
+		}
 
-		} else if (n.type == TYPE_INSTANTIATED) {
-			//get the node from somewhere, it likely already exists from another instance
-			if (parent) {
-				node = parent->_get_child_by_name(snames[n.name]);
+	} else if (n.type == TYPE_INSTANTIATED) {
+		//get the node from somewhere, it likely already exists from another instance
+		if (parent) {
+			node = parent->_get_child_by_name(snames[n.name]);
 #ifdef DEBUG_ENABLED
-				if (!node) {
-					WARN_PRINT(String("Node '" + String(ret_nodes[0]->get_path_to(parent)) + "/" + String(snames[n.name]) + "' was modified from inside an instance, but it has vanished.").ascii().get_data());
-				}
-#endif
+			if (!node) {
+				WARN_PRINT(String("Node '" + String(ret_nodes[0]->get_path_to(parent)) + "/" + String(snames[n.name]) + "' was modified from inside an instance, but it has vanished.").ascii().get_data());
 			}
+#endif
+		}
+	} else {
+		//node belongs to this scene and must be created
+		Object *obj = nullptr;
+		if (r_state.use_plan && (int)instantiation_plan.size() == nc && instantiation_plan[i].creation_func) {
+			plan = &instantiation_plan[i];
+			obj = plan->creation_func();
 		} else {
-			//node belongs to this scene and must be created
-			Object *obj = ClassDB::instantiate(snames[n.type]);
+			obj = ClassDB::instantiate(snames[n.type]);
+		}
 
-			node = Object::cast_to<Node>(obj);
+		node = Object::cast_to<Node>(obj);
 
-			if (!node) {
-				if (obj) {
-					memdelete(obj);
-					obj = nullptr;
-				}
+		if (!node) {
+			if (obj) {
+				memdelete(obj);
+				obj = nullptr;
+			}
 
-				if (ResourceLoader::is_creating_missing_resources_if_class_unavailable_enabled()) {
-					missing_node = memnew(MissingNode);
-					missing_node->set_original_class(snames[n.type]);
-					missing_node->set_recording_properties(true);
-					node = missing_node;
-					obj = missing_node;
-				} else {
-					WARN_PRINT(vformat("Node %s of type %s cannot be created. A placeholder will be created instead.", snames[n.name], snames[n.type]).ascii().get_data());
-					if (n.parent >= 0 && n.parent < nc && ret_nodes[n.parent]) {
-						if (Object::cast_to<Control>(ret_nodes[n.parent])) {
-							obj = memnew(Control);
-						} else if (Object::cast_to<Node2D>(ret_nodes[n.parent])) {
-							obj = memnew(Node2D);
+			if (ResourceLoader::is_creating_missing_resources_if_class_unavailable_enabled()) {
+				missing_node = memnew(MissingNode);
+				missing_node->set_original_class(snames[n.type]);
+				missing_node->set_recording_properties(true);
+				node = missing_node;
+				obj = missing_node;
+			} else {
+				WARN_PRINT(vformat("Node %s of type %s cannot be created. A placeholder will be created instead.", snames[n.name], snames[n.type]).ascii().get_data());
+				if (n.parent >= 0 && n.parent < nc && ret_nodes[n.parent]) {
+					if (Object::cast_to<Control>(ret_nodes[n.parent])) {
+						obj = memnew(Control);
+					} else if (Object::cast_to<Node2D>(ret_nodes[n.parent])) {
+						obj = memnew(Node2D);
 #ifndef _3D_DISABLED
-						} else if (Object::cast_to<Node3D>(ret_nodes[n.parent])) {
-							obj = memnew(Node3D);
+					} else if (Object::cast_to<Node3D>(ret_nodes[n.parent])) {
+						obj = memnew(Node3D);
 #endif // _3D_DISABLED
-						}
-					}
-
-					if (!obj) {
-						obj = memnew(Node);
 					}
+				}
 
-					node = Object::cast_to<Node>(obj);
+				if (!obj) {
+					obj = memnew(Node);
 				}
+
+				node = Object::cast_to<Node>(obj);
 			}
 		}
+	}
 
-		if (node) {
-			// may not have found the node (part of instantiated scene and removed)
-			// if found all is good, otherwise ignore
+	if (node) {
+		// may not have found the node (part of instantiated scene and removed)
+		// if found all is good, otherwise ignore
 
-			//properties
-			int nprop_count = n.properties.size();
-			if (nprop_count) {
-				const NodeData::Property *nprops = &n.properties[0];
+		//properties
+		int nprop_count = n.properties.size();
+		if (nprop_count) {
+			const NodeData::Property *nprops = &n.properties[0];
 
-				Dictionary missing_resource_properties;
+			Dictionary missing_resource_properties;
 
-				for (int j = 0; j < nprop_count; j++) {
-					bool valid;
+			for (int j = 0; j < nprop_count; j++) {
+				bool valid;
 
-					ERR_FAIL_INDEX_V(nprops[j].value, prop_count, nullptr);
+				ERR_FAIL_INDEX_V(nprops[j].value, prop_count, false);
 
-					if (nprops[j].name & FLAG_PATH_PROPERTY_IS_NODE) {
-						uint32_t name_idx = nprops[j].name & (FLAG_PATH_PROPERTY_IS_NODE - 1);
-						ERR_FAIL_UNSIGNED_INDEX_V(name_idx, (uint32_t)sname_count, nullptr);
-						if (Engine::get_singleton()->is_editor_hint()) {
-							// If editor, just set the metadata and be it
-							node->set(META_POINTER_PROPERTY_BASE + String(snames[name_idx]), props[nprops[j].value]);
-						} else {
-							// Do an actual deferred sed of the property path.
-							DeferredNodePathProperties dnp;
-							dnp.path = props[nprops[j].value];
-							dnp.base = node;
-							dnp.property = snames[name_idx];
-							deferred_node_paths.push_back(dnp);
-						}
-						continue;
+				if (nprops[j].name & FLAG_PATH_PROPERTY_IS_NODE) {
+					uint32_t name_idx = nprops[j].name & (FLAG_PATH_PROPERTY_IS_NODE - 1);
+					ERR_FAIL_UNSIGNED_INDEX_V(name_idx, (uint32_t)sname_count, false);
+					if (Engine::get_singleton()->is_editor_hint()) {
+						// If editor, just set the metadata and be it
+						node->set(META_POINTER_PROPERTY_BASE + String(snames[name_idx]), props[nprops[j].value]);
+					} else {
+						// Do an actual deferred sed of the property path.
+						DeferredNodePathProperties dnp;
+						dnp.path = props[nprops[j].value];
+						dnp.base = node;
+						dnp.property = snames[name_idx];
+						r_state.deferred_node_paths.push_back(dnp);
 					}
+					continue;
+				}
 
-					ERR_FAIL_INDEX_V(nprops[j].name, sname_count, nullptr);
+				ERR_FAIL_INDEX_V(nprops[j].name, sname_count, false);
 
-					if (snames[nprops[j].name] == CoreStringNames::get_singleton()->_script) {
-						//work around to avoid old script variables from disappearing, should be the proper fix to:
-						//https://github.com/godotengine/godot/issues/2958
+				if (snames[nprops[j].name] == CoreStringNames::get_singleton()->_script) {
+					//work around to avoid old script variables from disappearing, should be the proper fix to:
+					//https://github.com/godotengine/godot/issues/2958
 
-						//store old state
-						List<Pair<StringName, Variant>> old_state;
-						if (node->get_script_instance()) {
-							node->get_script_instance()->get_property_state(old_state);
-						}
+					//store old state
+					List<Pair<StringName, Variant>> old_state;
+					if (node->get_script_instance()) {
+						node->get_script_instance()->get_property_state(old_state);
+					}
 
-						node->set(snames[nprops[j].name], props[nprops[j].value], &valid);
+					node->set(snames[nprops[j].name], props[nprops[j].value], &valid);
 
-						//restore old state for new script, if exists
-						for (const Pair<StringName, Variant> &E : old_state) {
-							node->set(E.first, E.second);
-						}
-					} else {
-						Variant value = props[nprops[j].value];
-
-						if (value.get_type() == Variant::OBJECT) {
-							//handle resources that are local to scene by duplicating them if needed
-							Ref<Resource> res = value;
-							if (res.is_valid()) {
-								if (res->is_local_to_scene()) {
-									// In a situation where a local-to-scene resource is used in a child node of a non-editable instance,
-									// we need to avoid the parent scene from overriding the resource potentially also used in the root
-									// of the instantiated scene. That would to the instance having two different instances of the resource.
-									// Since at this point it's too late to propagate the resource instance in the parent scene to all the relevant
-									// nodes in the instance (and that would require very complex bookkepping), what we do instead is
-									// tampering the resource object already there with the values from the node in the parent scene and
-									// then tell this node to reference that resource.
-									if (n.instance >= 0) {
-										Ref<Resource> node_res = node->get(snames[nprops[j].name]);
-										if (node_res.is_valid()) {
-											node_res->copy_from(res);
-											node_res->configure_for_local_scene(node, resources_local_to_scene);
-											value = node_res;
-										}
+					//restore old state for new script, if exists
+					for (const Pair<StringName, Variant> &E : old_state) {
+						node->set(E.first, E.second);
+					}
+				} else {
+					Variant value = props[nprops[j].value];
+
+					if (value.get_type() == Variant::OBJECT) {
+						//handle resources that are local to scene by duplicating them if needed
+						Ref<Resource> res = value;
+						if (res.is_valid()) {
+							if (res->is_local_to_scene()) {
+								// In a situation where a local-to-scene resource is used in a child node of a non-editable instance,
+								// we need to avoid the parent scene from overriding the resource potentially also used in the root
+								// of the instantiated scene. That would to the instance having two different instances of the resource.
+								// Since at this point it's too late to propagate the resource instance in the parent scene to all the relevant
+								// nodes in the instance (and that would require very complex bookkepping), what we do instead is
+								// tampering the resource object already there with the values from the node in the parent scene and
+								// then tell this node to reference that resource.
+								if (n.instance >= 0) {
+									Ref<Resource> node_res = node->get(snames[nprops[j].name]);
+									if (node_res.is_valid()) {
+										node_res->copy_from(res);
+										node_res->configure_for_local_scene(node, r_state.resources_local_to_scene);
+										value = node_res;
+									}
+								} else {
+									HashMap<Ref<Resource>, Ref<Resource>>::Iterator E = r_state.resources_local_to_scene.find(res);
+									Node *base = i == 0 ? node : ret_nodes[0];
+									if (E) {
+										value = E->value;
 									} else {
-										HashMap<Ref<Resource>, Ref<Resource>>::Iterator E = resources_local_to_scene.find(res);
-										Node *base = i == 0 ? node : ret_nodes[0];
-										if (E) {
-											value = E->value;
+										if (r_state.edit_state == GEN_EDIT_STATE_MAIN) {
+											//for the main scene, use the resource as is
+											res->configure_for_local_scene(base, r_state.resources_local_to_scene);
+											r_state.resources_local_to_scene[res] = res;
 										} else {
-											if (p_edit_state == GEN_EDIT_STATE_MAIN) {
-												//for the main scene, use the resource as is
-												res->configure_for_local_scene(base, resources_local_to_scene);
-												resources_local_to_scene[res] = res;
-											} else {
-												//for instances, a copy must be made
-												Ref<Resource> local_dupe = res->duplicate_for_local_scene(base, resources_local_to_scene);
-												resources_local_to_scene[res] = local_dupe;
-												value = local_dupe;
-											}
+											//for instances, a copy must be made
+											Ref<Resource> local_dupe = res->duplicate_for_local_scene(base, r_state.resources_local_to_scene);
+											r_state.resources_local_to_scene[res] = local_dupe;
+											value = local_dupe;
 										}
 									}
-									//must make a copy, because this res is local to scene
 								}
+								//must make a copy, because this res is local to scene
 							}
 						}
-						if (value.get_type() == Variant::ARRAY) {
-							Array set_array = value;
-							bool is_get_valid = false;
-							Variant get_value = node->get(snames[nprops[j].name], &is_get_valid);
-							if (is_get_valid && get_value.get_type() == Variant::ARRAY) {
-								Array get_array = get_value;
-								if (!set_array.is_same_typed(get_array)) {
-									value = Array(set_array, get_array.get_typed_builtin(), get_array.get_typed_class_name(), get_array.get_typed_script());
-								}
+					}
+					if (value.get_type() == Variant::ARRAY) {
+						Array set_array = value;
+						bool is_get_valid = false;
+						Variant get_value = node->get(snames[nprops[j].name], &is_get_valid);
+						if (is_get_valid && get_value.get_type() == Variant::ARRAY) {
+							Array get_array = get_value;
+							if (!set_array.is_same_typed(get_array)) {
+								value = Array(set_array, get_array.get_typed_builtin(), get_array.get_typed_class_name(), get_array.get_typed_script());
 							}
 						}
-						if (p_edit_state == GEN_EDIT_STATE_INSTANCE && value.get_type() != Variant::OBJECT) {
-							value = value.duplicate(true); // Duplicate arrays and dictionaries for the editor
-						}
+					}
+					if (r_state.edit_state == GEN_EDIT_STATE_INSTANCE && value.get_type() != Variant::OBJECT) {
+						value = value.duplicate(true); // Duplicate arrays and dictionaries for the editor
+					}
 
-						bool set_valid = true;
-						if (ResourceLoader::is_creating_missing_resources_if_class_unavailable_enabled() && value.get_type() == Variant::OBJECT) {
-							Ref<MissingResource> mr = value;
-							if (mr.is_valid()) {
-								missing_resource_properties[snames[nprops[j].name]] = mr;
-								set_valid = false;
-							}
+					bool set_valid = true;
+					if (ResourceLoader::is_creating_missing_resources_if_class_unavailable_enabled() && value.get_type() == Variant::OBJECT) {
+						Ref<MissingResource> mr = value;
+						if (mr.is_valid()) {
+							missing_resource_properties[snames[nprops[j].name]] = mr;
+							set_valid = false;
 						}
+					}
 
-						if (set_valid) {
+					if (set_valid) {
+						const PropertyPlan *property_plan = plan && !node->get_script_instance() ? &plan->properties[j] : nullptr;
+						if (property_plan && property_plan->setter) {
+							// Same as what Object::set() ends up doing for a native property, without the lookups.
+							Callable::CallError ce;
+							if (property_plan->index >= 0) {
+								Variant index = property_plan->index;
+								const Variant *args[2] = { &index, &value };
+								property_plan->setter->call(node, args, 2, ce);
+							} else {
+								const Variant *args[1] = { &value };
+								property_plan->setter->call(node, args, 1, ce);
+							}
+						} else {
 							node->set(snames[nprops[j].name], value, &valid);
 						}
 					}
 				}
-				if (!missing_resource_properties.is_empty()) {
-					node->set_meta(META_MISSING_RESOURCES, missing_resource_properties);
-				}
 			}
+			if (!missing_resource_properties.is_empty()) {
+				node->set_meta(META_MISSING_RESOURCES, missing_resource_properties);
+			}
+		}
 
-			//name
+		//name
 
-			//groups
-			for (int j = 0; j < n.groups.size(); j++) {
-				ERR_FAIL_INDEX_V(n.groups[j], sname_count, nullptr);
-				node->add_to_group(snames[n.groups[j]], true);
-			}
+		//groups
+		for (int j = 0; j < n.groups.size(); j++) {
+			ERR_FAIL_INDEX_V(n.groups[j], sname_count, false);
+			node->add_to_group(snames[n.groups[j]], true);
+		}
 
-			if (n.instance >= 0 || n.type != TYPE_INSTANTIATED || i == 0) {
-				//if node was not part of instance, must set its name, parenthood and ownership
-				if (i > 0) {
-					if (parent) {
-						parent->_add_child_nocheck(node, snames[n.name]);
-						if (n.index >= 0 && n.index < parent->get_child_count() - 1) {
-							parent->move_child(node, n.index);
-						}
-					} else {
-						//it may be possible that an instantiated scene has changed
-						//and the node has nowhere to go anymore
-						stray_instances.push_back(node); //can't be added, go to stray list
+		if (n.instance >= 0 || n.type != TYPE_INSTANTIATED || i == 0) {
+			//if node was not part of instance, must set its name, parenthood and ownership
+			if (i > 0) {
+				if (parent) {
+					parent->_add_child_nocheck(node, snames[n.name]);
+					if (n.index >= 0 && n.index < parent->get_child_count() - 1) {
+						parent->move_child(node, n.index);
 					}
 				} else {
-					if (Engine::get_singleton()->is_editor_hint()) {
-						//validate name if using editor, to avoid broken
-						node->set_name(snames[n.name]);
-					} else {
-						node->_set_name_nocheck(snames[n.name]);
-					}
+					//it may be possible that an instantiated scene has changed
+					//and the node has nowhere to go anymore
+					r_state.stray_instances.push_back(node); //can't be added, go to stray list
+				}
+			} else {
+				if (Engine::get_singleton()->is_editor_hint()) {
+					//validate name if using editor, to avoid broken
+					node->set_name(snames[n.name]);
+				} else {
+					node->_set_name_nocheck(snames[n.name]);
 				}
 			}
+		}
 
-			if (!old_parent_path.is_empty()) {
-				node->_set_name_nocheck(old_parent_path + "@" + node->get_name());
-			}
+		if (!old_parent_path.is_empty()) {
+			node->_set_name_nocheck(old_parent_path + "@" + node->get_name());
+		}
 
-			if (n.owner >= 0) {
-				NODE_FROM_ID(owner, n.owner);
-				if (owner) {
-					node->_set_owner_nocheck(owner);
-					if (node->data.unique_name_in_owner) {
-						node->_acquire_unique_name_in_owner();
-					}
+		if (n.owner >= 0) {
+			NODE_FROM_ID(owner, n.owner);
+			if (owner) {
+				node->_set_owner_nocheck(owner);
+				if (node->data.unique_name_in_owner) {
+					node->_acquire_unique_name_in_owner();
 				}
 			}
-
-			// We only want to deal with pinned flag if instantiating as pure main (no instance, no inheriting.)
-			if (p_edit_state == GEN_EDIT_STATE_MAIN) {
-				_sanitize_node_pinned_properties(node);
-			} else {
-				node->remove_meta("_edit_pinned_properties_");
-			}
 		}
 
-		if (missing_node) {
-			missing_node->set_recording_properties(false);
+		// We only want to deal with pinned flag if instantiating as pure main (no instance, no inheriting.)
+		if (r_state.edit_state == GEN_EDIT_STATE_MAIN) {
+			_sanitize_node_pinned_properties(node);
+		} else {
+			node->remove_meta("_edit_pinned_properties_");
 		}
+	}
 
-		ret_nodes[i] = node;
+	if (missing_node) {
+		missing_node->set_recording_properties(false);
+	}
 
-		if (node && gen_node_path_cache && ret_nodes[0]) {
-			NodePath n2 = ret_nodes[0]->get_path_to(node);
-			node_path_cache[n2] = i;
-		}
+	ret_nodes[i] = node;
+
+	if (node && r_state.gen_node_path_cache && ret_nodes[0]) {
+		NodePath n2 = ret_nodes[0]->get_path_to(node);
+		node_path_cache[n2] = i;
 	}
 
-	for (const DeferredNodePathProperties &dnp : deferred_node_paths) {
+	return true;
+}
+
+bool SceneState::_instantiate_end(InstantiationState &r_state) const {
+	int nc = nodes.size();
+	ERR_FAIL_COND_V(r_state.next_node != nc, false);
+
+	const StringName *snames = names.ptr();
+	const Variant *props = variants.ptr();
+
+	Node **ret_nodes = r_state.nodes.ptr();
+
+	for (const DeferredNodePathProperties &dnp : r_state.deferred_node_paths) {
 		Node *other = dnp.base->get_node_or_null(dnp.path);
 		dnp.base->set(dnp.property, other);
 	}
 
-	for (KeyValue<Ref<Resource>, Ref<Resource>> &E : resources_local_to_scene) {
+	for (KeyValue<Ref<Resource>, Ref<Resource>> &E : r_state.resources_local_to_scene) {
 		if (E.value->get_local_scene() == ret_nodes[0]) {
 			E.value->setup_local_to_scene();
 		}
@@ -461,15 +558,15 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 			callable = callable.bindp(argptrs, binds.size());
 		}
 
-		cfrom->connect(snames[c.signal], callable, CONNECT_PERSIST | c.flags | (p_edit_state == GEN_EDIT_STATE_MAIN ? 0 : CONNECT_INHERITED));
+		cfrom->connect(snames[c.signal], callable, CONNECT_PERSIST | c.flags | (r_state.edit_state == GEN_EDIT_STATE_MAIN ? 0 : CONNECT_INHERITED));
 	}
 
 	//Node *s = ret_nodes[0];
 
 	//remove nodes that could not be added, likely as a result that
-	while (stray_instances.size()) {
-		memdelete(stray_instances.front()->get());
-		stray_instances.pop_front();
+	while (r_state.stray_instances.size()) {
+		memdelete(r_state.stray_instances.front()->get());
+		r_state.stray_instances.pop_front();
 	}
 
 	for (int i = 0; i < editable_instances.size(); i++) {
@@ -479,7 +576,7 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 		}
 	}
 
-	return ret_nodes[0];
+	return true;
 }
 
 static int _nm_get_string(const String &p_string, HashMap<StringName, int> &name_map) {
@@ -1006,6 +1103,7 @@ String SceneState::get_path() const {
 }
 
 void SceneState::clear() {
+	_invalidate_instantiation_plan();
 	names.clear();
 	variants.clear();
 	nodes.clear();
@@ -1221,6 +1319,8 @@ void SceneState::set_bundled_scene(const Dictionary &p_dictionary) {
 
 	ERR_FAIL_COND_MSG(version > PACKED_SCENE_VERSION, "Save format version too new.");
 
+	_invalidate_instantiation_plan();
+
 	const int node_count = p_dictionary["node_count"];
 	const Vector<int> snodes = p_dictionary["nodes"];
 	ERR_FAIL_COND(snodes.size() < node_count);
@@ -1684,6 +1784,7 @@ int SceneState::add_node(int p_parent, int p_owner, int p_type, int p_name, int
 	nd.index = p_index;
 
 	nodes.push_back(nd);
+	_invalidate_instantiation_plan();
 
 	return nodes.size() - 1;
 }
@@ -1700,6 +1801,7 @@ void SceneState::add_node_property(int p_node, int p_name, int p_value, bool p_d
 	}
 	prop.value = p_value;
 	nodes.write[p_node].properties.push_back(prop);
+	_invalidate_instantiation_plan();
 }
 
 void SceneState::add_node_group(int p_node, int p_group) {
@@ -1711,6 +1813,7 @@ void SceneState::add_node_group(int p_node, int p_group) {
 void SceneState::set_base_scene(int p_idx) {
 	ERR_FAIL_INDEX(p_idx, variants.size());
 	base_scene_idx = p_idx;
+	_invalidate_instantiation_plan();
 }
 
 void SceneState::add_connection(int p_from, int p_to, int p_signal, int p_method, int p_flags, int p_unbinds, const Vector<int> &p_binds) {
@@ -1787,6 +1890,7 @@ SceneState::SceneState() {
 ////////////////
 
 void PackedScene::_set_bundled_scene(const Dictionary &p_scene) {
+	_invalidate_pool();
 	state->set_bundled_scene(p_scene);
 }
 
@@ -1795,10 +1899,12 @@ Dictionary PackedScene::_get_bundled_scene() const {
 }
 
 Error PackedScene::pack(Node *p_scene) {
+	_invalidate_pool();
 	return state->pack(p_scene);
 }
 
 void PackedScene::clear() {
+	_invalidate_pool();
 	state->clear();
 }
 
@@ -1838,20 +1944,204 @@ Node *PackedScene::instantiate(GenEditState p_edit_state) const {
 		return nullptr;
 	}
 
+	_setup_instance(s, p_edit_state);
+
+	return s;
+}
+
+Ref<SceneInstantiator> PackedScene::instantiate_incremental(GenEditState p_edit_state) const {
+#ifndef TOOLS_ENABLED
+	ERR_FAIL_COND_V_MSG(p_edit_state != GEN_EDIT_STATE_DISABLED, Ref<SceneInstantiator>(), "Edit state is only for editors, does not work without tools compiled.");
+#endif
+
+	Ref<SceneInstantiator> instantiator;
+	instantiator.instantiate();
+	instantiator->scene = Ref<PackedScene>(const_cast<PackedScene *>(this));
+	instantiator->state = state;
+	instantiator->edit_state = p_edit_state;
+	if (!state->_instantiate_begin(instantiator->instantiation, (SceneState::GenEditState)p_edit_state)) {
+		instantiator->status = ERR_CANT_CREATE;
+	}
+
+	return instantiator;
+}
+
+void PackedScene::_capture_pool_snapshot(Node *p_node) {
+	PoolSnapshot snapshot;
+	snapshot.class_name = p_node->get_class_name();
+	snapshot.child_count = p_node->get_child_count(true);
+
+	List<PropertyInfo> plist;
+	p_node->get_property_list(&plist);
+	for (const PropertyInfo &E : plist) {
+		if (!(E.usage & PROPERTY_USAGE_STORAGE)) {
+			continue;
+		}
+
+		Variant value = p_node->get(E.name);
+		if (value.get_type() == Variant::OBJECT) {
+			// Nodes and local to scene resources belong to this instance, they can't be given to another one.
+			Ref<Resource> res = value;
+			if (res.is_valid() ? res->is_local_to_scene() : value.get_validated_object() != nullptr) {
+				continue;
+			}
+		} else if (value.get_type() == Variant::ARRAY || value.get_type() == Variant::DICTIONARY) {
+			value = value.duplicate(true);
+		}
+		snapshot.properties.push_back(Pair<StringName, Variant>(E.name, value));
+	}
+	pool_snapshot.push_back(snapshot);
+
+	for (int i = 0; i < snapshot.child_count; i++) {
+		_capture_pool_snapshot(p_node->get_child(i, true));
+	}
+}
+
+bool PackedScene::_matches_pool_snapshot(Node *p_node, int &r_index) const {
+	if (r_index >= (int)pool_snapshot.size()) {
+		return false;
+	}
+
+	const PoolSnapshot &snapshot = pool_snapshot[r_index++];
+	if (p_node->get_class_name() != snapshot.class_name || p_node->get_child_count(true) != snapshot.child_count) {
+		return false;
+	}
+
+	for (int i = 0; i < snapshot.child_count; i++) {
+		if (!_matches_pool_snapshot(p_node->get_child(i, true), r_index)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void PackedScene::_reset_to_pool_snapshot(Node *p_node, int &r_index) const {
+	const PoolSnapshot &snapshot = pool_snapshot[r_index++];
+	for (const Pair<StringName, Variant> &E : snapshot.properties) {
+		if (p_node->get(E.first) == E.second) {
+			continue;
+		}
+		if (E.second.get_type() == Variant::ARRAY || E.second.get_type() == Variant::DICTIONARY) {
+			p_node->set(E.first, E.second.duplicate(true));
+		} else {
+			p_node->set(E.first, E.second);
+		}
+	}
+
+	for (int i = 0; i < snapshot.child_count; i++) {
+		_reset_to_pool_snapshot(p_node->get_child(i, true), r_index);
+	}
+}
+
+void PackedScene::_invalidate_pool() {
+	clear_pool();
+	pool_snapshot.clear();
+}
+
+Node *PackedScene::_take_pooled(ObjectID p_id) const {
+	// Skip instances that were freed or added to a tree again since they were released.
+	Node *node = Object::cast_to<Node>(ObjectDB::get_instance(p_id));
+	if (!node || node->get_parent()) {
+		return nullptr;
+	}
+	return node;
+}
+
+Node *PackedScene::instantiate_pooled() {
+	while (!pool.is_empty()) {
+		Node *node = _take_pooled(pool[pool.size() - 1]);
+		pool.resize(pool.size() - 1);
+		if (node) {
+			pool_hit_count++;
+			return node;
+		}
+	}
+
+	pool_miss_count++;
+	Node *node = instantiate();
+	ERR_FAIL_NULL_V(node, nullptr);
+
+	if (pool_snapshot.is_empty()) {
+		_capture_pool_snapshot(node);
+	}
+	return node;
+}
+
+bool PackedScene::release_to_pool(Node *p_node) {
+	ERR_FAIL_NULL_V(p_node, false);
+	ERR_FAIL_COND_V_MSG(pool.find(p_node->get_instance_id()) >= 0, false, "Node was already released to the pool.");
+
+	Node *parent = p_node->get_parent();
+	int index = 0;
+	if ((int)pool.size() >= pool_capacity || pool_snapshot.is_empty() || (parent && parent->data.blocked > 0) || !_matches_pool_snapshot(p_node, index) || index != (int)pool_snapshot.size()) {
+		// Can't be reused, either the pool is full, the parent is busy with its children
+		// so the node can't be removed now, or the node hierarchy changed since it was instantiated.
+		p_node->queue_free();
+		return false;
+	}
+
+	if (parent) {
+		parent->remove_child(p_node);
+	}
+
+	index = 0;
+	_reset_to_pool_snapshot(p_node, index);
+	pool.push_back(p_node->get_instance_id());
+	return true;
+}
+
+void PackedScene::clear_pool() {
+	for (const ObjectID &id : pool) {
+		Node *node = _take_pooled(id);
+		if (node) {
+			memdelete(node);
+		}
+	}
+	pool.clear();
+}
+
+void PackedScene::set_pool_capacity(int p_capacity) {
+	ERR_FAIL_COND(p_capacity < 0);
+	pool_capacity = p_capacity;
+	while ((int)pool.size() > pool_capacity) {
+		Node *node = _take_pooled(pool[pool.size() - 1]);
+		if (node) {
+			memdelete(node);
+		}
+		pool.resize(pool.size() - 1);
+	}
+}
+
+int PackedScene::get_pool_capacity() const {
+	return pool_capacity;
+}
+
+int PackedScene::get_pooled_count() const {
+	return pool.size();
+}
+
+uint64_t PackedScene::get_pool_hit_count() const {
+	return pool_hit_count;
+}
+
+uint64_t PackedScene::get_pool_miss_count() const {
+	return pool_miss_count;
+}
+
+void PackedScene::_setup_instance(Node *p_node, GenEditState p_edit_state) const {
 	if (p_edit_state != GEN_EDIT_STATE_DISABLED) {
-		s->set_scene_instance_state(state);
+		p_node->set_scene_instance_state(state);
 	}
 
 	if (!is_built_in()) {
-		s->set_scene_file_path(get_path());
+		p_node->set_scene_file_path(get_path());
 	}
 
-	s->notification(Node::NOTIFICATION_SCENE_INSTANTIATED);
-
-	return s;
+	p_node->notification(Node::NOTIFICATION_SCENE_INSTANTIATED);
 }
 
 void PackedScene::replace_state(Ref<SceneState> p_by) {
+	_invalidate_pool();
 	state = p_by;
 	state->set_path(get_path());
 #ifdef TOOLS_ENABLED
@@ -1860,6 +2150,7 @@ void PackedScene::replace_state(Ref<SceneState> p_by) {
 }
 
 void PackedScene::recreate_state() {
+	_invalidate_pool();
 	state = Ref<SceneState>(memnew(SceneState));
 	state->set_path(get_path());
 #ifdef TOOLS_ENABLED
@@ -1882,6 +2173,15 @@ void PackedScene::reset_state() {
 void PackedScene::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("pack", "path"), &PackedScene::pack);
 	ClassDB::bind_method(D_METHOD("instantiate", "edit_state"), &PackedScene::instantiate, DEFVAL(GEN_EDIT_STATE_DISABLED));
+	ClassDB::bind_method(D_METHOD("instantiate_incremental", "edit_state"), &PackedScene::instantiate_incremental, DEFVAL(GEN_EDIT_STATE_DISABLED));
+	ClassDB::bind_method(D_METHOD("instantiate_pooled"), &PackedScene::instantiate_pooled);
+	ClassDB::bind_method(D_METHOD("release_to_pool", "node"), &PackedScene::release_to_pool);
+	ClassDB::bind_method(D_METHOD("clear_pool"), &PackedScene::clear_pool);
+	ClassDB::bind_method(D_METHOD("set_pool_capacity", "capacity"), &PackedScene::set_pool_capacity);
+	ClassDB::bind_method(D_METHOD("get_pool_capacity"), &PackedScene::get_pool_capacity);
+	ClassDB::bind_method(D_METHOD("get_pooled_count"), &PackedScene::get_pooled_count);
+	ClassDB::bind_method(D_METHOD("get_pool_hit_count"), &PackedScene::get_pool_hit_count);
+	ClassDB::bind_method(D_METHOD("get_pool_miss_count"), &PackedScene::get_pool_miss_count);
 	ClassDB::bind_method(D_METHOD("can_instantiate"), &PackedScene::can_instantiate);
 	ClassDB::bind_method(D_METHOD("_set_bundled_scene", "scene"), &PackedScene::_set_bundled_scene);
 	ClassDB::bind_method(D_METHOD("_get_bundled_scene"), &PackedScene::_get_bundled_scene);
@@ -1898,3 +2198,98 @@ void PackedScene::_bind_methods() {
 PackedScene::PackedScene() {
 	state = Ref<SceneState>(memnew(SceneState));
 }
+
+PackedScene::~PackedScene() {
+	clear_pool();
+}
+
+void SceneInstantiator::_fail() {
+	status = ERR_CANT_CREATE;
+
+	// Free what was built so far, the root owns every node that was added.
+	if (instantiation.nodes.size() && instantiation.nodes[0]) {
+		memdelete(instantiation.nodes[0]);
+	}
+	while (instantiation.stray_instances.size()) {
+		memdelete(instantiation.stray_instances.front()->get());
+		instantiation.stray_instances.pop_front();
+	}
+	instantiation = SceneState::InstantiationState();
+}
+
+Error SceneInstantiator::poll(uint64_t p_usec_budget, int p_max_nodes) {
+	if (status != ERR_BUSY) {
+		return status;
+	}
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	int node_count = state->nodes.size();
+	int instantiated = 0;
+
+	// At least one node is instantiated per call, so progress is always made.
+	while (instantiation.next_node < node_count) {
+		if (!state->_instantiate_node(instantiation)) {
+			_fail();
+			return status;
+		}
+		instantiated++;
+		if (instantiation.next_node == node_count) {
+			break;
+		}
+		if (p_max_nodes > 0 && instantiated >= p_max_nodes) {
+			return ERR_BUSY;
+		}
+		if (p_usec_budget > 0 && OS::get_singleton()->get_ticks_usec() - begin >= p_usec_budget) {
+			return ERR_BUSY;
+		}
+	}
+
+	if (!state->_instantiate_end(instantiation)) {
+		_fail();
+		return status;
+	}
+
+	instance = instantiation.nodes[0];
+	instantiation = SceneState::InstantiationState();
+	scene->_setup_instance(instance, edit_state);
+
+	status = OK;
+	return status;
+}
+
+Error SceneInstantiator::get_status() const {
+	return status;
+}
+
+float SceneInstantiator::get_progress() const {
+	if (status != ERR_BUSY) {
+		return status == OK ? 1.0 : 0.0;
+	}
+	return instantiation.next_node / float(state->nodes.size() + 1); // The last step sets up connections.
+}
+
+Node *SceneInstantiator::get_instance() {
+	ERR_FAIL_COND_V_MSG(status != OK, nullptr, "The scene is not instantiated yet.");
+	ERR_FAIL_COND_V_MSG(!instance, nullptr, "The instance was already retrieved.");
+
+	// From now on, the caller owns the instance.
+	Node *ret = instance;
+	instance = nullptr;
+	return ret;
+}
+
+void SceneInstantiator::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("poll", "usec_budget", "max_nodes"), &SceneInstantiator::poll, DEFVAL(0), DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("get_status"), &SceneInstantiator::get_status);
+	ClassDB::bind_method(D_METHOD("get_progress"), &SceneInstantiator::get_progress);
+	ClassDB::bind_method(D_METHOD("get_instance"), &SceneInstantiator::get_instance);
+}
+
+SceneInstantiator::~SceneInstantiator() {
+	if (status == ERR_BUSY) {
+		_fail();
+	}
+	if (instance) {
+		memdelete(instance);
+	}
+}
@@ -32,6 +32,7 @@
 #define PACKED_SCENE_H
 
 #include "core/io/resource.h"
+#include "core/templates/local_vector.h"
 #include "scene/main/node.h"
 
 class SceneState : public RefCounted {
@@ -122,6 +123,46 @@ public:
 		GEN_EDIT_STATE_MAIN_INHERITED,
 	};
 
+private:
+	friend class PackedScene;
+	friend class SceneInstantiator;
+
+	// Everything needed to resume instantiating between nodes.
+	struct InstantiationState {
+		GenEditState edit_state = GEN_EDIT_STATE_DISABLED;
+		LocalVector<Node *> nodes;
+		List<Node *> stray_instances; // Nodes where instantiation failed (because something is missing.)
+		HashMap<Ref<Resource>, Ref<Resource>> resources_local_to_scene;
+		LocalVector<DeferredNodePathProperties> deferred_node_paths;
+		bool gen_node_path_cache = false;
+		bool use_plan = false;
+		int next_node = 0;
+	};
+
+	// Class and setter lookups resolved once, so instantiating the same scene
+	// many times skips them. Only used for nodes created from a native class.
+	struct PropertyPlan {
+		MethodBind *setter = nullptr; // When null, Object::set() is used.
+		int index = -1;
+	};
+
+	struct NodePlan {
+		ClassDB::CreationFunc creation_func = nullptr;
+		LocalVector<PropertyPlan> properties;
+	};
+
+	mutable LocalVector<NodePlan> instantiation_plan;
+	mutable bool instantiation_plan_valid = false;
+	mutable BinaryMutex instantiation_plan_mutex;
+
+	void _build_instantiation_plan() const;
+	void _invalidate_instantiation_plan();
+
+	bool _instantiate_begin(InstantiationState &r_state, GenEditState p_edit_state) const;
+	bool _instantiate_node(InstantiationState &r_state) const;
+	bool _instantiate_end(InstantiationState &r_state) const;
+
+public:
 	struct PackState {
 		Ref<SceneState> state;
 		int node = -1;
@@ -206,12 +247,38 @@ public:
 
 VARIANT_ENUM_CAST(SceneState::GenEditState)
 
+class SceneInstantiator;
+
 class PackedScene : public Resource {
 	GDCLASS(PackedScene, Resource);
 	RES_BASE_EXTENSION("scn");
 
+	friend class SceneInstantiator;
+
 	Ref<SceneState> state;
 
+	// State of a freshly instantiated scene, used to validate and reset
+	// the instances released to the pool. Stored in depth-first order.
+	struct PoolSnapshot {
+		StringName class_name;
+		int child_count = 0;
+		LocalVector<Pair<StringName, Variant>> properties;
+	};
+
+	// Pooled instances are owned by the pool but can still be freed by scripts
+	// holding a reference, so they are looked up again before use.
+	LocalVector<ObjectID> pool;
+	LocalVector<PoolSnapshot> pool_snapshot;
+	int pool_capacity = 32;
+	uint64_t pool_hit_count = 0;
+	uint64_t pool_miss_count = 0;
+
+	void _capture_pool_snapshot(Node *p_node);
+	bool _matches_pool_snapshot(Node *p_node, int &r_index) const;
+	void _reset_to_pool_snapshot(Node *p_node, int &r_index) const;
+	void _invalidate_pool();
+	Node *_take_pooled(ObjectID p_id) const;
+
 	void _set_bundled_scene(const Dictionary &p_scene);
 	Dictionary _get_bundled_scene() const;
 
@@ -228,12 +295,26 @@ public:
 		GEN_EDIT_STATE_MAIN_INHERITED,
 	};
 
+private:
+	void _setup_instance(Node *p_node, GenEditState p_edit_state) const;
+
+public:
 	Error pack(Node *p_scene);
 
 	void clear();
 
 	bool can_instantiate() const;
 	Node *instantiate(GenEditState p_edit_state = GEN_EDIT_STATE_DISABLED) const;
+	Ref<SceneInstantiator> instantiate_incremental(GenEditState p_edit_state = GEN_EDIT_STATE_DISABLED) const;
+
+	Node *instantiate_pooled();
+	bool release_to_pool(Node *p_node);
+	void clear_pool();
+	void set_pool_capacity(int p_capacity);
+	int get_pool_capacity() const;
+	int get_pooled_count() const;
+	uint64_t get_pool_hit_count() const;
+	uint64_t get_pool_miss_count() const;
 
 	void recreate_state();
 	void replace_state(Ref<SceneState> p_by);
@@ -250,8 +331,37 @@ public:
 	Ref<SceneState> get_state() const;
 
 	PackedScene();
+	~PackedScene();
 };
 
 VARIANT_ENUM_CAST(PackedScene::GenEditState)
 
+// Builds a PackedScene instance a few nodes at a time, so large scenes can be
+// instantiated over several frames, or on a thread before being added to the tree.
+class SceneInstantiator : public RefCounted {
+	GDCLASS(SceneInstantiator, RefCounted);
+
+	friend class PackedScene;
+
+	Ref<PackedScene> scene;
+	Ref<SceneState> state;
+	PackedScene::GenEditState edit_state = PackedScene::GEN_EDIT_STATE_DISABLED;
+	SceneState::InstantiationState instantiation;
+	Error status = ERR_BUSY;
+	Node *instance = nullptr;
+
+	void _fail();
+
+protected:
+	static void _bind_methods();
+
+public:
+	Error poll(uint64_t p_usec_budget = 0, int p_max_nodes = 0);
+	Error get_status() const;
+	float get_progress() const;
+	Node *get_instance();
+
+	~SceneInstantiator();
+};
+
 #endif // PACKED_SCENE_H
@@ -890,20 +890,18 @@ void SurfaceTool::create_vertex_array_from_triangle_arrays(const Array &p_arrays
 			v.uv2 = uv2arr[i];
 		}
 		if (lformat & RS::ARRAY_FORMAT_BONES) {
-			Vector<int> b;
-			b.resize(wcount);
+			v.bones.resize(wcount);
+			int *bones_w = v.bones.ptrw();
 			for (int j = 0; j < wcount; j++) {
-				b.write[j] = barr[i * wcount + j];
+				bones_w[j] = barr[i * wcount + j];
 			}
-			v.bones = b;
 		}
 		if (lformat & RS::ARRAY_FORMAT_WEIGHTS) {
-			Vector<float> w;
-			w.resize(wcount);
+			v.weights.resize(wcount);
+			float *weights_w = v.weights.ptrw();
 			for (int j = 0; j < wcount; j++) {
-				w.write[j] = warr[i * wcount + j];
+				weights_w[j] = warr[i * wcount + j];
 			}
-			v.weights = w;
 		}
 
 		for (int j = 0; j < RS::ARRAY_CUSTOM_COUNT; j++) {
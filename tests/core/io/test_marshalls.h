@@ -31,7 +31,10 @@
 #ifndef TEST_MARSHALLS_H
 #define TEST_MARSHALLS_H
 
+#include "core/io/file_access.h"
 #include "core/io/marshalls.h"
+#include "core/io/stream_peer.h"
+#include "core/os/os.h"
 
 #include "tests/test_macros.h"
 
@@ -326,6 +329,254 @@ TEST_CASE("[Marshalls] FLOAT double precision Variant decoding") {
 	CHECK(r_len == 12);
 	CHECK(variant == Variant(0.33333333333333333));
 }
+
+TEST_CASE("[Marshalls] Typed Array bulk encoding") {
+	Array array;
+	array.set_typed(Variant::INT, StringName(), Variant());
+	array.push_back(1);
+	array.push_back(2);
+	array.push_back(0x12345678);
+
+	int r_len;
+	CHECK(encode_variant(array, nullptr, r_len) == OK);
+	CHECK_MESSAGE(r_len == 32, "Bulk encoding is opt-in: 4 bytes for Variant::Type + 4 bytes for count + 3 * 8 bytes for Variant::INT and int32_t");
+
+	CHECK(encode_variant(array, nullptr, r_len, false, true) == OK);
+	CHECK_MESSAGE(r_len == 24, "Length == 4 bytes for Variant::Type + 4 bytes for count + 4 bytes for descriptor + 3 * 4 bytes for int32_t");
+
+	uint8_t buffer[24];
+	CHECK(encode_variant(array, buffer, r_len, false, true) == OK);
+	CHECK_MESSAGE(buffer[0] == 0x1c, "Variant::ARRAY");
+	CHECK(buffer[1] == 0x00);
+	CHECK_MESSAGE(buffer[2] == 0x01, "ENCODE_FLAG_BULK");
+	CHECK(buffer[3] == 0x00);
+	// Check count
+	CHECK(buffer[4] == 0x03);
+	CHECK(buffer[5] == 0x00);
+	CHECK(buffer[6] == 0x00);
+	CHECK(buffer[7] == 0x00);
+	// Check descriptor
+	CHECK_MESSAGE(buffer[8] == 0x02, "Variant::INT");
+	CHECK(buffer[9] == 0x00);
+	CHECK_MESSAGE(buffer[10] == 0x02, "Typed");
+	CHECK(buffer[11] == 0x00);
+	// Check values
+	CHECK(buffer[12] == 0x01);
+	CHECK(buffer[16] == 0x02);
+	CHECK(buffer[20] == 0x78);
+	CHECK(buffer[21] == 0x56);
+	CHECK(buffer[22] == 0x34);
+	CHECK(buffer[23] == 0x12);
+
+	Variant variant;
+	CHECK(decode_variant(variant, buffer, 24, &r_len) == OK);
+	CHECK(r_len == 24);
+	Array decoded = variant;
+	CHECK(decoded.is_typed());
+	CHECK(decoded.get_typed_builtin() == Variant::INT);
+	CHECK(decoded == array);
+}
+
+static Variant _encode_and_decode(const Variant &p_variant, int *r_len) {
+	CHECK(encode_variant(p_variant, nullptr, *r_len, false, true) == OK);
+	Vector<uint8_t> buffer;
+	buffer.resize(*r_len);
+	int len;
+	CHECK(encode_variant(p_variant, buffer.ptrw(), len, false, true) == OK);
+	CHECK(len == *r_len);
+
+	Variant variant;
+	CHECK(decode_variant(variant, buffer.ptr(), buffer.size(), &len) == OK);
+	CHECK(len == *r_len);
+	return variant;
+}
+
+TEST_CASE("[Marshalls] Array bulk encoding round trip") {
+	int r_len;
+
+	SUBCASE("Bools are packed and padded") {
+		Array array;
+		array.set_typed(Variant::BOOL, StringName(), Variant());
+		for (int i = 0; i < 5; i++) {
+			array.push_back(i % 2 == 0);
+		}
+		Array decoded = _encode_and_decode(array, &r_len);
+		CHECK_MESSAGE(r_len == 20, "12 bytes of headers + 5 bytes of bools padded to 8");
+		CHECK(decoded.get_typed_builtin() == Variant::BOOL);
+		CHECK(decoded == array);
+	}
+
+	SUBCASE("Large integers and doubles use 64 bits") {
+		Array ints;
+		ints.push_back(1);
+		ints.push_back(int64_t(1) << 40);
+		Array decoded = _encode_and_decode(ints, &r_len);
+		CHECK(r_len == 12 + 2 * 8);
+		CHECK_FALSE(decoded.is_typed());
+		CHECK(decoded == ints);
+
+		Array floats;
+		floats.set_typed(Variant::FLOAT, StringName(), Variant());
+		floats.push_back(0.5);
+		floats.push_back(0.33333333333333333);
+		decoded = _encode_and_decode(floats, &r_len);
+		CHECK(r_len == 12 + 2 * 8);
+		CHECK(decoded == floats);
+	}
+
+	SUBCASE("Strings and StringNames") {
+		Array strings;
+		strings.set_typed(Variant::STRING, StringName(), Variant());
+		strings.push_back("a");
+		strings.push_back("");
+		strings.push_back(String::utf8("héllo"));
+		Array decoded = _encode_and_decode(strings, &r_len);
+		CHECK(decoded.get_typed_builtin() == Variant::STRING);
+		CHECK(decoded == strings);
+
+		Array names;
+		names.set_typed(Variant::STRING_NAME, StringName(), Variant());
+		names.push_back(StringName("position"));
+		names.push_back(StringName("rotation"));
+		decoded = _encode_and_decode(names, &r_len);
+		CHECK(decoded.get_typed_builtin() == Variant::STRING_NAME);
+		CHECK(decoded[1].get_type() == Variant::STRING_NAME);
+		CHECK(decoded == names);
+	}
+
+	SUBCASE("Math types") {
+		Array vectors;
+		vectors.set_typed(Variant::VECTOR3, StringName(), Variant());
+		vectors.push_back(Vector3(1, 2, 3));
+		vectors.push_back(Vector3(-0.5, 0, 4));
+		Array decoded = _encode_and_decode(vectors, &r_len);
+		CHECK(r_len == 12 + 2 * 3 * int(sizeof(real_t)));
+		CHECK(decoded == vectors);
+
+		Array colors;
+		colors.push_back(Color(1, 0, 0));
+		colors.push_back(Color(0, 0.5, 1, 0.25));
+		decoded = _encode_and_decode(colors, &r_len);
+		CHECK(r_len == 12 + 2 * 16);
+		CHECK(decoded == colors);
+
+		Array rects;
+		rects.set_typed(Variant::RECT2I, StringName(), Variant());
+		rects.push_back(Rect2i(1, 2, 3, 4));
+		decoded = _encode_and_decode(rects, &r_len);
+		CHECK(decoded == rects);
+	}
+
+	SUBCASE("Empty typed arrays keep their type") {
+		Array array;
+		array.set_typed(Variant::VECTOR2I, StringName(), Variant());
+		Array decoded = _encode_and_decode(array, &r_len);
+		CHECK(r_len == 12);
+		CHECK(decoded.get_typed_builtin() == Variant::VECTOR2I);
+		CHECK(decoded.is_empty());
+	}
+
+	SUBCASE("Mixed arrays use per-element headers") {
+		Array array;
+		array.push_back(1);
+		array.push_back("1");
+		Array decoded = _encode_and_decode(array, &r_len);
+		CHECK(r_len == 8 + 8 + 12);
+		CHECK(decoded == array);
+	}
+}
+
+TEST_CASE("[Marshalls] Dictionary bulk encoding round trip") {
+	int r_len;
+
+	Dictionary dictionary;
+	dictionary["health"] = 10;
+	dictionary["mana"] = 25;
+	dictionary["stamina"] = 1 << 20;
+	Dictionary decoded = _encode_and_decode(dictionary, &r_len);
+	CHECK_MESSAGE(r_len == 16 + (4 + 8 + 4) + (4 + 4 + 4) + (4 + 8 + 4), "Keys and values without Variant::Type headers");
+	CHECK(decoded == dictionary);
+
+	Dictionary mixed;
+	mixed[1] = "one";
+	mixed["two"] = 2;
+	decoded = _encode_and_decode(mixed, &r_len);
+	CHECK(decoded == mixed);
+}
+
+TEST_CASE("[Marshalls] Bulk encoding is smaller than per-element encoding") {
+	Array array;
+	array.set_typed(Variant::FLOAT, StringName(), Variant());
+	Dictionary dictionary;
+	for (int i = 0; i < 1000; i++) {
+		array.push_back(i * 0.5);
+		dictionary[i] = Vector2(i, -i);
+	}
+
+	int r_len;
+	CHECK(encode_variant(array, nullptr, r_len) == OK);
+	CHECK(r_len == 8 + 1000 * 8);
+	CHECK(encode_variant(array, nullptr, r_len, false, true) == OK);
+	CHECK(r_len == 12 + 1000 * 4);
+
+	CHECK(encode_variant(dictionary, nullptr, r_len) == OK);
+	CHECK(r_len == 8 + 1000 * (8 + 4 + 2 * int(sizeof(real_t))));
+	CHECK(encode_variant(dictionary, nullptr, r_len, false, true) == OK);
+	CHECK(r_len == 16 + 1000 * (4 + 2 * int(sizeof(real_t))));
+}
+
+TEST_CASE("[Marshalls] Bulk encoding through StreamPeer and FileAccess") {
+	Array array;
+	for (int i = 0; i < 100; i++) {
+		array.push_back(i);
+	}
+
+	Ref<StreamPeerBuffer> stream;
+	stream.instantiate();
+	stream->put_var(array);
+	int default_size = stream->get_size();
+	stream->put_var(array, false, true);
+	CHECK(stream->get_size() - default_size < default_size);
+
+	stream->seek(0);
+	CHECK(stream->get_var() == Variant(array));
+	CHECK(stream->get_var() == Variant(array));
+
+	const String path = OS::get_singleton()->get_cache_path().path_join("marshalls_bulk_var.bin");
+	{
+		Ref<FileAccess> f = FileAccess::open(path, FileAccess::WRITE);
+		REQUIRE(f.is_valid());
+		f->store_var(array, false, true);
+		CHECK(f->get_length() == uint64_t(4 + 12 + 100 * 4));
+	}
+	{
+		Ref<FileAccess> f = FileAccess::open(path, FileAccess::READ);
+		REQUIRE(f.is_valid());
+		CHECK(f->get_var() == Variant(array));
+	}
+}
+
+TEST_CASE("[Marshalls] Invalid bulk data decoding") {
+	Variant variant;
+	int r_len = 0;
+	uint8_t truncated_buffer[] = {
+		0x1c, 0x00, 0x01, 0x00, // Variant::ARRAY & ENCODE_FLAG_BULK
+		0xff, 0xff, 0xff, 0x00, // count
+		0x02, 0x00, 0x00, 0x00, // Variant::INT
+		0x01, 0x00, 0x00, 0x00 // value
+	};
+	uint8_t invalid_type_buffer[] = {
+		0x1c, 0x00, 0x01, 0x00, // Variant::ARRAY & ENCODE_FLAG_BULK
+		0x01, 0x00, 0x00, 0x00, // count
+		0x18, 0x00, 0x00, 0x00, // Variant::OBJECT
+		0x00, 0x00, 0x00, 0x00
+	};
+
+	ERR_PRINT_OFF;
+	CHECK(decode_variant(variant, truncated_buffer, 16, &r_len) == ERR_INVALID_DATA);
+	CHECK(decode_variant(variant, invalid_type_buffer, 16, &r_len) == ERR_INVALID_DATA);
+	ERR_PRINT_ON;
+}
 } // namespace TestMarshalls
 
 #endif // TEST_MARSHALLS_H
@@ -117,6 +117,126 @@ TEST_CASE("[PCKPacker] Pack a PCK file with some files and directories") {
 			f->get_length() <= 35000,
 			"The generated non-empty PCK file shouldn't be too large.");
 }
+
+// Packs added in tests go into an instance of their own, which is freed at the end of the test.
+struct ScopedPackedData {
+	PackedData *packed_data = memnew(PackedData);
+	~ScopedPackedData() {
+		memdelete(packed_data);
+	}
+};
+
+TEST_CASE("[PCKPacker] Read packed files back through PackedData") {
+	ScopedPackedData scoped_packed_data;
+	PCKPacker pck_packer;
+	const String output_pck_path = OS::get_singleton()->get_cache_path().path_join("output_read_back.pck");
+	const String base_dir = OS::get_singleton()->get_executable_path().get_base_dir();
+	const String source_path = base_dir.path_join("../version.py");
+
+	REQUIRE(pck_packer.pck_start(output_pck_path) == OK);
+	REQUIRE(pck_packer.add_file("res://pck_read_back_test/version.py", source_path) == OK);
+	REQUIRE(pck_packer.flush() == OK);
+
+	REQUIRE(PackedData::get_singleton()->add_pack(output_pck_path, true, 0) == OK);
+
+	const Vector<uint8_t> expected = FileAccess::get_file_as_bytes(source_path);
+	Ref<FileAccess> f = PackedData::get_singleton()->try_open_path("res://pck_read_back_test/version.py");
+	REQUIRE(f.is_valid());
+	CHECK(f->get_length() == (uint64_t)expected.size());
+
+	Vector<uint8_t> contents;
+	contents.resize(f->get_length());
+	CHECK(f->get_buffer(contents.ptrw(), contents.size()) == (uint64_t)contents.size());
+	CHECK(contents == expected);
+
+	f->seek(4);
+	CHECK(f->get_8() == expected[4]);
+
+#ifdef UNIX_ENABLED
+	// Unencrypted files in packs on disk are read straight from the mapping.
+	f->seek(0);
+	const uint8_t *mapped = f->get_mapped_buffer(expected.size());
+	REQUIRE(mapped != nullptr);
+	CHECK(memcmp(mapped, expected.ptr(), expected.size()) == 0);
+	CHECK(f->get_position() == (uint64_t)expected.size());
+	CHECK(f->get_mapped_buffer(1) == nullptr);
+
+	// Adding the same pack again reuses its mapping.
+	REQUIRE(PackedData::get_singleton()->add_pack(output_pck_path, true, 0) == OK);
+	Ref<FileAccess> f_again = PackedData::get_singleton()->try_open_path("res://pck_read_back_test/version.py");
+	REQUIRE(f_again.is_valid());
+	CHECK(f_again->get_mapped_buffer(expected.size()) == mapped);
+#endif
+}
+
+TEST_CASE("[PCKPacker] Read compressed files back through PackedData") {
+	ScopedPackedData scoped_packed_data;
+	// Compressible contents spanning several compressed blocks, the last one partial.
+	Vector<uint8_t> expected;
+	expected.resize(PACK_COMPRESSED_BLOCK_SIZE * 3 + 1234);
+	for (int i = 0; i < expected.size(); i++) {
+		expected.write[i] = (i / 7) % 61;
+	}
+	const String source_path = OS::get_singleton()->get_cache_path().path_join("pck_compressed_source.bin");
+	{
+		Ref<FileAccess> src = FileAccess::open(source_path, FileAccess::WRITE);
+		REQUIRE(src.is_valid());
+		src->store_buffer(expected.ptr(), expected.size());
+	}
+
+	PCKPacker pck_packer;
+	const String output_pck_path = OS::get_singleton()->get_cache_path().path_join("output_compressed.pck");
+	REQUIRE(pck_packer.pck_start(output_pck_path) == OK);
+	REQUIRE(pck_packer.add_file("res://pck_compressed_test/plain.bin", source_path, false, true) == OK);
+	REQUIRE(pck_packer.add_file("res://pck_compressed_test/encrypted.bin", source_path, true, true) == OK);
+	CHECK_MESSAGE(
+			FileAccess::exists(output_pck_path + ".tmp"),
+			"Compressed files should be written to a temporary file instead of being kept in memory.");
+	REQUIRE(pck_packer.flush() == OK);
+	CHECK_FALSE(FileAccess::exists(output_pck_path + ".tmp"));
+
+	{
+		Ref<FileAccess> pck = FileAccess::open(output_pck_path, FileAccess::READ);
+		REQUIRE(pck.is_valid());
+		CHECK_MESSAGE(
+				pck->get_length() < (uint64_t)expected.size(),
+				"Both compressed copies should take less space than one uncompressed copy.");
+		pck->seek(4);
+		CHECK(pck->get_32() == PACK_FORMAT_VERSION);
+	}
+
+	REQUIRE(PackedData::get_singleton()->add_pack(output_pck_path, true, 0) == OK);
+
+	const char *paths[] = { "res://pck_compressed_test/plain.bin", "res://pck_compressed_test/encrypted.bin" };
+	for (const char *path : paths) {
+		Ref<FileAccess> f = PackedData::get_singleton()->try_open_path(path);
+		REQUIRE(f.is_valid());
+		CHECK(f->get_length() == (uint64_t)expected.size());
+		CHECK(f->get_mapped_buffer(16) == nullptr);
+
+		Vector<uint8_t> contents;
+		contents.resize(expected.size());
+		CHECK(f->get_buffer(contents.ptrw(), contents.size()) == (uint64_t)contents.size());
+		CHECK(contents == expected);
+		CHECK_FALSE(f->eof_reached());
+
+		// Reads that start and end inside blocks.
+		f->seek(PACK_COMPRESSED_BLOCK_SIZE - 10);
+		uint8_t buffer[PACK_COMPRESSED_BLOCK_SIZE + 20];
+		CHECK(f->get_buffer(buffer, sizeof(buffer)) == sizeof(buffer));
+		CHECK(memcmp(buffer, expected.ptr() + PACK_COMPRESSED_BLOCK_SIZE - 10, sizeof(buffer)) == 0);
+
+		f->seek(expected.size() - 1);
+		CHECK(f->get_8() == expected[expected.size() - 1]);
+		f->seek(12345);
+		CHECK(f->get_8() == expected[12345]);
+		CHECK(f->get_8() == expected[12346]);
+
+		f->seek(expected.size() - 4);
+		CHECK(f->get_buffer(buffer, 16) == 4);
+		CHECK(f->eof_reached());
+	}
+}
 } // namespace TestPCKPacker
 
 #endif // TEST_PCK_PACKER_H
@@ -40,6 +40,45 @@
 
 namespace TestResource {
 
+class _TestSourceResource : public Resource {
+	GDCLASS(_TestSourceResource, Resource);
+
+public:
+	static inline int alive_count = 0;
+
+	_TestSourceResource() { alive_count++; }
+	~_TestSourceResource() { alive_count--; }
+};
+
+// Like ImageTexture with its Image, doesn't keep the resource it's set up from.
+class _TestConsumerResource : public Resource {
+	GDCLASS(_TestConsumerResource, Resource);
+
+	Ref<Resource> source;
+	String source_name;
+
+protected:
+	static void _bind_methods() {
+		ClassDB::bind_method(D_METHOD("set_source", "source"), &_TestConsumerResource::set_source);
+		ClassDB::bind_method(D_METHOD("get_source"), &_TestConsumerResource::get_source);
+		ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "source", PROPERTY_HINT_RESOURCE_TYPE, "Resource"), "set_source", "get_source");
+	}
+
+public:
+	static inline int max_sources_alive = 0;
+	bool keep_source = false; // Kept only so it can be saved.
+
+	void set_source(const Ref<Resource> &p_source) {
+		source_name = p_source.is_valid() ? p_source->get_name() : String();
+		max_sources_alive = MAX(max_sources_alive, _TestSourceResource::alive_count);
+		if (keep_source) {
+			source = p_source;
+		}
+	}
+	Ref<Resource> get_source() const { return source; }
+	String get_source_name() const { return source_name; }
+};
+
 TEST_CASE("[Resource] Duplication") {
 	Ref<Resource> resource = memnew(Resource);
 	resource->set_name("Hello world");
@@ -109,6 +148,213 @@ TEST_CASE("[Resource] Saving and loading") {
 			loaded_child_resource_text->get_name() == "I'm a child resource",
 			"The loaded child resource name should be equal to the expected value.");
 }
+
+TEST_CASE("[Resource] Loading dependencies on sub-threads") {
+	const String cache_path = OS::get_singleton()->get_cache_path().simplify_path();
+	const String main_path = cache_path.path_join("resource_main.res");
+	const int dependency_count = 8;
+
+	{
+		Ref<Resource> resource = memnew(Resource);
+		resource->set_name("Main");
+		for (int i = 0; i < dependency_count; i++) {
+			Ref<Resource> dependency = memnew(Resource);
+			dependency->set_name(vformat("Dependency %d", i));
+			const String dependency_path = cache_path.path_join(vformat("resource_dependency_%d.res", i));
+			ResourceSaver::save(dependency, dependency_path);
+			// With a path, the dependency is saved as an external resource.
+			dependency->set_path(dependency_path);
+			resource->set_meta(vformat("dependency_%d", i), dependency);
+		}
+		ResourceSaver::save(resource, main_path);
+	}
+	CHECK_MESSAGE(
+			!ResourceCache::has(main_path),
+			"The saved resources should not be cached anymore.");
+
+	ResourceLoader::clear_load_trace();
+	ResourceLoader::set_load_tracing_enabled(true);
+
+	REQUIRE(ResourceLoader::load_threaded_request(main_path, "", true) == OK);
+	Error error = FAILED;
+	Ref<Resource> loaded = ResourceLoader::load_threaded_get(main_path, &error);
+
+	ResourceLoader::set_load_tracing_enabled(false);
+
+	REQUIRE(error == OK);
+	REQUIRE(loaded.is_valid());
+	CHECK(loaded->get_name() == "Main");
+	const String main_local_path = loaded->get_path();
+	for (int i = 0; i < dependency_count; i++) {
+		Ref<Resource> dependency = loaded->get_meta(vformat("dependency_%d", i));
+		REQUIRE(dependency.is_valid());
+		CHECK(dependency->get_name() == vformat("Dependency %d", i));
+		CHECK(dependency->get_path() == main_local_path.get_base_dir().path_join(vformat("resource_dependency_%d.res", i)));
+	}
+	CHECK_MESSAGE(
+			ResourceLoader::load_threaded_get_status(main_path) == ResourceLoader::THREAD_LOAD_INVALID_RESOURCE,
+			"The load task should be released once its result was retrieved.");
+
+	List<ResourceLoader::LoadTrace> trace;
+	ResourceLoader::get_load_trace(&trace);
+	CHECK(trace.size() == dependency_count + 1);
+	for (const ResourceLoader::LoadTrace &E : trace) {
+		CHECK(E.error == OK);
+		CHECK(E.request_usec <= E.start_usec);
+		CHECK(E.start_usec <= E.end_usec);
+		if (E.path == main_local_path) {
+			CHECK(E.source_path.is_empty());
+		} else {
+			CHECK_MESSAGE(
+					E.source_path == main_local_path,
+					"Dependencies should be traced back to the resource that requested them.");
+		}
+	}
+	CHECK_MESSAGE(
+			trace.back()->get().path == main_local_path,
+			"The main resource should end loading after its dependencies.");
+
+	// Loading again from the cache doesn't trace anything.
+	ResourceLoader::clear_load_trace();
+	ResourceLoader::set_load_tracing_enabled(true);
+	CHECK(ResourceLoader::load(main_path) == loaded);
+	ResourceLoader::set_load_tracing_enabled(false);
+	trace.clear();
+	ResourceLoader::get_load_trace(&trace);
+	CHECK(trace.is_empty());
+}
+
+TEST_CASE("[Resource] Loading internal resources when referenced") {
+	GDREGISTER_CLASS(_TestSourceResource);
+	GDREGISTER_CLASS(_TestConsumerResource);
+
+	const String save_path = OS::get_singleton()->get_cache_path().simplify_path().path_join("resource_internal.res");
+	const int consumer_count = 4;
+
+	{
+		Ref<Resource> resource = memnew(Resource);
+		Ref<Resource> shared = memnew(Resource);
+		shared->set_name("Shared");
+		Ref<Resource> nested = memnew(Resource);
+		nested->set_name("Nested");
+		shared->set_meta("nested", nested);
+		resource->set_meta("first", shared);
+		resource->set_meta("second", shared);
+
+		for (int i = 0; i < consumer_count; i++) {
+			Ref<_TestSourceResource> source = memnew(_TestSourceResource);
+			source->set_name(vformat("Source %d", i));
+			Ref<_TestConsumerResource> consumer = memnew(_TestConsumerResource);
+			consumer->keep_source = true;
+			consumer->set_source(source);
+			resource->set_meta(vformat("consumer_%d", i), consumer);
+		}
+		ResourceSaver::save(resource, save_path);
+	}
+	REQUIRE(_TestSourceResource::alive_count == 0);
+
+	_TestConsumerResource::max_sources_alive = 0;
+	Ref<Resource> loaded = ResourceLoader::load(save_path, "", ResourceFormatLoader::CACHE_MODE_IGNORE);
+	REQUIRE(loaded.is_valid());
+
+	Ref<Resource> first = loaded->get_meta("first");
+	Ref<Resource> second = loaded->get_meta("second");
+	REQUIRE(first.is_valid());
+	CHECK(first->get_name() == "Shared");
+	CHECK_MESSAGE(
+			first == second,
+			"A resource referenced twice should be loaded once.");
+	Ref<Resource> nested = first->get_meta("nested");
+	REQUIRE(nested.is_valid());
+	CHECK(nested->get_name() == "Nested");
+
+	for (int i = 0; i < consumer_count; i++) {
+		Ref<_TestConsumerResource> consumer = loaded->get_meta(vformat("consumer_%d", i));
+		REQUIRE(consumer.is_valid());
+		CHECK(consumer->get_source_name() == vformat("Source %d", i));
+	}
+	CHECK_MESSAGE(
+			_TestSourceResource::alive_count == 0,
+			"Resources nothing keeps should be freed.");
+	CHECK_MESSAGE(
+			_TestConsumerResource::max_sources_alive == 1,
+			"The loader should not keep internal resources alive until the end of the load.");
+}
+
+TEST_CASE("[Resource] Sharing identical sub-resources") {
+	const String cache_path = OS::get_singleton()->get_cache_path().simplify_path();
+	const String path_a = cache_path.path_join("resource_dedup_a.res");
+	const String path_b = cache_path.path_join("resource_dedup_b.res");
+
+	// Two files embedding equal, but separate, sub-resources.
+	for (const String &path : { path_a, path_b }) {
+		Ref<Resource> resource = memnew(Resource);
+		Ref<Resource> shape = memnew(Resource);
+		shape->set_name("Shape");
+		Ref<Resource> material = memnew(Resource);
+		material->set_name("Material");
+		material->set_meta("color", Color(1, 0, 0));
+		Ref<Resource> nested = memnew(Resource);
+		nested->set_name("Nested");
+		material->set_meta("nested", nested);
+		Ref<Resource> local = memnew(Resource);
+		local->set_name("Local");
+		local->set_local_to_scene(true);
+
+		resource->set_meta("shape", shape);
+		resource->set_meta("material", material);
+		resource->set_meta("local", local);
+		resource->set_meta("file", path);
+		ResourceSaver::save(resource, path);
+	}
+
+	ResourceLoader::set_sub_resource_deduplication_enabled(true);
+	Ref<Resource> loaded_a = ResourceLoader::load(path_a);
+	Ref<Resource> loaded_b = ResourceLoader::load(path_b);
+	uint64_t checked = 0;
+	uint64_t deduplicated = 0;
+	uint64_t entries = 0;
+	ResourceCache::get_deduplication_stats(&checked, &deduplicated, &entries);
+
+	REQUIRE(loaded_a.is_valid());
+	REQUIRE(loaded_b.is_valid());
+	CHECK_MESSAGE(
+			loaded_a != loaded_b,
+			"Main resources should never be shared.");
+
+	Ref<Resource> material = loaded_a->get_meta("material");
+	REQUIRE(material.is_valid());
+	CHECK(material->get_meta("color") == Variant(Color(1, 0, 0)));
+	CHECK_MESSAGE(
+			loaded_a->get_meta("shape") == loaded_b->get_meta("shape"),
+			"Identical sub-resources should be shared.");
+	CHECK_MESSAGE(
+			loaded_a->get_meta("material") == loaded_b->get_meta("material"),
+			"Sub-resources referencing identical sub-resources should be shared.");
+	CHECK_MESSAGE(
+			loaded_a->get_meta("local") != loaded_b->get_meta("local"),
+			"Local to scene sub-resources should not be shared.");
+
+	CHECK(checked == 6); // Shape, material and nested from each file.
+	CHECK(deduplicated == 3);
+	CHECK(entries == 3);
+
+	// Nothing keeps the shared sub-resources once these are freed, and they leave the cache.
+	material.unref();
+	loaded_a.unref();
+	loaded_b.unref();
+	ResourceCache::get_deduplication_stats(&checked, &deduplicated, &entries);
+	CHECK(entries == 0);
+
+	ResourceLoader::set_sub_resource_deduplication_enabled(false);
+	loaded_a = ResourceLoader::load(path_a);
+	loaded_b = ResourceLoader::load(path_b);
+	REQUIRE(loaded_a.is_valid());
+	REQUIRE(loaded_b.is_valid());
+	CHECK_MESSAGE(
+			loaded_a->get_meta("shape") != loaded_b->get_meta("shape"),
+			"Sub-resources should not be shared when deduplication is disabled.");
+}
 } // namespace TestResource
 
 #endif // TEST_RESOURCE_H
@@ -321,6 +321,52 @@ TEST_CASE("[Expression] Expressions with variables") {
 	ERR_PRINT_ON;
 }
 
+TEST_CASE("[Expression] Built-in method calls with changing base types") {
+	Expression expression;
+
+	PackedStringArray parameter_names;
+	parameter_names.push_back("foo");
+	CHECK_MESSAGE(
+			expression.parse("foo.size()", parameter_names) == OK,
+			"The expression should parse successfully.");
+
+	Array values;
+	values.push_back(Array());
+	Array(values[0]).push_back(1);
+	CHECK_MESSAGE(
+			int(expression.execute(values)) == 1,
+			"The method should be called on an Array.");
+
+	PackedInt32Array packed;
+	packed.resize(3);
+	values[0] = packed;
+	CHECK_MESSAGE(
+			int(expression.execute(values)) == 3,
+			"The cached method should be resolved again for a different base type.");
+
+	values[0] = Vector3(1, 2, 3);
+	ERR_PRINT_OFF;
+	expression.execute(values);
+	ERR_PRINT_ON;
+	CHECK_MESSAGE(
+			expression.has_execute_failed(),
+			"Calling a method the base type doesn't have should fail.");
+
+	values[0] = PackedStringArray();
+	CHECK_MESSAGE(
+			int(expression.execute(values)) == 0,
+			"The expression should recover once the base type has the method again.");
+	CHECK(!expression.has_execute_failed());
+
+	CHECK_MESSAGE(
+			expression.parse("foo.dot(Vector3(1, 0, 0)) + foo.dot(Vector3(0, 1, 0))", parameter_names) == OK,
+			"The expression should parse successfully.");
+	for (int i = 0; i < 100; i++) {
+		values[0] = Vector3(i, 1, 0);
+		CHECK(int(expression.execute(values)) == i + 1);
+	}
+}
+
 TEST_CASE("[Expression] Invalid expressions") {
 	Expression expression;
 
@@ -0,0 +1,201 @@
+/**************************************************************************/
+/*  test_message_queue.h                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_MESSAGE_QUEUE_H
+#define TEST_MESSAGE_QUEUE_H
+
+#include "core/object/message_queue.h"
+#include "core/os/thread.h"
+
+#include "tests/test_macros.h"
+
+namespace TestMessageQueue {
+
+class MessageReceiver : public Object {
+public:
+	LocalVector<Vector2i> calls;
+
+	void receive(int p_thread, int p_index) {
+		calls.push_back(Vector2i(p_thread, p_index));
+	}
+
+	Error last_error = OK;
+
+	void requeue_forever() {
+		calls.push_back(Vector2i(-1, -1));
+		last_error = MessageQueue::get_singleton()->push_callable(callable_mp(this, &MessageReceiver::requeue_forever));
+	}
+
+	void requeue(int p_remaining) {
+		calls.push_back(Vector2i(-1, p_remaining));
+		if (p_remaining > 0) {
+			MessageQueue::get_singleton()->push_callable(callable_mp(this, &MessageReceiver::requeue), p_remaining - 1);
+		}
+	}
+};
+
+struct PushUserdata {
+	MessageReceiver *receiver = nullptr;
+	int thread = 0;
+	int count = 0;
+};
+
+static void push_from_thread(void *p_userdata) {
+	PushUserdata *ud = (PushUserdata *)p_userdata;
+	Callable callable = callable_mp(ud->receiver, &MessageReceiver::receive);
+	for (int i = 0; i < ud->count; i++) {
+		MessageQueue::get_singleton()->push_callable(callable, ud->thread, i);
+	}
+}
+
+TEST_CASE("[MessageQueue] Deferred calls are processed in order on flush") {
+	MessageQueue *message_queue = memnew(MessageQueue);
+	MessageReceiver *receiver = memnew(MessageReceiver);
+
+	const int count = 10000;
+	Callable callable = callable_mp(receiver, &MessageReceiver::receive);
+	for (int i = 0; i < count; i++) {
+		message_queue->push_callable(callable, 0, i);
+	}
+	message_queue->push_set(receiver, "metadata/value", 42);
+
+	CHECK(message_queue->get_queue_depth() == count + 1);
+	CHECK(receiver->calls.size() == 0);
+
+	message_queue->flush();
+
+	CHECK(message_queue->get_queue_depth() == 0);
+	CHECK(message_queue->get_last_flush_message_count() == count + 1);
+	CHECK(message_queue->get_max_buffer_usage() > 0);
+	CHECK(receiver->get_meta("value") == Variant(42));
+	REQUIRE(receiver->calls.size() == count);
+	bool in_order = true;
+	for (int i = 0; i < count; i++) {
+		in_order = in_order && receiver->calls[i] == Vector2i(0, i);
+	}
+	CHECK(in_order);
+
+	memdelete(receiver);
+	memdelete(message_queue);
+}
+
+TEST_CASE("[MessageQueue] Calls queued while flushing are processed by the same flush") {
+	MessageQueue *message_queue = memnew(MessageQueue);
+	MessageReceiver *receiver = memnew(MessageReceiver);
+
+	message_queue->push_callable(callable_mp(receiver, &MessageReceiver::requeue), 3);
+	message_queue->flush();
+
+	CHECK(receiver->calls.size() == 4);
+	CHECK(receiver->calls[3] == Vector2i(-1, 0));
+	CHECK(message_queue->get_last_flush_message_count() == 4);
+	CHECK(message_queue->get_queue_depth() == 0);
+
+	memdelete(receiver);
+	memdelete(message_queue);
+}
+
+TEST_CASE("[MessageQueue] Calls that keep re-queuing themselves are stopped when the queue is full") {
+	MessageQueue *message_queue = memnew(MessageQueue);
+	MessageReceiver *receiver = memnew(MessageReceiver);
+
+	message_queue->push_callable(callable_mp(receiver, &MessageReceiver::requeue_forever));
+
+	ERR_PRINT_OFF;
+	message_queue->flush();
+	ERR_PRINT_ON;
+
+	CHECK(receiver->last_error == ERR_OUT_OF_MEMORY);
+	CHECK(receiver->calls.size() > 1);
+	CHECK(message_queue->get_last_flush_message_count() == receiver->calls.size());
+	CHECK(message_queue->get_queue_depth() == 0);
+
+	// The space is given back once the flush ends.
+	receiver->calls.clear();
+	CHECK(message_queue->push_callable(callable_mp(receiver, &MessageReceiver::requeue), 0) == OK);
+	message_queue->flush();
+	CHECK(receiver->calls.size() == 1);
+
+	memdelete(receiver);
+	memdelete(message_queue);
+}
+
+TEST_CASE("[MessageQueue] Calls from many threads are kept in per-thread order") {
+	MessageQueue *message_queue = memnew(MessageQueue);
+	MessageReceiver *receiver = memnew(MessageReceiver);
+
+	// Several pages worth of messages per thread, while staying under the queue size limit.
+	const int thread_count = 4;
+	const int count = 8000;
+	Thread threads[thread_count];
+	PushUserdata userdata[thread_count];
+	for (int i = 0; i < thread_count; i++) {
+		userdata[i].receiver = receiver;
+		userdata[i].thread = i;
+		userdata[i].count = count;
+		threads[i].start(push_from_thread, &userdata[i]);
+	}
+
+	// Flush while the threads are still pushing.
+	message_queue->flush();
+
+	for (int i = 0; i < thread_count; i++) {
+		threads[i].wait_to_finish();
+	}
+
+	message_queue->flush();
+
+	REQUIRE(receiver->calls.size() == thread_count * count);
+	int next_index[thread_count] = {};
+	bool in_order = true;
+	for (const Vector2i &call : receiver->calls) {
+		in_order = in_order && call.y == next_index[call.x];
+		next_index[call.x]++;
+	}
+	CHECK(in_order);
+	CHECK(message_queue->get_queue_depth() == 0);
+
+	// Buffers of finished threads are released, and new threads can still push.
+	CHECK(message_queue->get_thread_buffer_count() == 0);
+	receiver->calls.clear();
+	threads[0].start(push_from_thread, &userdata[0]);
+	threads[0].wait_to_finish();
+	CHECK(message_queue->get_thread_buffer_count() == 1);
+	message_queue->flush();
+	CHECK(receiver->calls.size() == count);
+	CHECK(message_queue->get_thread_buffer_count() == 0);
+
+	memdelete(receiver);
+	memdelete(message_queue);
+}
+
+} // namespace TestMessageQueue
+
+#endif // TEST_MESSAGE_QUEUE_H
@@ -359,6 +359,152 @@ TEST_CASE("[Object] Signals") {
 	}
 }
 
+class SignalReceiver : public Object {
+public:
+	int calls = 0;
+	int64_t sum = 0;
+
+	Object *emitter = nullptr;
+	SignalReceiver *other = nullptr;
+	bool reemit = false;
+
+	void on_signal(int p_value) {
+		calls++;
+		sum += p_value;
+	}
+
+	void disconnect_other(int p_value) {
+		calls++;
+		emitter->disconnect("my_custom_signal", callable_mp(other, &SignalReceiver::on_signal));
+	}
+
+	void connect_other(int p_value) {
+		calls++;
+		if (!emitter->is_connected("my_custom_signal", callable_mp(other, &SignalReceiver::on_signal))) {
+			emitter->connect("my_custom_signal", callable_mp(other, &SignalReceiver::on_signal));
+		}
+	}
+
+	void free_emitter(int p_value) {
+		calls++;
+		memdelete(emitter);
+		emitter = nullptr;
+	}
+
+	void emit_again(int p_value) {
+		calls++;
+		if (reemit) {
+			reemit = false;
+			emitter->emit_signal("my_custom_signal", p_value + 1);
+		}
+	}
+};
+
+TEST_CASE("[Object] Signal emission to many receivers") {
+	Object object;
+	object.add_user_signal(MethodInfo("my_custom_signal", PropertyInfo(Variant::INT, "value")));
+
+	const int receiver_count = 64;
+	const int emit_count = 1000;
+	SignalReceiver receivers[receiver_count];
+	for (int i = 0; i < receiver_count; i++) {
+		object.connect("my_custom_signal", callable_mp(&receivers[i], &SignalReceiver::on_signal));
+	}
+
+	for (int i = 0; i < emit_count; i++) {
+		CHECK(object.emit_signal("my_custom_signal", i) == OK);
+	}
+
+	bool all_called = true;
+	for (int i = 0; i < receiver_count; i++) {
+		all_called = all_called && receivers[i].calls == emit_count && receivers[i].sum == int64_t(emit_count) * (emit_count - 1) / 2;
+	}
+	CHECK(all_called);
+
+	// One shot connections are called once.
+	SignalReceiver one_shot;
+	object.connect("my_custom_signal", callable_mp(&one_shot, &SignalReceiver::on_signal), Object::CONNECT_ONE_SHOT);
+	object.emit_signal("my_custom_signal", 1);
+	object.emit_signal("my_custom_signal", 1);
+	CHECK(one_shot.calls == 1);
+	CHECK_FALSE(object.is_connected("my_custom_signal", callable_mp(&one_shot, &SignalReceiver::on_signal)));
+}
+
+TEST_CASE("[Object] Connection changes while a signal is emitted") {
+	Object object;
+	object.add_user_signal(MethodInfo("my_custom_signal", PropertyInfo(Variant::INT, "value")));
+
+	SUBCASE("Disconnecting during the emission only affects the next one") {
+		SignalReceiver disconnecter;
+		SignalReceiver target;
+		disconnecter.emitter = &object;
+		disconnecter.other = &target;
+		object.connect("my_custom_signal", callable_mp(&disconnecter, &SignalReceiver::disconnect_other), Object::CONNECT_ONE_SHOT);
+		object.connect("my_custom_signal", callable_mp(&target, &SignalReceiver::on_signal));
+
+		object.emit_signal("my_custom_signal", 1);
+		CHECK(disconnecter.calls == 1);
+		CHECK(target.calls == 1);
+
+		object.emit_signal("my_custom_signal", 1);
+		CHECK(target.calls == 1);
+		List<Object::Connection> connections;
+		object.get_signal_connection_list("my_custom_signal", &connections);
+		CHECK(connections.is_empty());
+	}
+
+	SUBCASE("Connecting during the emission only affects the next one") {
+		SignalReceiver connecter;
+		SignalReceiver target;
+		connecter.emitter = &object;
+		connecter.other = &target;
+		object.connect("my_custom_signal", callable_mp(&connecter, &SignalReceiver::connect_other));
+
+		object.emit_signal("my_custom_signal", 1);
+		CHECK(target.calls == 0);
+		object.emit_signal("my_custom_signal", 1);
+		CHECK(target.calls == 1);
+		CHECK(connecter.calls == 2);
+	}
+
+	SUBCASE("Nested emissions call every receiver") {
+		SignalReceiver reemitter;
+		SignalReceiver target;
+		reemitter.emitter = &object;
+		reemitter.reemit = true;
+		object.connect("my_custom_signal", callable_mp(&reemitter, &SignalReceiver::emit_again));
+		object.connect("my_custom_signal", callable_mp(&target, &SignalReceiver::on_signal));
+
+		object.emit_signal("my_custom_signal", 1);
+		CHECK(reemitter.calls == 2);
+		CHECK(target.calls == 2);
+		CHECK(target.sum == 3);
+	}
+}
+
+TEST_CASE("[Object] Freeing the emitter while a signal is emitted") {
+	Object *object = memnew(Object);
+	object->add_user_signal(MethodInfo("my_custom_signal", PropertyInfo(Variant::INT, "value")));
+
+	SignalReceiver freer;
+	SignalReceiver target;
+	freer.emitter = object;
+	object->connect("my_custom_signal", callable_mp(&freer, &SignalReceiver::free_emitter));
+	object->connect("my_custom_signal", callable_mp(&target, &SignalReceiver::on_signal), Object::CONNECT_ONE_SHOT);
+
+	// Freeing an emitting object prints an error, but the remaining receivers are still called.
+	ERR_PRINT_OFF;
+	object->emit_signal("my_custom_signal", 1);
+	ERR_PRINT_ON;
+
+	CHECK(freer.emitter == nullptr);
+	CHECK(freer.calls == 1);
+	CHECK(target.calls == 1);
+	List<Object::Connection> connections;
+	target.get_signals_connected_to_this(&connections);
+	CHECK(connections.is_empty());
+}
+
 } // namespace TestObject
 
 #endif // TEST_OBJECT_H
@@ -64,6 +64,21 @@ TEST_CASE("[String] Assign from Latin-1 char string (copycon)") {
 	CHECK(u32scmp(t2.get_data(), U"She") == 0);
 }
 
+TEST_CASE("[String] Move") {
+	String s = "Lamb";
+	const char32_t *data = s.ptr();
+
+	String t1(std::move(s));
+	CHECK(t1.ptr() == data);
+	CHECK(s.is_empty());
+
+	String t2 = "Ewe";
+	t2 = std::move(t1);
+	CHECK(t2.ptr() == data);
+	CHECK(t2 == "Lamb");
+	CHECK(t1.is_empty());
+}
+
 TEST_CASE("[String] Assign from wchar_t string (operator=)") {
 	String s = L"Give me";
 	CHECK(u32scmp(s.get_data(), U"Give me") == 0);
@@ -166,6 +181,24 @@ TEST_CASE("[String] UTF8 with CR") {
 	CHECK(no_cr == base.replace("\r", ""));
 }
 
+TEST_CASE("[String] ASCII UTF8") {
+	const String ascii = "res://scenes/level_01.tscn";
+	CharString cs = ascii.utf8();
+	CHECK(cs.length() == ascii.length());
+	CHECK(String::utf8(cs.get_data()) == ascii);
+
+	String partial;
+	Error err = partial.parse_utf8(cs.get_data(), 6);
+	CHECK(err == OK);
+	CHECK(partial == "res://");
+
+	// ASCII prefix followed by multibyte characters.
+	const String mixed = String("res://") + String::chr(0x30C6) + String::chr(0x30B9);
+	cs = mixed.utf8();
+	CHECK(cs.length() == 6 + 3 + 3);
+	CHECK(String::utf8(cs.get_data()) == mixed);
+}
+
 TEST_CASE("[String] Invalid UTF8 (non-standard)") {
 	ERR_PRINT_OFF
 	static const uint8_t u8str[] = { 0x45, 0xE3, 0x81, 0x8A, 0xE3, 0x82, 0x88, 0xE3, 0x81, 0x86, 0xF0, 0x9F, 0x8E, 0xA4, 0xF0, 0x82, 0x82, 0xAC, 0xED, 0xA0, 0x81, 0 };
@@ -320,6 +353,13 @@ TEST_CASE("[String] Case function test") {
 
 	CHECK(a.to_upper() == "MOMONGA");
 	CHECK(a.to_lower() == "momonga");
+
+	// Already converted strings, and non-ASCII characters.
+	CHECK(String("momonga").to_lower() == "momonga");
+	CHECK(String("MOMONGA").to_upper() == "MOMONGA");
+	CHECK(String(U"ÀÉÎ mOmO").to_lower() == U"àéî momo");
+	CHECK(String(U"àéî mOmO").to_upper() == U"ÀÉÎ MOMO");
+	CHECK(String().to_upper().is_empty());
 }
 
 TEST_CASE("[String] Case compare function test") {
@@ -354,6 +394,12 @@ TEST_CASE("[String] Find") {
 	CHECK(s.find("Wo", 9) == 13);
 	CHECK(s.find("Revenge of the Monster Truck") == -1);
 	CHECK(s.rfind("man") == 15);
+
+	CHECK(s.find(String("Woman")) == 7);
+	CHECK(s.find(String("Woman"), 8) == 13);
+	CHECK(s.find(String("Woman"), 14) == -1);
+	CHECK(s.find(String("n")) == 11);
+	CHECK(s.find(String("Woman Woman!")) == -1);
 }
 
 TEST_CASE("[String] Find no case") {
@@ -362,6 +408,9 @@ TEST_CASE("[String] Find no case") {
 	CHECK(s.findn("WHA", 9) == 13);
 	CHECK(s.findn("Revenge of the Monster SawFish") == -1);
 	CHECK(s.rfindn("WHA") == 13);
+	CHECK(s.findn("whale") == 7);
+	CHECK(s.findn("E WH") == 11);
+	CHECK(String(U"Élan ÉLAN").findn(U"élan", 1) == 5);
 }
 
 TEST_CASE("[String] Find MK") {
@@ -0,0 +1,113 @@
+/**************************************************************************/
+/*  test_string_name.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_STRING_NAME_H
+#define TEST_STRING_NAME_H
+
+#include "core/os/thread.h"
+#include "core/string/string_name.h"
+
+#include "tests/test_macros.h"
+
+namespace TestStringName {
+
+TEST_CASE("[StringName] Interning") {
+	StringName a = "test_string_name_interning";
+	StringName b = String("test_string_name_interning");
+	StringName c = StringName::search(U"test_string_name_interning");
+	CHECK(a == b);
+	CHECK(a == c);
+	CHECK(a.data_unique_pointer() == b.data_unique_pointer());
+
+	CHECK(a == "test_string_name_interning");
+	CHECK(a == String("test_string_name_interning"));
+	CHECK(a != "test_string_name_interning_other");
+
+	// Static C strings are compared without building a String.
+	StringName d = StaticCString::create("test_string_name_interning");
+	CHECK(d == a);
+	CHECK(StringName::search("test_string_name_interning") == d);
+}
+
+static const int STRESS_THREAD_COUNT = 8;
+static const int STRESS_NAME_COUNT = 512;
+static const int STRESS_ITERATIONS = 32;
+
+struct StressData {
+	StringName names[STRESS_NAME_COUNT];
+	int transient_mismatches = 0;
+};
+
+static void stress_thread(void *p_userdata) {
+	StressData *data = (StressData *)p_userdata;
+	for (int iteration = 0; iteration < STRESS_ITERATIONS; iteration++) {
+		for (int i = 0; i < STRESS_NAME_COUNT; i++) {
+			String name = "stress_name_" + itos(i);
+			if (i % 2) {
+				data->names[i] = StringName(name);
+			} else {
+				data->names[i] = StringName(name.utf8().get_data());
+			}
+			// Transient names are released right away, exercising removal from the table.
+			StringName transient = name + "_transient";
+			if (transient == data->names[i] || transient != name + "_transient") {
+				data->transient_mismatches++;
+			}
+		}
+	}
+}
+
+TEST_CASE("[StringName] Concurrent creation from several threads") {
+	StressData data[STRESS_THREAD_COUNT];
+	Thread threads[STRESS_THREAD_COUNT];
+
+	for (int i = 0; i < STRESS_THREAD_COUNT; i++) {
+		threads[i].start(stress_thread, &data[i]);
+	}
+	for (int i = 0; i < STRESS_THREAD_COUNT; i++) {
+		threads[i].wait_to_finish();
+	}
+
+	for (int i = 0; i < STRESS_THREAD_COUNT; i++) {
+		CHECK(data[i].transient_mismatches == 0);
+	}
+	for (int i = 0; i < STRESS_NAME_COUNT; i++) {
+		StringName expected = "stress_name_" + itos(i);
+		for (int j = 0; j < STRESS_THREAD_COUNT; j++) {
+			CHECK_MESSAGE(data[j].names[i] == expected, "All threads should get the same interned name.");
+		}
+	}
+
+	CHECK(StringName::search("stress_name_0_transient") == StringName());
+}
+
+} // namespace TestStringName
+
+#endif // TEST_STRING_NAME_H
@@ -235,6 +235,48 @@ TEST_CASE("[LocalVector] Size / Resize / Reserve.") {
 	CHECK(vector.size() == 4);
 	CHECK(vector.get_capacity() >= 4);
 }
+
+TEST_CASE("[LocalVector] Frame allocated") {
+	FrameAllocator::Scope scope;
+
+	FrameLocalVector<int> vector;
+	FrameLocalVector<int> other;
+	for (int i = 0; i < 10000; i++) {
+		vector.push_back(i);
+		if (i % 3 == 0) {
+			// Interleave allocations, so growing can't always happen in place.
+			other.push_back(i);
+		}
+	}
+
+	CHECK(vector.size() == 10000);
+	CHECK(other.size() == 3334);
+
+	bool values_match = true;
+	for (int i = 0; i < 10000; i++) {
+		values_match = values_match && vector[i] == i;
+	}
+	CHECK(values_match);
+	CHECK(other[3333] == 9999);
+}
+
+TEST_CASE("[LocalVector] Frame allocator scope rewinds") {
+	void *outer = FrameAllocator::alloc(16);
+	void *first = nullptr;
+	{
+		FrameAllocator::Scope scope;
+		first = FrameAllocator::alloc(128);
+		FrameAllocator::free(FrameAllocator::alloc(256 * 1024));
+		FrameAllocator::free(first);
+	}
+	{
+		FrameAllocator::Scope scope;
+		void *second = FrameAllocator::alloc(64);
+		CHECK(second == first);
+		FrameAllocator::free(second);
+	}
+	FrameAllocator::free(outer);
+}
 } // namespace TestLocalVector
 
 #endif // TEST_LOCAL_VECTOR_H
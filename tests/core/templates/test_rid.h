@@ -31,7 +31,9 @@
 #ifndef TEST_RID_H
 #define TEST_RID_H
 
+#include "core/os/thread.h"
 #include "core/templates/rid.h"
+#include "core/templates/rid_owner.h"
 
 #include "tests/test_macros.h"
 
@@ -96,6 +98,127 @@ TEST_CASE("[RID] 'get_local_index'") {
 	CHECK(RID::from_uint64(4'294'967'295).get_local_index() == 4'294'967'295);
 	CHECK(RID::from_uint64(4'294'967'297).get_local_index() == 1);
 }
+
+TEST_CASE("[RID_Owner] Make, get and free") {
+	RID_Owner<int> owner;
+
+	RID a = owner.make_rid(1);
+	RID b = owner.make_rid(2);
+
+	CHECK(owner.owns(a));
+	CHECK(owner.get_rid_count() == 2);
+	CHECK(*owner.get_or_null(a) == 1);
+	CHECK(*owner.get_or_null(b) == 2);
+	CHECK(owner.get_or_null(RID()) == nullptr);
+
+	owner.free(a);
+	CHECK_FALSE(owner.owns(a));
+	CHECK(owner.get_or_null(a) == nullptr);
+	CHECK(owner.get_rid_count() == 1);
+
+	// The freed slot is reused, but the old RID stays invalid.
+	RID c = owner.make_rid(3);
+	CHECK(c != a);
+	CHECK(owner.get_or_null(a) == nullptr);
+	CHECK(*owner.get_or_null(c) == 3);
+
+	owner.free(b);
+	owner.free(c);
+}
+
+TEST_CASE("[RID_Owner] Growing over several chunks") {
+	// Small chunks, so the chunk tables have to grow several times.
+	RID_Owner<int> owner(64);
+	Vector<RID> rids;
+	for (int i = 0; i < 1000; i++) {
+		rids.push_back(owner.make_rid(i));
+	}
+
+	bool all_valid = true;
+	for (int i = 0; i < 1000; i++) {
+		const int *value = owner.get_or_null(rids[i]);
+		all_valid = all_valid && value && *value == i;
+	}
+	CHECK(all_valid);
+
+	List<RID> owned;
+	owner.get_owned_list(&owned);
+	CHECK(owned.size() == 1000);
+
+	for (int i = 0; i < 1000; i++) {
+		owner.free(rids[i]);
+	}
+	CHECK(owner.get_rid_count() == 0);
+}
+
+static const int LOOKUP_THREAD_COUNT = 4;
+static const int LOOKUP_RID_COUNT = 256;
+static const int LOOKUP_ITERATIONS = 200;
+static const int GROW_RID_COUNT = 4096;
+
+struct ConcurrentLookupData {
+	RID_Owner<int, true> owner{ 64 };
+	RID rids[LOOKUP_RID_COUNT];
+	RID grown[GROW_RID_COUNT];
+	SafeNumeric<uint32_t> mismatches;
+};
+
+static void concurrent_lookup_thread(void *p_userdata) {
+	ConcurrentLookupData *data = (ConcurrentLookupData *)p_userdata;
+	for (int iteration = 0; iteration < LOOKUP_ITERATIONS; iteration++) {
+		for (int i = 0; i < LOOKUP_RID_COUNT; i++) {
+			const int *value = data->owner.get_or_null(data->rids[i]);
+			if (!value || *value != i || !data->owner.owns(data->rids[i])) {
+				data->mismatches.increment();
+			}
+		}
+	}
+}
+
+static void concurrent_grow_thread(void *p_userdata) {
+	ConcurrentLookupData *data = (ConcurrentLookupData *)p_userdata;
+	for (int i = 0; i < GROW_RID_COUNT; i++) {
+		data->grown[i] = data->owner.make_rid(-i);
+	}
+	for (int i = 0; i < GROW_RID_COUNT; i += 2) {
+		data->owner.free(data->grown[i]);
+	}
+}
+
+TEST_CASE("[RID_Owner] Concurrent lookups while growing") {
+	ConcurrentLookupData data;
+	for (int i = 0; i < LOOKUP_RID_COUNT; i++) {
+		data.rids[i] = data.owner.make_rid(i);
+	}
+
+	Thread grow_thread;
+	Thread lookup_threads[LOOKUP_THREAD_COUNT];
+	grow_thread.start(concurrent_grow_thread, &data);
+	for (int i = 0; i < LOOKUP_THREAD_COUNT; i++) {
+		lookup_threads[i].start(concurrent_lookup_thread, &data);
+	}
+	grow_thread.wait_to_finish();
+	for (int i = 0; i < LOOKUP_THREAD_COUNT; i++) {
+		lookup_threads[i].wait_to_finish();
+	}
+
+	CHECK(data.mismatches.get() == 0);
+	CHECK(data.owner.get_rid_count() == LOOKUP_RID_COUNT + GROW_RID_COUNT / 2);
+
+	bool grown_valid = true;
+	for (int i = 0; i < GROW_RID_COUNT; i++) {
+		const int *value = data.owner.get_or_null(data.grown[i]);
+		grown_valid = grown_valid && (i % 2 == 0 ? value == nullptr : (value && *value == -i));
+	}
+	CHECK(grown_valid);
+
+	for (int i = 0; i < LOOKUP_RID_COUNT; i++) {
+		data.owner.free(data.rids[i]);
+	}
+	for (int i = 1; i < GROW_RID_COUNT; i += 2) {
+		data.owner.free(data.grown[i]);
+	}
+}
 } // namespace TestRID
 
 #endif // TEST_RID_H
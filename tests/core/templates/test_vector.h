@@ -97,6 +97,25 @@ TEST_CASE("[Vector] Insert") {
 	CHECK(vector[4] == 5);
 }
 
+TEST_CASE("[Vector] Insert an element of the same buffer") {
+	CowData<String> data;
+	data.resize(3);
+	data.set(0, "a");
+	data.set(1, "b");
+	data.set(2, "c");
+
+	// The reference points into the buffer that the insertion reallocates and shifts.
+	data.insert(0, data.get(2));
+	data.insert(2, data.get(0));
+
+	CHECK(data.size() == 5);
+	CHECK(data.get(0) == "c");
+	CHECK(data.get(1) == "a");
+	CHECK(data.get(2) == "c");
+	CHECK(data.get(3) == "b");
+	CHECK(data.get(4) == "c");
+}
+
 TEST_CASE("[Vector] Ordered insert") {
 	Vector<int> vector;
 	vector.ordered_insert(2);
@@ -532,6 +551,36 @@ TEST_CASE("[Vector] Operators") {
 	CHECK(vector != vector_other);
 }
 
+TEST_CASE("[Vector] Move") {
+	Vector<int> vector;
+	vector.push_back(1);
+	vector.push_back(2);
+	const int *data = vector.ptr();
+
+	// Moving hands over the buffer, without copying nor referencing it.
+	Vector<int> moved(std::move(vector));
+	CHECK(moved.ptr() == data);
+	CHECK(moved.size() == 2);
+	CHECK(vector.is_empty());
+
+	Vector<int> assigned;
+	assigned.push_back(3);
+	assigned = std::move(moved);
+	CHECK(assigned.ptr() == data);
+	CHECK(assigned[0] == 1);
+	CHECK(assigned[1] == 2);
+	CHECK(moved.is_empty());
+
+	// The moved buffer is exclusively owned, writing to it doesn't copy.
+	assigned.write[0] = 5;
+	CHECK(assigned.ptr() == data);
+
+	// Moved-from vectors are still usable.
+	vector.push_back(4);
+	CHECK(vector.size() == 1);
+	CHECK(vector[0] == 4);
+}
+
 } // namespace TestVector
 
 #endif // TEST_VECTOR_H
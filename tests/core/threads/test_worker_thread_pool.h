@@ -31,6 +31,7 @@
 #ifndef TEST_WORKER_THREAD_POOL_H
 #define TEST_WORKER_THREAD_POOL_H
 
+#include "core/math/random_number_generator.h"
 #include "core/object/worker_thread_pool.h"
 
 #include "tests/test_macros.h"
@@ -153,6 +154,109 @@ TEST_CASE("[WorkerThreadPool] Process 256 elements on native task group low prio
 	CHECK(callable_group_counter.get() == count - 1);
 }
 
+TEST_CASE("[WorkerThreadPool] Parallel for") {
+	const uint32_t count = 100000;
+	LocalVector<uint32_t> values;
+	values.resize(count);
+	WorkerThreadPool::get_singleton()->parallel_for(
+			count, [&](uint32_t p_from, uint32_t p_to) {
+				for (uint32_t i = p_from; i < p_to; i++) {
+					values[i] = i * 2;
+				}
+			},
+			1000);
+
+	bool all_set = true;
+	for (uint32_t i = 0; i < count; i++) {
+		all_set = all_set && values[i] == i * 2;
+	}
+	CHECK(all_set);
+
+	// Nothing to do, the function should not be called.
+	bool called = false;
+	WorkerThreadPool::get_singleton()->parallel_for(0, [&](uint32_t p_from, uint32_t p_to) { called = true; });
+	CHECK_FALSE(called);
+}
+
+TEST_CASE("[WorkerThreadPool] Parallel reduce") {
+	const uint32_t count = 100000;
+	uint64_t sum = WorkerThreadPool::get_singleton()->parallel_reduce(
+			count, uint64_t(0), [](uint32_t p_from, uint32_t p_to) {
+				uint64_t partial = 0;
+				for (uint32_t i = p_from; i < p_to; i++) {
+					partial += i;
+				}
+				return partial;
+			},
+			[](uint64_t p_a, uint64_t p_b) { return p_a + p_b; }, 777);
+	CHECK(sum == uint64_t(count) * (count - 1) / 2);
+
+	// Partial results must be joined in order.
+	String joined = WorkerThreadPool::get_singleton()->parallel_reduce(
+			26, String(), [](uint32_t p_from, uint32_t p_to) {
+				String partial;
+				for (uint32_t i = p_from; i < p_to; i++) {
+					partial += char32_t('a' + i);
+				}
+				return partial;
+			},
+			[](const String &p_a, const String &p_b) { return p_a + p_b; }, 3);
+	CHECK(joined == "abcdefghijklmnopqrstuvwxyz");
+}
+
+TEST_CASE("[WorkerThreadPool] Parallel inclusive scan") {
+	const uint32_t count = 10007;
+	LocalVector<uint64_t> values;
+	values.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		values[i] = i;
+	}
+	WorkerThreadPool::get_singleton()->parallel_inclusive_scan(
+			values.ptr(), count, [](uint64_t p_a, uint64_t p_b) { return p_a + p_b; }, 100);
+
+	bool correct = true;
+	for (uint32_t i = 0; i < count; i++) {
+		correct = correct && values[i] == uint64_t(i) * (i + 1) / 2;
+	}
+	CHECK(correct);
+}
+
+TEST_CASE("[WorkerThreadPool] Parallel sort") {
+	Ref<RandomNumberGenerator> rng;
+	rng.instantiate();
+	rng->set_seed(42);
+
+	// Odd size, so the last run is shorter than the others.
+	const uint32_t count = 100003;
+	LocalVector<int32_t> values;
+	values.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		values[i] = rng->randi_range(-1000, 1000);
+	}
+	WorkerThreadPool::get_singleton()->parallel_sort(values.ptr(), count);
+
+	bool sorted = true;
+	for (uint32_t i = 1; i < count; i++) {
+		sorted = sorted && values[i - 1] <= values[i];
+	}
+	CHECK(sorted);
+
+	PackedFloat32Array packed;
+	packed.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		packed.set(i, rng->randf());
+	}
+	Variant packed_variant = packed;
+	packed_variant.call("sort");
+	packed = packed_variant;
+	sorted = true;
+	for (uint32_t i = 1; i < count; i++) {
+		sorted = sorted && packed[i - 1] <= packed[i];
+	}
+	CHECK(sorted);
+	CHECK(packed.size() == int(count));
+}
+
 } // namespace TestWorkerThreadPool
 
 #endif // TEST_WORKER_THREAD_POOL_H
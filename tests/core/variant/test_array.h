@@ -97,6 +97,38 @@ TEST_CASE("[Array] append_array()") {
 	CHECK(int(arr1[1]) == 2);
 }
 
+TEST_CASE("[Array] Typed set() and append_array()") {
+	Array arr1;
+	arr1.set_typed(Variant::INT, StringName(), Variant());
+	arr1.push_back(1);
+	arr1.set(0, 5);
+	CHECK(int(arr1[0]) == 5);
+
+	ERR_PRINT_OFF;
+	arr1.set(0, "not an int");
+	ERR_PRINT_ON;
+	CHECK(int(arr1[0]) == 5);
+
+	Array arr2;
+	arr2.set_typed(Variant::INT, StringName(), Variant());
+	arr2.push_back(2);
+	arr2.push_back(3);
+	arr1.append_array(arr2);
+	CHECK(arr1.size() == 3);
+	CHECK(int(arr1[2]) == 3);
+	// The source array must not be modified nor shared.
+	arr1.set(1, 10);
+	CHECK(int(arr2[0]) == 2);
+
+	Array arr3;
+	arr3.set_typed(Variant::STRING_NAME, StringName(), Variant());
+	Array arr4 = build_array(String("a"), String("b"));
+	arr3.append_array(arr4);
+	CHECK(arr3.size() == 2);
+	CHECK(arr3[0].get_type() == Variant::STRING_NAME);
+	CHECK(arr4[0].get_type() == Variant::STRING);
+}
+
 TEST_CASE("[Array] resize(), insert(), and erase()") {
 	Array arr;
 	arr.resize(2);
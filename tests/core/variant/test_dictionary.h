@@ -531,6 +531,141 @@ TEST_CASE("[Dictionary] Order and find") {
 	CHECK_EQ(d.find_key("does not exist"), Variant());
 }
 
+TEST_CASE("[Dictionary] Shared key layouts") {
+	Dictionary d1;
+	d1["name"] = "sword";
+	d1["damage"] = 10;
+	d1[StringName("weight")] = 2.5;
+
+	Dictionary d2;
+	d2["name"] = "axe";
+	d2["damage"] = 12;
+	d2["weight"] = 4.0;
+
+	CHECK_EQ(d1.keys(), d2.keys());
+	CHECK_EQ(d1.keys(), build_array("name", "damage", "weight"));
+	CHECK_EQ(d1.values(), build_array("sword", 10, 2.5));
+	CHECK_EQ(d2[StringName("name")], Variant("axe"));
+	CHECK(d1.has(StringName("weight")));
+	CHECK_FALSE(d1.has("missing"));
+	CHECK_EQ(d1.get_key_at_index(1), Variant("damage"));
+	CHECK_EQ(d1.get_value_at_index(2), Variant(2.5));
+	CHECK_NE(d1, d2);
+
+	d2["name"] = "sword";
+	d2["damage"] = 10;
+	d2["weight"] = 2.5;
+	CHECK_EQ(d1, d2);
+	CHECK_EQ(d1.hash(), d2.hash());
+
+	// Same keys in a different order are still equal.
+	Dictionary d3;
+	d3["weight"] = 2.5;
+	d3["damage"] = 10;
+	d3["name"] = "sword";
+	CHECK_EQ(d1, d3);
+
+	Dictionary copy = d1.duplicate();
+	copy["damage"] = 20;
+	CHECK_EQ(int(d1["damage"]), 10);
+	CHECK_EQ(int(copy["damage"]), 20);
+	copy["extra"] = true;
+	CHECK_EQ(copy.size(), 4);
+	CHECK_EQ(d1.size(), 3);
+
+	int count = 0;
+	for (const Variant *key = d1.next(); key; key = d1.next(key)) {
+		CHECK(d1.has(*key));
+		count++;
+	}
+	CHECK_EQ(count, 3);
+}
+
+TEST_CASE("[Dictionary] Switching from shared key layouts to hashed storage") {
+	Dictionary d;
+	for (int i = 0; i < 32; i++) {
+		d["key_" + itos(i)] = i;
+	}
+	CHECK_EQ(d.size(), 32);
+	for (int i = 0; i < 32; i++) {
+		CHECK_EQ(d.get_key_at_index(i), Variant("key_" + itos(i)));
+		CHECK_EQ(int(d["key_" + itos(i)]), i);
+	}
+
+	Dictionary erased = build_dictionary("c", 3, "b", 2, "a", 1);
+	CHECK(erased.erase("b"));
+	CHECK_FALSE(erased.erase("b"));
+	CHECK_EQ(erased.keys(), build_array("a", "c"));
+	erased["b"] = 2;
+	CHECK_EQ(erased.keys(), build_array("a", "c", "b"));
+
+	Dictionary mixed = build_dictionary("b", 2, "a", 1);
+	mixed[3] = "three";
+	CHECK_EQ(mixed.keys(), build_array("a", "b", 3));
+	CHECK_EQ(mixed, build_dictionary(3, "three", "b", 2, "a", 1));
+
+	mixed.clear();
+	CHECK(mixed.is_empty());
+	mixed["a"] = 1;
+	CHECK_EQ(mixed.keys(), build_array("a"));
+}
+
+TEST_CASE("[Dictionary] Erasing keys from a shared key layout") {
+	// Layouts are only shared by keys that were inserted in the same order before.
+	Dictionary first = build_dictionary("c", 3, "b", 2, "a", 1);
+	Dictionary d = build_dictionary("c", 3, "b", 2, "a", 1);
+
+	CHECK(d.erase("b"));
+	CHECK_FALSE(d.erase("b"));
+	CHECK_EQ(d.size(), 2);
+	CHECK_FALSE(d.has("b"));
+	CHECK_EQ(d.keys(), build_array("a", "c"));
+	CHECK_EQ(d.get_key_at_index(1), Variant("c"));
+	CHECK_EQ(d.get_value_at_index(1), Variant(3));
+	CHECK_EQ(d.find_key(2), Variant());
+	CHECK_EQ(d, build_dictionary("c", 3, "a", 1));
+	CHECK_NE(d, first);
+
+	d["b"] = 4;
+	d[5] = "five";
+	CHECK_EQ(d.keys(), build_array("a", "c", "b", 5));
+	CHECK_EQ(int(d["b"]), 4);
+	CHECK_EQ(d.find_key(4), Variant("b"));
+
+	Array keys;
+	for (const Variant *key = d.next(); key; key = d.next(key)) {
+		keys.push_back(*key);
+	}
+	CHECK_EQ(keys, d.keys());
+
+	Dictionary copy = d.duplicate();
+	CHECK_EQ(copy, d);
+	CHECK_EQ(copy.keys(), d.keys());
+}
+
+TEST_CASE("[Dictionary] Values keep their address while keys are added") {
+	// A previous dictionary with the same keys makes the next one use a shared key layout.
+	for (int i = 0; i < 2; i++) {
+		Dictionary d;
+		Variant &first = d["first"];
+		Variant &second = d["second"];
+		for (int j = 0; j < 14; j++) {
+			d["key_" + itos(j)] = j;
+		}
+		// Past the layout's key limit, and with keys that can't be in a layout.
+		for (int j = 14; j < 40; j++) {
+			d["key_" + itos(j)] = j;
+		}
+		d[1] = "one";
+		d.erase("key_3");
+		first = 42;
+		second = 43;
+		CHECK_EQ(int(d["first"]), 42);
+		CHECK_EQ(int(d["second"]), 43);
+		CHECK_EQ(d.size(), 2 + 40 + 1 - 1);
+	}
+}
+
 } // namespace TestDictionary
 
 #endif // TEST_DICTIONARY_H
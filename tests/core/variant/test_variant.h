@@ -1163,6 +1163,57 @@ TEST_CASE("[Variant] Utility functions") {
 	}
 }
 
+TEST_CASE("[Variant] Move") {
+	Array array;
+	array.push_back(1);
+	Variant source = array;
+	const void *data = array.id();
+
+	Variant moved(std::move(source));
+	CHECK(moved.get_type() == Variant::ARRAY);
+	CHECK(Array(moved).id() == data);
+	CHECK(source.get_type() == Variant::NIL);
+
+	Variant assigned = "replaced";
+	assigned = std::move(moved);
+	CHECK(assigned.get_type() == Variant::ARRAY);
+	CHECK(Array(assigned).id() == data);
+	CHECK(moved.get_type() == Variant::NIL);
+}
+
+TEST_CASE("[Variant] Built-in method IDs") {
+	const int dot_id = Variant::get_builtin_method_id(Variant::VECTOR3, "dot");
+	CHECK(dot_id >= 0);
+	CHECK(Variant::get_builtin_method_id(Variant::VECTOR3, "no_such_method") == -1);
+
+	Variant v = Vector3(1, 2, 3);
+	Variant arg = Vector3(4, 5, 6);
+	const Variant *args[1] = { &arg };
+	Variant ret;
+	Callable::CallError ce;
+	v.call_builtin(dot_id, args, 1, ret, ce);
+	CHECK(ce.error == Callable::CallError::CALL_OK);
+	CHECK(double(ret) == doctest::Approx(32.0));
+
+	Variant by_name;
+	v.callp("dot", args, 1, by_name, ce);
+	CHECK(ret == by_name);
+
+	v.call_builtin(-1, args, 1, ret, ce);
+	CHECK(ce.error == Callable::CallError::CALL_ERROR_INVALID_METHOD);
+
+	// Const calls reject methods that modify the base.
+	Variant array = Array();
+	Variant element = 1;
+	const Variant *push_args[1] = { &element };
+	array.call_builtin_const(Variant::get_builtin_method_id(Variant::ARRAY, "push_back"), push_args, 1, ret, ce);
+	CHECK(ce.error == Callable::CallError::CALL_ERROR_METHOD_NOT_CONST);
+	CHECK(Array(array).is_empty());
+	array.call_builtin(Variant::get_builtin_method_id(Variant::ARRAY, "push_back"), push_args, 1, ret, ce);
+	CHECK(ce.error == Callable::CallError::CALL_OK);
+	CHECK(Array(array).size() == 1);
+}
+
 } // namespace TestVariant
 
 #endif // TEST_VARIANT_H
@@ -0,0 +1,159 @@
+/**************************************************************************/
+/*  test_editor_file_system.h                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_EDITOR_FILE_SYSTEM_H
+#define TEST_EDITOR_FILE_SYSTEM_H
+
+#ifdef TOOLS_ENABLED
+
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+#include "editor/editor_file_system.h"
+
+#include "tests/test_macros.h"
+
+namespace TestEditorFileSystem {
+
+class _TestCacheImporter : public ResourceImporter {
+	GDCLASS(_TestCacheImporter, ResourceImporter);
+
+public:
+	virtual String get_importer_name() const override { return "test_cache"; }
+	virtual String get_visible_name() const override { return "Test Cache"; }
+	virtual void get_recognized_extensions(List<String> *p_extensions) const override { p_extensions->push_back("txt"); }
+	virtual String get_save_extension() const override { return "res"; }
+	virtual String get_resource_type() const override { return "Resource"; }
+	virtual void get_import_options(const String &p_path, List<ImportOption> *r_options, int p_preset = 0) const override {
+		r_options->push_back(ImportOption(PropertyInfo(Variant::INT, "quality"), 1));
+	}
+	virtual bool get_option_visibility(const String &p_path, const String &p_option, const HashMap<StringName, Variant> &p_options) const override { return true; }
+	virtual Error import(const String &p_source_file, const String &p_save_path, const HashMap<StringName, Variant> &p_options, List<String> *r_platform_variants, List<String> *r_gen_files = nullptr, Variant *r_metadata = nullptr) override { return OK; }
+};
+
+static void _write_file(const String &p_path, const String &p_text) {
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::WRITE);
+	REQUIRE(f.is_valid());
+	f->store_string(p_text);
+}
+
+TEST_CASE("[EditorFileSystem] Shared import cache") {
+	const String dir = OS::get_singleton()->get_cache_path().path_join("test_import_cache");
+	const String cache_dir = dir.path_join("cache");
+	const String source = dir.path_join("source.txt");
+	Ref<DirAccess> da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	REQUIRE(da->make_dir_recursive(cache_dir) == OK);
+	_write_file(source, "source");
+
+	Ref<_TestCacheImporter> importer;
+	importer.instantiate();
+	List<ResourceImporter::ImportOption> opts;
+	importer->get_import_options(source, &opts);
+	HashMap<StringName, Variant> params;
+	params["quality"] = 1;
+
+	const String key = EditorFileSystem::get_import_cache_key(source, importer, params, opts, Variant());
+
+	SUBCASE("Keys depend on the source contents and import options") {
+		CHECK(key == EditorFileSystem::get_import_cache_key(source, importer, params, opts, Variant()));
+
+		HashMap<StringName, Variant> other_params;
+		other_params["quality"] = 2;
+		CHECK(key != EditorFileSystem::get_import_cache_key(source, importer, other_params, opts, Variant()));
+
+		_write_file(source, "modified");
+		CHECK(key != EditorFileSystem::get_import_cache_key(source, importer, params, opts, Variant()));
+	}
+
+	SUBCASE("Stored imports are copied back on a hit") {
+		const String base_path = dir.path_join("imported");
+		_write_file(base_path + ".res", "imported data");
+		List<String> variants;
+		EditorFileSystem::store_in_import_cache(cache_dir, key, base_path, "res", variants, Dictionary());
+
+		const String other_base_path = dir.path_join("other_checkout");
+		List<String> cached_variants;
+		Variant metadata;
+		CHECK(EditorFileSystem::import_from_cache(cache_dir, key, other_base_path, "res", &cached_variants, &metadata));
+		CHECK(cached_variants.is_empty());
+		CHECK(FileAccess::get_file_as_string(other_base_path + ".res") == "imported data");
+
+		da->remove(base_path + ".res");
+		da->remove(other_base_path + ".res");
+	}
+
+	SUBCASE("Least recently used entries are removed past the size limit") {
+		const String base_path = dir.path_join("imported");
+		_write_file(base_path + ".res", "imported data");
+		List<String> variants;
+		EditorFileSystem::store_in_import_cache(cache_dir, key, base_path, "res", variants, Dictionary());
+		EditorFileSystem::store_in_import_cache(cache_dir, "other_key", base_path, "res", variants, Dictionary());
+
+		// Using the first entry makes the other one the least recently used.
+		const String other_base_path = dir.path_join("other_checkout");
+		List<String> cached_variants;
+		Variant metadata;
+		CHECK(EditorFileSystem::import_from_cache(cache_dir, key, other_base_path, "res", &cached_variants, &metadata));
+
+		uint64_t entry_size = 0;
+		for (const String &E : DirAccess::get_files_at(cache_dir.path_join(key))) {
+			entry_size += FileAccess::open(cache_dir.path_join(key).path_join(E), FileAccess::READ)->get_length();
+		}
+
+		EditorFileSystem::prune_import_cache(cache_dir, entry_size * 2);
+		CHECK(da->dir_exists(cache_dir.path_join(key)));
+		CHECK(da->dir_exists(cache_dir.path_join("other_key")));
+
+		EditorFileSystem::prune_import_cache(cache_dir, entry_size);
+		CHECK(da->dir_exists(cache_dir.path_join(key)));
+		CHECK_FALSE(da->dir_exists(cache_dir.path_join("other_key")));
+
+		da->remove(base_path + ".res");
+		da->remove(other_base_path + ".res");
+	}
+
+	SUBCASE("Nothing is imported on a miss") {
+		const String base_path = dir.path_join("missed");
+		List<String> cached_variants;
+		Variant metadata;
+		CHECK_FALSE(EditorFileSystem::import_from_cache(cache_dir, key, base_path, "res", &cached_variants, &metadata));
+		CHECK_FALSE(FileAccess::exists(base_path + ".res"));
+	}
+
+	// Remove the cache entry and the test files.
+	Ref<DirAccess> cache = DirAccess::open(dir);
+	REQUIRE(cache.is_valid());
+	cache->erase_contents_recursive();
+}
+
+} // namespace TestEditorFileSystem
+
+#endif // TOOLS_ENABLED
+
+#endif // TEST_EDITOR_FILE_SYSTEM_H
@@ -0,0 +1,296 @@
+/**************************************************************************/
+/*  test_packed_scene.h                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_PACKED_SCENE_H
+#define TEST_PACKED_SCENE_H
+
+#include "scene/2d/node_2d.h"
+#include "scene/main/window.h"
+#include "scene/resources/packed_scene.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPackedScene {
+
+static Node *_create_large_scene(int p_branches, int p_leaves) {
+	Node *root = memnew(Node);
+	root->set_name("Root");
+	for (int i = 0; i < p_branches; i++) {
+		Node *branch = memnew(Node);
+		branch->set_name(vformat("Branch%d", i));
+		root->add_child(branch);
+		branch->set_owner(root);
+		for (int j = 0; j < p_leaves; j++) {
+			Node *leaf = memnew(Node);
+			leaf->set_name(vformat("Leaf%d", j));
+			branch->add_child(leaf);
+			leaf->set_owner(root);
+		}
+	}
+	return root;
+}
+
+TEST_CASE("[SceneTree][PackedScene] Incremental instantiation of a large scene") {
+	const int branches = 50;
+	const int leaves = 100;
+
+	Ref<PackedScene> scene;
+	scene.instantiate();
+	Node *original = _create_large_scene(branches, leaves);
+	REQUIRE(scene->pack(original) == OK);
+	memdelete(original);
+
+	SUBCASE("Instantiating with a node limit takes several polls") {
+		Ref<SceneInstantiator> instantiator = scene->instantiate_incremental();
+		REQUIRE(instantiator.is_valid());
+		CHECK(instantiator->get_status() == ERR_BUSY);
+		CHECK(instantiator->get_progress() == 0.0);
+
+		int polls = 0;
+		float last_progress = 0.0;
+		bool progress_increases = true;
+		Error err = ERR_BUSY;
+		while (err == ERR_BUSY) {
+			err = instantiator->poll(0, 100);
+			polls++;
+			if (instantiator->get_progress() < last_progress) {
+				progress_increases = false;
+			}
+			last_progress = instantiator->get_progress();
+		}
+
+		CHECK(err == OK);
+		const int node_count = 1 + branches + branches * leaves;
+		CHECK_MESSAGE(polls == (node_count + 99) / 100, "Each poll should instantiate 100 nodes.");
+		CHECK(progress_increases);
+		CHECK(instantiator->get_progress() == 1.0);
+
+		Node *instance = instantiator->get_instance();
+		REQUIRE(instance != nullptr);
+		CHECK(instance->get_name() == "Root");
+		CHECK(instance->get_child_count() == branches);
+		Node *leaf = instance->get_node_or_null(NodePath(vformat("Branch%d/Leaf%d", branches - 1, leaves - 1)));
+		REQUIRE(leaf != nullptr);
+		CHECK(leaf->get_owner() == instance);
+
+		ERR_PRINT_OFF;
+		CHECK_MESSAGE(instantiator->get_instance() == nullptr, "The instance should only be handed over once.");
+		ERR_PRINT_ON;
+
+		memdelete(instance);
+	}
+
+	SUBCASE("Instantiating without a time budget matches instantiate()") {
+		Ref<SceneInstantiator> instantiator = scene->instantiate_incremental();
+		CHECK(instantiator->poll() == OK);
+		Node *instance = instantiator->get_instance();
+		Node *expected = scene->instantiate();
+		REQUIRE(instance != nullptr);
+		REQUIRE(expected != nullptr);
+
+		CHECK(instance->get_child_count() == expected->get_child_count());
+		for (int i = 0; i < expected->get_child_count(); i++) {
+			CHECK(instance->get_child(i)->get_name() == expected->get_child(i)->get_name());
+			CHECK(instance->get_child(i)->get_child_count() == expected->get_child(i)->get_child_count());
+		}
+
+		memdelete(instance);
+		memdelete(expected);
+	}
+
+	SUBCASE("Freeing an unfinished instantiator frees the nodes built so far") {
+		int object_count = ObjectDB::get_object_count();
+		Ref<SceneInstantiator> instantiator = scene->instantiate_incremental();
+		instantiator->poll(0, 100);
+		REQUIRE(instantiator->get_status() == ERR_BUSY);
+		instantiator.unref();
+		CHECK(ObjectDB::get_object_count() == object_count);
+	}
+}
+
+TEST_CASE("[SceneTree][PackedScene] Instantiating the same scene repeatedly") {
+	Node2D *root = memnew(Node2D);
+	root->set_name("Root");
+	root->set_position(Vector2(4, 2));
+	root->set_meta("tag", "enemy");
+	Node *child = memnew(Node);
+	child->set_name("Child");
+	child->set_process_priority(3);
+	root->add_child(child);
+	child->set_owner(root);
+
+	Ref<PackedScene> scene;
+	scene.instantiate();
+	REQUIRE(scene->pack(root) == OK);
+	memdelete(root);
+
+	for (int i = 0; i < 3; i++) {
+		Node2D *instance = Object::cast_to<Node2D>(scene->instantiate());
+		REQUIRE(instance != nullptr);
+		CHECK(instance->get_position() == Vector2(4, 2));
+		CHECK(instance->get_meta("tag") == Variant("enemy"));
+		Node *instance_child = instance->get_node_or_null(NodePath("Child"));
+		REQUIRE(instance_child != nullptr);
+		CHECK(instance_child->get_process_priority() == 3);
+		memdelete(instance);
+	}
+
+	SUBCASE("Packing a different scene into the same resource") {
+		Node *other = memnew(Node);
+		other->set_name("Other");
+		other->set_process_priority(7);
+		REQUIRE(scene->pack(other) == OK);
+		memdelete(other);
+
+		Node *instance = scene->instantiate();
+		REQUIRE(instance != nullptr);
+		CHECK_MESSAGE(
+				Object::cast_to<Node2D>(instance) == nullptr,
+				"The previous scene's classes should not be used anymore.");
+		CHECK(instance->get_name() == "Other");
+		CHECK(instance->get_process_priority() == 7);
+		memdelete(instance);
+	}
+}
+
+class PoolReleaser : public Object {
+public:
+	Ref<PackedScene> scene;
+	Node *node = nullptr;
+	int released = -1;
+
+	void release() {
+		released = scene->release_to_pool(node);
+	}
+};
+
+TEST_CASE("[SceneTree][PackedScene] Reusing pooled instances") {
+	Node2D *root = memnew(Node2D);
+	root->set_name("Root");
+	root->set_position(Vector2(4, 2));
+	Node *child = memnew(Node);
+	child->set_name("Child");
+	child->set_process_priority(3);
+	root->add_child(child);
+	child->set_owner(root);
+
+	Ref<PackedScene> scene;
+	scene.instantiate();
+	REQUIRE(scene->pack(root) == OK);
+	memdelete(root);
+
+	Node2D *instance = Object::cast_to<Node2D>(scene->instantiate_pooled());
+	REQUIRE(instance != nullptr);
+	CHECK(scene->get_pool_miss_count() == 1);
+	CHECK(scene->get_pool_hit_count() == 0);
+
+	SceneTree::get_singleton()->get_root()->add_child(instance);
+	instance->set_position(Vector2(100, 200));
+	instance->set_rotation(1.0);
+	instance->get_node(NodePath("Child"))->set_process_priority(10);
+
+	CHECK(scene->release_to_pool(instance));
+	CHECK_FALSE(instance->is_inside_tree());
+	CHECK(scene->get_pooled_count() == 1);
+
+	SUBCASE("A released instance is reset and reused") {
+		Node2D *reused = Object::cast_to<Node2D>(scene->instantiate_pooled());
+		CHECK(reused == instance);
+		CHECK(scene->get_pool_hit_count() == 1);
+		CHECK(scene->get_pooled_count() == 0);
+		CHECK(reused->get_position() == Vector2(4, 2));
+		CHECK(reused->get_rotation() == 0.0);
+		CHECK(reused->get_node(NodePath("Child"))->get_process_priority() == 3);
+		memdelete(reused);
+	}
+
+	SUBCASE("Instances whose hierarchy changed are not pooled") {
+		Node *reused = scene->instantiate_pooled();
+		reused->add_child(memnew(Node));
+		CHECK_FALSE(scene->release_to_pool(reused));
+		CHECK(scene->get_pooled_count() == 0);
+	}
+
+	SUBCASE("Instances above the capacity are not pooled") {
+		scene->set_pool_capacity(1);
+		Node *extra = scene->instantiate_pooled();
+		Node *second = scene->instantiate();
+		CHECK(scene->release_to_pool(extra));
+		CHECK_FALSE(scene->release_to_pool(second));
+		CHECK(scene->get_pooled_count() == 1);
+
+		scene->set_pool_capacity(0);
+		CHECK(scene->get_pooled_count() == 0);
+	}
+
+	SUBCASE("Pooled instances freed elsewhere are skipped") {
+		memdelete(instance);
+		Node *fresh = scene->instantiate_pooled();
+		CHECK(scene->get_pool_hit_count() == 0);
+		CHECK(scene->get_pool_miss_count() == 2);
+		CHECK(scene->get_pooled_count() == 0);
+
+		CHECK(scene->release_to_pool(fresh));
+		memdelete(fresh);
+		scene->clear_pool();
+		CHECK(scene->get_pooled_count() == 0);
+	}
+
+	SUBCASE("Instances are not pooled while their parent is busy with its children") {
+		Node *parent = memnew(Node);
+		Node *busy = scene->instantiate();
+		parent->add_child(busy);
+		Node *sibling = memnew(Node);
+		parent->add_child(sibling);
+
+		// The parent is iterating its children when the sibling becomes ready.
+		PoolReleaser releaser;
+		releaser.scene = scene;
+		releaser.node = busy;
+		sibling->connect("ready", callable_mp(&releaser, &PoolReleaser::release));
+		SceneTree::get_singleton()->get_root()->add_child(parent);
+
+		CHECK(releaser.released == 0);
+		CHECK(busy->get_parent() == parent);
+		CHECK(scene->get_pooled_count() == 1);
+		memdelete(parent);
+	}
+
+	SUBCASE("Changing the scene frees the pool") {
+		Node *other = memnew(Node);
+		REQUIRE(scene->pack(other) == OK);
+		memdelete(other);
+		CHECK(scene->get_pooled_count() == 0);
+	}
+}
+
+} // namespace TestPackedScene
+
+#endif // TEST_PACKED_SCENE_H